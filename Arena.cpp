@@ -0,0 +1,70 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <stdlib.h>
+#include <new>
+#include "./Arena.h"
+
+namespace {
+// alignment of every allocation
+const size_t kAlignment = 16;
+}  // namespace
+
+// ____________________________________________________________________________
+Arena::Arena(const size_t blockSize) {
+  // aligned_alloc() takes only multiples of the alignment (and no 0)
+  _blockSize = blockSize > kAlignment
+      ? (blockSize + kAlignment - 1) / kAlignment * kAlignment : kAlignment;
+  _block = 0;
+  _used = 0;
+}
+
+// ____________________________________________________________________________
+Arena::~Arena() {
+  for (unsigned int i = 0; i < _blocks.size(); i++) {
+    free(_blocks[i]);
+  }
+}
+
+// ____________________________________________________________________________
+void* Arena::allocateBytes(size_t size) {
+  size = (size + kAlignment - 1) / kAlignment * kAlignment;
+  // continue with the next block that is large enough
+  while (_block < _blocks.size() && _used + size > _sizes[_block]) {
+    _block++;
+    _used = 0;
+  }
+  if (_block == _blocks.size()) {
+    size_t blockSize = size > _blockSize ? size : _blockSize;
+    char* block = static_cast<char*>(aligned_alloc(kAlignment, blockSize));
+    if (!block) {
+      throw std::bad_alloc();
+    }
+    _blocks.push_back(block);
+    _sizes.push_back(blockSize);
+    _used = 0;
+  }
+  void* memory = _blocks[_block] + _used;
+  _used += size;
+  return memory;
+}
+
+// ____________________________________________________________________________
+Arena::Mark Arena::mark() const {
+  Mark mark;
+  mark.block = _block;
+  mark.used = _used;
+  return mark;
+}
+
+// ____________________________________________________________________________
+void Arena::release(const Mark& mark) {
+  _block = mark.block;
+  _used = mark.used;
+}
+
+// ____________________________________________________________________________
+void Arena::reset() {
+  _block = 0;
+  _used = 0;
+}
@@ -0,0 +1,63 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <gtest/gtest.h>
+#include <stddef.h>
+#include <vector>
+
+// Bump allocator for trivially copyable data of one thread. Memory is
+// taken from large blocks and given back all at once by release() or
+// reset(); the blocks are kept, so an arena that has warmed up does not
+// call malloc any more.
+class Arena {
+ public:
+  // A position in the arena (see mark() / release()).
+  struct Mark {
+    size_t block;
+    size_t used;
+  };
+
+  // Arguments:
+  //   const size_t blockSize - the size of the memory blocks in bytes
+  //     (rounded up to a multiple of the alignment)
+  explicit Arena(const size_t blockSize);
+  FRIEND_TEST(Arena, constructor);
+  // Free all blocks.
+  ~Arena();
+
+  // Returns uninitialized memory for count objects of type T.
+  template <class T>
+  T* allocate(const size_t count) {
+    return static_cast<T*>(allocateBytes(count * sizeof(T)));
+  }
+  FRIEND_TEST(Arena, allocate);
+
+  // Returns the current position.
+  Mark mark() const;
+
+  // Give back everything allocated after the mark.
+  void release(const Mark& mark);
+  FRIEND_TEST(Arena, release);
+
+  // Give back everything.
+  void reset();
+
+  // The amount of blocks taken from the heap so far.
+  size_t blocks() const { return _blocks.size(); }
+
+ private:
+  size_t _blockSize;
+  std::vector<char*> _blocks;
+  std::vector<size_t> _sizes;
+  // the block in use and the amount of bytes used in it
+  size_t _block;
+  size_t _used;
+
+  // Returns size bytes aligned for any type.
+  void* allocateBytes(size_t size);
+};
+
+#endif  // ARENA_H_
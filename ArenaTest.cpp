@@ -0,0 +1,52 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include "./Arena.h"
+
+// _____________________________________________________________________________
+TEST(Arena, constructor) {
+  Arena arena(1024);
+  ASSERT_EQ(1024, arena._blockSize);
+  ASSERT_EQ(0, arena.blocks());
+  // the blocks are whole multiples of the alignment
+  Arena odd(100);
+  ASSERT_EQ(112, odd._blockSize);
+  ASSERT_TRUE(odd.allocate<char>(1) != NULL);
+  Arena empty(0);
+  ASSERT_EQ(16, empty._blockSize);
+  ASSERT_TRUE(empty.allocate<char>(0) != NULL);
+}
+
+// _____________________________________________________________________________
+TEST(Arena, allocate) {
+  Arena arena(1024);
+  int* a = arena.allocate<int>(10);
+  int64_t* b = arena.allocate<int64_t>(3);
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(b) % 16);
+  ASSERT_LE(reinterpret_cast<char*>(a + 10), reinterpret_cast<char*>(b));
+  ASSERT_EQ(1, arena.blocks());
+  // larger than a block
+  char* c = arena.allocate<char>(5000);
+  c[4999] = 1;
+  ASSERT_EQ(2, arena.blocks());
+}
+
+// _____________________________________________________________________________
+TEST(Arena, release) {
+  Arena arena(1024);
+  arena.allocate<char>(100);
+  Arena::Mark mark = arena.mark();
+  char* a = arena.allocate<char>(600);
+  arena.allocate<char>(600);
+  ASSERT_EQ(2, arena.blocks());
+  arena.release(mark);
+  // the same memory is handed out again, no new blocks
+  ASSERT_EQ(a, arena.allocate<char>(600));
+  arena.allocate<char>(600);
+  ASSERT_EQ(2, arena.blocks());
+  arena.reset();
+  arena.allocate<char>(1000);
+  ASSERT_EQ(2, arena.blocks());
+}
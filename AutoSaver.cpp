@@ -0,0 +1,63 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <memory>
+#include <string>
+#include "./AutoSaver.h"
+
+// ____________________________________________________________________________
+AutoSaver::AutoSaver(const std::string& file) : _file(file) {
+  _writing = false;
+  _stop = false;
+  _saved = 0;
+  _thread = std::thread(&AutoSaver::work, this);
+}
+
+// ____________________________________________________________________________
+AutoSaver::~AutoSaver() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _changed.notify_all();
+  _thread.join();
+}
+
+// ____________________________________________________________________________
+void AutoSaver::schedule(std::shared_ptr<const GameSnapshot> snapshot) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending = snapshot;
+  }
+  _changed.notify_all();
+}
+
+// ____________________________________________________________________________
+void AutoSaver::flush() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (_pending || _writing) {
+    _changed.wait(lock);
+  }
+}
+
+// ____________________________________________________________________________
+void AutoSaver::work() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    while (!_pending && !_stop) {
+      _changed.wait(lock);
+    }
+    // the pending snapshot is still written when the saver is stopped
+    if (!_pending) {break; }
+    std::shared_ptr<const GameSnapshot> snapshot = _pending;
+    _pending.reset();
+    _writing = true;
+    lock.unlock();
+    if (SaveGame::save(_file, *snapshot)) {
+      _saved++;
+    }
+    lock.lock();
+    _writing = false;
+    _changed.notify_all();
+  }
+}
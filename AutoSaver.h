@@ -0,0 +1,54 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef AUTOSAVER_H_
+#define AUTOSAVER_H_
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include "./SaveGame.h"
+
+// Writes snapshots of a game to a save file on a background thread, so a
+// slow file system never blocks the game loop. Only the newest snapshot is
+// kept: snapshots scheduled while a write is running replace each other.
+class AutoSaver {
+ public:
+  // Start the writer thread.
+  // Arguments:
+  //   const std::string& file - the save file (see SaveGame::save())
+  explicit AutoSaver(const std::string& file);
+  // Write the pending snapshot and join the writer thread.
+  ~AutoSaver();
+
+  // Hand a snapshot to the writer thread. Never waits for the file system.
+  void schedule(std::shared_ptr<const GameSnapshot> snapshot);
+
+  // Wait until the last scheduled snapshot is written.
+  void flush();
+  FRIEND_TEST(AutoSaver, scheduleAndFlush);
+
+  // Returns: int - the amount of snapshots written so far
+  int saved() const { return _saved; }
+
+ private:
+  std::string _file;
+  std::mutex _mutex;
+  // signals new snapshots and finished writes
+  std::condition_variable _changed;
+  // newest snapshot that is not written yet (NULL if there is none)
+  std::shared_ptr<const GameSnapshot> _pending;
+  bool _writing;
+  bool _stop;
+  std::atomic<int> _saved;
+  std::thread _thread;
+
+  // Write pending snapshots until the saver is stopped.
+  void work();
+};
+
+#endif  // AUTOSAVER_H_
@@ -0,0 +1,144 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <vector>
+#include "./BackgroundSolver.h"
+#include "./ClauseSolver.h"
+
+// ____________________________________________________________________________
+BackgroundSolver::BackgroundSolver(
+    const std::vector< std::vector<int> >& numbers, const int threads)
+  : _solver(numbers), _numbers(numbers) {
+  _clauses = false;
+  _clauseSearch = false;
+  _threads = threads;
+  _progress.position = 0;
+  _progress.verdict = kUnknown;
+  _progress.searching = false;
+  _progress.nodes = 0;
+  _budget = 0;
+  _pending = false;
+  _quit = false;
+  _stop = false;
+  _solver.setStop(&_stop);
+  _thread = std::thread(&BackgroundSolver::work, this);
+}
+
+// ____________________________________________________________________________
+BackgroundSolver::~BackgroundSolver() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _quit = true;
+    _stop = true;
+  }
+  _changed.notify_all();
+  _thread.join();
+}
+
+// ____________________________________________________________________________
+void BackgroundSolver::check(const uint64_t position,
+ const std::vector<Bridge>& bridges, const double budget) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _progress.position = position;
+    _progress.verdict = kUnknown;
+    _progress.searching = true;
+    _progress.nodes = 0;
+    _bridges = bridges;
+    _budget = budget;
+    _pending = true;
+    // the running search is outdated
+    _stop = true;
+  }
+  _changed.notify_all();
+}
+
+// ____________________________________________________________________________
+BackgroundSolver::Progress BackgroundSolver::progress() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  Progress progress = _progress;
+  if (progress.searching && !_pending && !_clauseSearch) {
+    progress.nodes = _solver.nodes();
+  }
+  return progress;
+}
+
+// ____________________________________________________________________________
+bool BackgroundSolver::solution(std::vector<Bridge>* solution) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_solution.empty()) {
+    return false;
+  }
+  *solution = _solution;
+  return true;
+}
+
+// ____________________________________________________________________________
+void BackgroundSolver::wait() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (_progress.searching) {
+    _changed.wait(lock);
+  }
+}
+
+// ____________________________________________________________________________
+void BackgroundSolver::setClauseSolver(const bool clauses) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _clauses = clauses;
+}
+
+// ____________________________________________________________________________
+void BackgroundSolver::work() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    while (!_pending && !_quit) {
+      _changed.wait(lock);
+    }
+    if (_quit) {break; }
+    _pending = false;
+    _stop = false;
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(_budget));
+    bool clauses = _clauses && _bridges.empty();
+    _clauseSearch = clauses;
+    _solver.require(_bridges);
+    _solver.setDeadline(deadline);
+    lock.unlock();
+
+    std::vector<Bridge> solution;
+    bool found;
+    bool stopped;
+    int64_t nodes;
+    if (clauses) {
+      ClauseSolver solver(_numbers);
+      solver.setStop(&_stop);
+      solver.setDeadline(deadline);
+      found = solver.solve(&solution);
+      stopped = solver.stopped();
+      nodes = solver.decisions();
+    } else {
+      found = _solver.solve(_threads, &solution);
+      stopped = _solver.stopped();
+      nodes = _solver.nodes();
+    }
+
+    lock.lock();
+    if (found) {
+      _solution = solution;
+    }
+    // a newer check replaces the result
+    if (!_pending) {
+      if (found) {
+        _progress.verdict = kSolvable;
+      } else if (!stopped) {
+        _progress.verdict = kUnsolvable;
+      }
+      _progress.searching = false;
+      _progress.nodes = nodes;
+      _changed.notify_all();
+    }
+  }
+}
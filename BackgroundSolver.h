@@ -0,0 +1,110 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef BACKGROUNDSOLVER_H_
+#define BACKGROUNDSOLVER_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+#include "./Bridge.h"
+#include "./Solver.h"
+
+// Runs the Solver on a background thread, so the game loop keeps
+// processing input while a large board is searched. Every check asks
+// whether a position (the bridges drawn so far) can still be completed to
+// a solution. A new check cancels the running one; a check that runs out
+// of its time budget ends with the verdict kUnknown. All checks share one
+// Solver, a check of the empty position can run the ClauseSolver instead
+// (see setClauseSolver()).
+class BackgroundSolver {
+ public:
+  enum Verdict {
+    // not decided (yet)
+    kUnknown = 0,
+    // the position can be completed to a solution
+    kSolvable = 1,
+    // there is no solution with these bridges
+    kUnsolvable = 2
+  };
+
+  // State of the latest check.
+  struct Progress {
+    // the position of the check (Zobrist hash of its bridges)
+    uint64_t position;
+    Verdict verdict;
+    // true while the search is running
+    bool searching;
+    // search nodes visited so far (decisions of the ClauseSolver, counted
+    // when its search ends)
+    int64_t nodes;
+  };
+
+  // Start the solver thread.
+  // Arguments:
+  //   const std::vector< std::vector<int> >& numbers - the puzzle (see
+  //     Hashi)
+  //   const int threads - the amount of worker threads of the Solver
+  BackgroundSolver(const std::vector< std::vector<int> >& numbers,
+   const int threads);
+  // Cancel the running check and join the solver thread.
+  ~BackgroundSolver();
+
+  // Check a position in the background. Never waits for the search.
+  // Arguments:
+  //   const uint64_t position - identifies the position in progress()
+  //   const std::vector<Bridge>& bridges - the drawn bridges
+  //   const double budget - give up after this many seconds
+  void check(const uint64_t position, const std::vector<Bridge>& bridges,
+   const double budget);
+  FRIEND_TEST(BackgroundSolver, check);
+
+  // Returns: Progress - the state of the latest check
+  Progress progress();
+
+  // Get the solution found by the last check with the verdict kSolvable.
+  // Every such solution solves the whole puzzle.
+  // Returns:
+  //   bool - false if no solution was found so far
+  bool solution(std::vector<Bridge>* solution);
+
+  // Wait until the latest check is finished.
+  void wait();
+
+  // Let the following checks of the empty position (the solve mode of the
+  // game) search with the ClauseSolver (single threaded) instead of the
+  // Solver.
+  void setClauseSolver(const bool clauses);
+  FRIEND_TEST(BackgroundSolver, setClauseSolver);
+
+ private:
+  Solver _solver;
+  // the puzzle of the ClauseSolver
+  std::vector< std::vector<int> > _numbers;
+  bool _clauses;
+  // the running search is one of the ClauseSolver
+  bool _clauseSearch;
+  int _threads;
+  std::mutex _mutex;
+  // signals new checks and finished searches
+  std::condition_variable _changed;
+  // the latest check and whether the thread has picked it up yet
+  Progress _progress;
+  std::vector<Bridge> _bridges;
+  double _budget;
+  bool _pending;
+  std::vector<Bridge> _solution;
+  bool _quit;
+  // interrupts the running search (see Solver::setStop())
+  std::atomic<bool> _stop;
+  std::thread _thread;
+
+  // Run the checks until the solver is destroyed.
+  void work();
+};
+
+#endif  // BACKGROUNDSOLVER_H_
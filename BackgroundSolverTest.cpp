@@ -0,0 +1,76 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "./BackgroundSolver.h"
+#include "./Generator.h"
+
+// _____________________________________________________________________________
+TEST(BackgroundSolver, check) {
+  std::vector< std::vector<int> > numbers;
+  Generator generator(20, 20, 7);
+  generator.generate(60, &numbers);
+  BackgroundSolver test1(numbers, 1);
+  std::vector<Bridge> solution;
+  ASSERT_FALSE(test1.solution(&solution));
+
+  // the empty board
+  test1.check(0, std::vector<Bridge>(), 60);
+  test1.wait();
+  BackgroundSolver::Progress progress = test1.progress();
+  ASSERT_EQ(0, progress.position);
+  ASSERT_EQ(BackgroundSolver::kSolvable, progress.verdict);
+  ASSERT_FALSE(progress.searching);
+  ASSERT_LT(0, progress.nodes);
+  ASSERT_TRUE(test1.solution(&solution));
+  ASSERT_FALSE(solution.empty());
+
+  // a bridge of the solution with the wrong count
+  Bridge wrong = solution[0];
+  wrong.count = 3 - wrong.count;
+  test1.check(1, {solution[0]}, 60);
+  test1.check(2, {wrong}, 60);
+  test1.wait();
+  progress = test1.progress();
+  ASSERT_EQ(2, progress.position);
+  // a single bridge may still become a double bridge
+  ASSERT_EQ(wrong.count == 1 ? BackgroundSolver::kSolvable
+      : BackgroundSolver::kUnsolvable, progress.verdict);
+  test1.check(3, {solution[0], Bridge(-1, -1, -1, 5, 1)}, 60);
+  test1.wait();
+  ASSERT_EQ(BackgroundSolver::kUnsolvable, test1.progress().verdict);
+
+  // no time for the search
+  test1.check(4, {solution[0]}, 0);
+  test1.wait();
+  ASSERT_EQ(BackgroundSolver::kUnknown, test1.progress().verdict);
+  ASSERT_EQ(4, test1.progress().position);
+}
+
+// _____________________________________________________________________________
+TEST(BackgroundSolver, setClauseSolver) {
+  std::vector< std::vector<int> > numbers;
+  Generator generator(20, 20, 7);
+  generator.generate(60, &numbers);
+  BackgroundSolver test2(numbers, 1);
+  test2.setClauseSolver(true);
+  test2.check(0, std::vector<Bridge>(), 60);
+  test2.wait();
+  ASSERT_EQ(BackgroundSolver::kSolvable, test2.progress().verdict);
+  ASSERT_LT(0, test2.progress().nodes);
+  std::vector<Bridge> solution;
+  ASSERT_TRUE(test2.solution(&solution));
+  ASSERT_TRUE(IsleGraph(numbers).verify(solution));
+
+  // a position is still checked by the Solver
+  test2.check(1, {Bridge(-1, -1, -1, 5, 1)}, 60);
+  test2.wait();
+  ASSERT_EQ(BackgroundSolver::kUnsolvable, test2.progress().verdict);
+
+  BackgroundSolver test3({{1, 0, 2}}, 1);
+  test3.setClauseSolver(true);
+  test3.check(0, std::vector<Bridge>(), 60);
+  test3.wait();
+  ASSERT_EQ(BackgroundSolver::kUnsolvable, test3.progress().verdict);
+}
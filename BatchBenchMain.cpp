@@ -0,0 +1,139 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <vector>
+#include "./BatchCheck.h"
+#include "./FileInterpreter.h"
+#include "./IsleGraph.h"
+#include "./Solver.h"
+
+// a board to check: a puzzle with a solution or a broken one
+struct Board {
+  std::vector< std::vector<int> > numbers;
+  std::vector<Bridge> bridges;
+  IsleGraph graph;
+  bool solved;
+};
+
+// Print the usage and exit.
+void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./BatchBenchMain [--rounds <n>] <puzzlefiles>\n");
+  fprintf(stderr, "Checks the solutions of the puzzles up to %dx%d (and "
+   "copies with a missing\nbridge) one at a time with IsleGraph::verify() "
+   "and in batches of %d with\nthe scalar and the AVX2 kernel of BatchCheck, "
+   "e.g. for instances/*.xy.\n", BatchCheck::kMaxSize, BatchCheck::kMaxSize,
+   BatchCheck::kLanes);
+  exit(1);
+}
+
+// Check all boards in batches.
+// Returns: int - the amount of solved boards
+int checkBatches(BatchCheck* batch, const std::vector<Board>& boards) {
+  int solved = 0;
+  for (unsigned int first = 0; first < boards.size();
+       first += BatchCheck::kLanes) {
+    batch->clear();
+    for (unsigned int i = first; i < boards.size()
+         && batch->add(boards[i].graph, boards[i].bridges) >= 0; i++) {
+    }
+    batch->run();
+    for (int lane = 0; lane < batch->size(); lane++) {
+      solved += batch->solved(lane);
+    }
+  }
+  return solved;
+}
+
+// Compares the throughput of the batch check with single checks.
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"rounds", 1, NULL, 'r'},
+    {NULL, 0, NULL, 0}
+  };
+  int rounds = 200;
+  while (true) {
+    int c = getopt_long(argc, argv, "r:", options, NULL);
+    if (c == -1) {break; }
+    switch (c) {
+      case 'r':
+        rounds = std::max(1, atoi(optarg));
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+  if (optind >= argc) {printUsageAndExit(); }
+
+  std::vector<Board> boards;
+  for (int i = optind; i < argc; i++) {
+    std::vector< std::vector<int> > numbers;
+    if (!FileInterpreter::readPuzzle(argv[i], &numbers) || numbers.empty()
+        || numbers.size() > BatchCheck::kMaxSize
+        || numbers[0].size() > BatchCheck::kMaxSize) {
+      continue;
+    }
+    std::vector<Bridge> solution;
+    Solver solver(numbers);
+    if (!solver.solve(1, &solution)) {continue; }
+    boards.push_back({numbers, solution, IsleGraph(numbers), true});
+    solution.pop_back();
+    boards.push_back({numbers, solution, IsleGraph(numbers), false});
+  }
+  if (boards.empty()) {
+    fprintf(stderr, "No solvable puzzle up to %dx%d\n", BatchCheck::kMaxSize,
+     BatchCheck::kMaxSize);
+    return 1;
+  }
+  int expected = 0;
+  for (unsigned int i = 0; i < boards.size(); i++) {
+    expected += boards[i].solved;
+  }
+
+  // one at a time
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  int solved = 0;
+  for (int round = 0; round < rounds; round++) {
+    for (unsigned int i = 0; i < boards.size(); i++) {
+      solved += boards[i].graph.verify(boards[i].bridges);
+    }
+  }
+  double single = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  bool valid = solved == expected * rounds;
+
+  // batches with both kernels
+  double seconds[2];
+  for (int avx2 = 0; avx2 < 2; avx2++) {
+    BatchCheck batch;
+    batch.setAvx2(avx2);
+    start = std::chrono::steady_clock::now();
+    solved = 0;
+    for (int round = 0; round < rounds; round++) {
+      solved += checkBatches(&batch, boards);
+    }
+    seconds[avx2] = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    valid &= solved == expected * rounds;
+  }
+
+  double checks = static_cast<double>(boards.size()) * rounds;
+  printf("%zu boards (%d solved), %d rounds\n", boards.size(), expected,
+   rounds);
+  printf("  one at a time: %12.0f boards/s\n", checks / single);
+  printf("  batch scalar:  %12.0f boards/s  speedup %5.2f\n",
+   checks / seconds[0], single / seconds[0]);
+  printf("  batch AVX2:    %12.0f boards/s  speedup %5.2f%s\n",
+   checks / seconds[1], single / seconds[1],
+   BatchCheck::hasAvx2() ? "" : "  (not supported, scalar)");
+  if (!valid) {
+    fprintf(stderr, "The checks disagree\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,419 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "./BatchCheck.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BATCHCHECK_AVX2 1
+#endif
+
+namespace {
+// Spread the reached cells of a row along the horizontal bridges. Bit x of
+// joined is set if the cells x and x + 1 are joined by a bridge.
+inline uint16_t fillRow(unsigned int reached, const unsigned int joined) {
+  // to the right: a cell is reached from its left neighbour
+  unsigned int pass = joined << 1;
+  reached |= pass & (reached << 1);
+  pass &= pass << 1;
+  reached |= pass & (reached << 2);
+  pass &= pass << 2;
+  reached |= pass & (reached << 4);
+  pass &= pass << 4;
+  reached |= pass & (reached << 8);
+  // to the left
+  pass = joined;
+  reached |= pass & (reached >> 1);
+  pass &= pass >> 1;
+  reached |= pass & (reached >> 2);
+  pass &= pass >> 2;
+  reached |= pass & (reached >> 4);
+  pass &= pass >> 4;
+  reached |= pass & (reached >> 8);
+  return reached;
+}
+}  // namespace
+
+// ____________________________________________________________________________
+BatchCheck::BatchCheck() {
+  _avx2 = hasAvx2();
+  clear();
+}
+
+// ____________________________________________________________________________
+void BatchCheck::clear() {
+  memset(_planes, 0, sizeof(_planes));
+  memset(_illegal, 0, sizeof(_illegal));
+  memset(_incomplete, 0, sizeof(_incomplete));
+  memset(_disconnected, 0, sizeof(_disconnected));
+  memset(_drawnIllegal, 0, sizeof(_drawnIllegal));
+  _size = 0;
+  _height = 0;
+}
+
+// ____________________________________________________________________________
+bool BatchCheck::hasAvx2() {
+#ifdef BATCHCHECK_AVX2
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+// ____________________________________________________________________________
+int BatchCheck::add(const IsleGraph& graph,
+ const std::vector<Bridge>& bridges) {
+  int width = graph.width();
+  int height = graph.height();
+  if (_size == kLanes || width > kMaxSize || height > kMaxSize) {
+    return -1;
+  }
+  int lane = _size++;
+  _height = std::max(_height, height);
+
+  // build the rows of the board first, then copy them into the lane
+  uint16_t rows[kPlanes][kRows] = {};
+  uint16_t occupied[kRows] = {};
+  const std::vector<Isle>& isles = graph.isles();
+  for (unsigned int i = 0; i < isles.size(); i++) {
+    const Isle& isle = isles[i];
+    uint16_t bit = 1 << isle.x;
+    int row = isle.y + 1;
+    rows[kIsles][row] |= bit;
+    for (int value = isle.value, b = 0; value != 0; value >>= 1, b++) {
+      if (value & 1) {rows[kValue + b][row] |= bit; }
+    }
+  }
+  if (!isles.empty()) {
+    rows[kSeed][isles[0].y + 1] = 1 << isles[0].x;
+  }
+  memcpy(occupied, rows[kIsles], sizeof(occupied));
+
+  // draw the bridge cells between the two ends onto empty cells
+  bool illegal = false;
+  for (unsigned int i = 0; i < bridges.size(); i++) {
+    const Bridge& b = bridges[i];
+    if (b.count <= 0) {continue; }
+    bool inside = b.x1 >= 0 && b.y1 >= 0 && b.x2 >= 0 && b.y2 >= 0
+        && b.x1 < width && b.x2 < width && b.y1 < height && b.y2 < height;
+    bool straight = (b.x1 == b.x2) != (b.y1 == b.y2);
+    if (!inside || !straight || b.count > 2) {
+      illegal = true;
+      continue;
+    }
+    if (b.y1 == b.y2) {
+      int first = std::min(b.x1, b.x2);
+      int last = std::max(b.x1, b.x2);
+      uint16_t cells = ((1 << last) - 1) & ~((2 << first) - 1);
+      int row = b.y1 + 1;
+      illegal |= (occupied[row] & cells) != 0;
+      occupied[row] |= cells;
+      rows[b.count == 1 ? kSingleH : kDoubleH][row] |= cells;
+    } else {
+      uint16_t bit = 1 << b.x1;
+      uint16_t* plane = rows[b.count == 1 ? kSingleV : kDoubleV];
+      int last = std::max(b.y1, b.y2);
+      for (int row = std::min(b.y1, b.y2) + 2; row <= last; row++) {
+        illegal |= (occupied[row] & bit) != 0;
+        occupied[row] |= bit;
+        plane[row] |= bit;
+      }
+    }
+  }
+  _drawnIllegal[lane] = illegal;
+  for (int plane = 0; plane < kPlanes; plane++) {
+    for (int row = 1; row <= height; row++) {
+      _planes[plane][row][lane] = rows[plane][row];
+    }
+  }
+  return lane;
+}
+
+// ____________________________________________________________________________
+int BatchCheck::missing(const int lane, const int x, const int y) const {
+  int row = y + 1;
+  if (!((_planes[kIsles][row][lane] >> x) & 1)) {
+    return 0;
+  }
+  int value = 0;
+  for (int b = 0; b < 4; b++) {
+    value |= ((_planes[kValue + b][row][lane] >> x) & 1) << b;
+  }
+  int left = x > 0 ? x - 1 : kMaxSize;
+  int right = x + 1;
+  int bridges = ((_planes[kSingleH][row][lane] >> left) & 1)
+      + 2 * ((_planes[kDoubleH][row][lane] >> left) & 1)
+      + ((_planes[kSingleH][row][lane] >> right) & 1)
+      + 2 * ((_planes[kDoubleH][row][lane] >> right) & 1)
+      + ((_planes[kSingleV][row - 1][lane] >> x) & 1)
+      + 2 * ((_planes[kDoubleV][row - 1][lane] >> x) & 1)
+      + ((_planes[kSingleV][row + 1][lane] >> x) & 1)
+      + 2 * ((_planes[kDoubleV][row + 1][lane] >> x) & 1);
+  return value - bridges;
+}
+
+// ____________________________________________________________________________
+void BatchCheck::run() {
+  if (_avx2) {
+    runAvx2();
+  } else {
+    runScalar();
+  }
+}
+
+// ____________________________________________________________________________
+void BatchCheck::runScalar() {
+  // bridges join the cells x and x + 1 of a row (horizontal) or the cell x
+  // of a row and the next row (vertical)
+  uint16_t joinedH[kRows];
+  uint16_t joinedV[kRows];
+  uint16_t reached[kRows];
+  for (int lane = 0; lane < _size; lane++) {
+    unsigned int illegal = _drawnIllegal[lane];
+    unsigned int incomplete = 0;
+    joinedV[0] = joinedV[_height + 1] = 0;
+    reached[0] = reached[_height + 1] = 0;
+    for (int row = 1; row <= _height; row++) {
+      unsigned int isles = _planes[kIsles][row][lane];
+      unsigned int singleH = _planes[kSingleH][row][lane];
+      unsigned int doubleH = _planes[kDoubleH][row][lane];
+      unsigned int singleV = _planes[kSingleV][row][lane];
+      unsigned int doubleV = _planes[kDoubleV][row][lane];
+      unsigned int singleUp = _planes[kSingleV][row - 1][lane];
+      unsigned int doubleUp = _planes[kDoubleV][row - 1][lane];
+      unsigned int singleDown = _planes[kSingleV][row + 1][lane];
+      unsigned int doubleDown = _planes[kDoubleV][row + 1][lane];
+      unsigned int islesUp = _planes[kIsles][row - 1][lane];
+      unsigned int islesDown = _planes[kIsles][row + 1][lane];
+
+      // a bridge cell continues with the same bridge or ends at an isle
+      unsigned int ends = singleH | isles;
+      illegal |= singleH & ~((ends << 1) & (ends >> 1));
+      ends = doubleH | isles;
+      illegal |= doubleH & ~((ends << 1) & (ends >> 1));
+      illegal |= singleV & ~((singleUp | islesUp) & (singleDown | islesDown));
+      illegal |= doubleV & ~((doubleUp | islesUp) & (doubleDown | islesDown));
+
+      // count the single (ones) and double (twos) bridges at every cell
+      // with bit-sliced adders, the sum is ones + 2 * twos
+      unsigned int a = singleH << 1, b = singleH >> 1;
+      unsigned int c = singleUp, d = singleDown;
+      unsigned int ab = a ^ b, cd = c ^ d, abCarry = a & b, cdCarry = c & d;
+      unsigned int ones0 = ab ^ cd, carry = ab & cd;
+      unsigned int ones1 = abCarry ^ cdCarry ^ carry;
+      unsigned int ones2 = (abCarry & cdCarry) | (carry & (abCarry ^ cdCarry));
+      a = doubleH << 1, b = doubleH >> 1, c = doubleUp, d = doubleDown;
+      ab = a ^ b, cd = c ^ d, abCarry = a & b, cdCarry = c & d;
+      unsigned int twos0 = ab ^ cd;
+      carry = ab & cd;
+      unsigned int twos1 = abCarry ^ cdCarry ^ carry;
+      unsigned int twos2 = (abCarry & cdCarry) | (carry & (abCarry ^ cdCarry));
+      unsigned int sum0 = ones0;
+      unsigned int sum1 = ones1 ^ twos0;
+      carry = ones1 & twos0;
+      unsigned int sum2 = ones2 ^ twos1 ^ carry;
+      carry = (ones2 & twos1) | (carry & (ones2 ^ twos1));
+      unsigned int sum3 = twos2 ^ carry;
+      incomplete |= isles & ((sum0 ^ _planes[kValue][row][lane])
+          | (sum1 ^ _planes[kValue + 1][row][lane])
+          | (sum2 ^ _planes[kValue + 2][row][lane])
+          | (sum3 ^ _planes[kValue + 3][row][lane]));
+
+      unsigned int horizontal = singleH | doubleH;
+      joinedH[row] = horizontal | (horizontal >> 1);
+      joinedV[row] = singleV | doubleV | singleDown | doubleDown;
+      reached[row] = _planes[kSeed][row][lane];
+    }
+
+    // flood fill down and up until nothing changes
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (int row = 1; row <= _height; row++) {
+        uint16_t next = fillRow(reached[row]
+            | (reached[row - 1] & joinedV[row - 1]), joinedH[row]);
+        changed |= next != reached[row];
+        reached[row] = next;
+      }
+      for (int row = _height; row >= 1; row--) {
+        uint16_t next = fillRow(reached[row]
+            | (reached[row + 1] & joinedV[row]), joinedH[row]);
+        changed |= next != reached[row];
+        reached[row] = next;
+      }
+    }
+    unsigned int disconnected = 0;
+    for (int row = 1; row <= _height; row++) {
+      disconnected |= _planes[kIsles][row][lane] & ~reached[row];
+    }
+    _illegal[lane] = illegal;
+    _incomplete[lane] = incomplete;
+    _disconnected[lane] = disconnected;
+  }
+}
+
+#ifdef BATCHCHECK_AVX2
+namespace {
+// Returns: __m256i - the rows of 16 lanes
+__attribute__((target("avx2"))) inline __m256i load(const uint16_t* row) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row));
+}
+
+// Store the rows of 16 lanes.
+__attribute__((target("avx2"))) inline void store(uint16_t* row,
+ const __m256i v) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(row), v);
+}
+
+// Returns: __m256i - the operations on 16 rows at once
+__attribute__((target("avx2"))) inline __m256i orV(const __m256i a,
+ const __m256i b) {
+  return _mm256_or_si256(a, b);
+}
+__attribute__((target("avx2"))) inline __m256i andV(const __m256i a,
+ const __m256i b) {
+  return _mm256_and_si256(a, b);
+}
+__attribute__((target("avx2"))) inline __m256i xorV(const __m256i a,
+ const __m256i b) {
+  return _mm256_xor_si256(a, b);
+}
+// b without the bits of a
+__attribute__((target("avx2"))) inline __m256i andNotV(const __m256i a,
+ const __m256i b) {
+  return _mm256_andnot_si256(a, b);
+}
+
+// See fillRow().
+__attribute__((target("avx2"))) inline __m256i fillRows(__m256i reached,
+ const __m256i joined) {
+  __m256i pass = _mm256_slli_epi16(joined, 1);
+  reached = orV(reached, andV(pass, _mm256_slli_epi16(reached, 1)));
+  pass = andV(pass, _mm256_slli_epi16(pass, 1));
+  reached = orV(reached, andV(pass, _mm256_slli_epi16(reached, 2)));
+  pass = andV(pass, _mm256_slli_epi16(pass, 2));
+  reached = orV(reached, andV(pass, _mm256_slli_epi16(reached, 4)));
+  pass = andV(pass, _mm256_slli_epi16(pass, 4));
+  reached = orV(reached, andV(pass, _mm256_slli_epi16(reached, 8)));
+  pass = joined;
+  reached = orV(reached, andV(pass, _mm256_srli_epi16(reached, 1)));
+  pass = andV(pass, _mm256_srli_epi16(pass, 1));
+  reached = orV(reached, andV(pass, _mm256_srli_epi16(reached, 2)));
+  pass = andV(pass, _mm256_srli_epi16(pass, 2));
+  reached = orV(reached, andV(pass, _mm256_srli_epi16(reached, 4)));
+  pass = andV(pass, _mm256_srli_epi16(pass, 4));
+  return orV(reached, andV(pass, _mm256_srli_epi16(reached, 8)));
+}
+}  // namespace
+
+// ____________________________________________________________________________
+__attribute__((target("avx2"))) void BatchCheck::runAvx2() {
+  const int kWidth = 16;
+  __m256i joinedH[kRows];
+  __m256i joinedV[kRows];
+  __m256i reached[kRows];
+  for (int lane = 0; lane < _size; lane += kWidth) {
+    __m256i illegal = load(_drawnIllegal + lane);
+    __m256i incomplete = _mm256_setzero_si256();
+    joinedV[0] = joinedV[_height + 1] = _mm256_setzero_si256();
+    reached[0] = reached[_height + 1] = _mm256_setzero_si256();
+    for (int row = 1; row <= _height; row++) {
+      __m256i isles = load(_planes[kIsles][row] + lane);
+      __m256i singleH = load(_planes[kSingleH][row] + lane);
+      __m256i doubleH = load(_planes[kDoubleH][row] + lane);
+      __m256i singleV = load(_planes[kSingleV][row] + lane);
+      __m256i doubleV = load(_planes[kDoubleV][row] + lane);
+      __m256i singleUp = load(_planes[kSingleV][row - 1] + lane);
+      __m256i doubleUp = load(_planes[kDoubleV][row - 1] + lane);
+      __m256i singleDown = load(_planes[kSingleV][row + 1] + lane);
+      __m256i doubleDown = load(_planes[kDoubleV][row + 1] + lane);
+      __m256i islesUp = load(_planes[kIsles][row - 1] + lane);
+      __m256i islesDown = load(_planes[kIsles][row + 1] + lane);
+
+      // a bridge cell continues with the same bridge or ends at an isle
+      __m256i ends = orV(singleH, isles);
+      illegal = orV(illegal, andNotV(andV(_mm256_slli_epi16(ends, 1),
+       _mm256_srli_epi16(ends, 1)), singleH));
+      ends = orV(doubleH, isles);
+      illegal = orV(illegal, andNotV(andV(_mm256_slli_epi16(ends, 1),
+       _mm256_srli_epi16(ends, 1)), doubleH));
+      illegal = orV(illegal, andNotV(andV(orV(singleUp, islesUp),
+       orV(singleDown, islesDown)), singleV));
+      illegal = orV(illegal, andNotV(andV(orV(doubleUp, islesUp),
+       orV(doubleDown, islesDown)), doubleV));
+
+      // count the single (ones) and double (twos) bridges at every cell
+      // with bit-sliced adders, the sum is ones + 2 * twos
+      __m256i a = _mm256_slli_epi16(singleH, 1);
+      __m256i b = _mm256_srli_epi16(singleH, 1);
+      __m256i ab = xorV(a, b), cd = xorV(singleUp, singleDown);
+      __m256i abCarry = andV(a, b), cdCarry = andV(singleUp, singleDown);
+      __m256i ones0 = xorV(ab, cd), carry = andV(ab, cd);
+      __m256i ones1 = xorV(xorV(abCarry, cdCarry), carry);
+      __m256i ones2 = orV(andV(abCarry, cdCarry),
+       andV(carry, xorV(abCarry, cdCarry)));
+      a = _mm256_slli_epi16(doubleH, 1);
+      b = _mm256_srli_epi16(doubleH, 1);
+      ab = xorV(a, b);
+      cd = xorV(doubleUp, doubleDown);
+      abCarry = andV(a, b);
+      cdCarry = andV(doubleUp, doubleDown);
+      __m256i twos0 = xorV(ab, cd);
+      carry = andV(ab, cd);
+      __m256i twos1 = xorV(xorV(abCarry, cdCarry), carry);
+      __m256i twos2 = orV(andV(abCarry, cdCarry),
+       andV(carry, xorV(abCarry, cdCarry)));
+      __m256i sum0 = ones0;
+      __m256i sum1 = xorV(ones1, twos0);
+      carry = andV(ones1, twos0);
+      __m256i sum2 = xorV(xorV(ones2, twos1), carry);
+      carry = orV(andV(ones2, twos1), andV(carry, xorV(ones2, twos1)));
+      __m256i sum3 = xorV(twos2, carry);
+      __m256i wrong = orV(
+       orV(xorV(sum0, load(_planes[kValue][row] + lane)),
+        xorV(sum1, load(_planes[kValue + 1][row] + lane))),
+       orV(xorV(sum2, load(_planes[kValue + 2][row] + lane)),
+        xorV(sum3, load(_planes[kValue + 3][row] + lane))));
+      incomplete = orV(incomplete, andV(isles, wrong));
+
+      __m256i horizontal = orV(singleH, doubleH);
+      joinedH[row] = orV(horizontal, _mm256_srli_epi16(horizontal, 1));
+      joinedV[row] = orV(orV(singleV, doubleV), orV(singleDown, doubleDown));
+      reached[row] = load(_planes[kSeed][row] + lane);
+    }
+
+    // flood fill down and up until nothing changes
+    __m256i changed = _mm256_set1_epi16(-1);
+    while (!_mm256_testz_si256(changed, changed)) {
+      changed = _mm256_setzero_si256();
+      for (int row = 1; row <= _height; row++) {
+        __m256i next = fillRows(orV(reached[row],
+         andV(reached[row - 1], joinedV[row - 1])), joinedH[row]);
+        changed = orV(changed, xorV(next, reached[row]));
+        reached[row] = next;
+      }
+      for (int row = _height; row >= 1; row--) {
+        __m256i next = fillRows(orV(reached[row],
+         andV(reached[row + 1], joinedV[row])), joinedH[row]);
+        changed = orV(changed, xorV(next, reached[row]));
+        reached[row] = next;
+      }
+    }
+    __m256i disconnected = _mm256_setzero_si256();
+    for (int row = 1; row <= _height; row++) {
+      disconnected = orV(disconnected,
+       andNotV(reached[row], load(_planes[kIsles][row] + lane)));
+    }
+    store(_illegal + lane, illegal);
+    store(_incomplete + lane, incomplete);
+    store(_disconnected + lane, disconnected);
+  }
+}
+#else
+// ____________________________________________________________________________
+void BatchCheck::runAvx2() {
+  runScalar();
+}
+#endif
@@ -0,0 +1,114 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef BATCHCHECK_H_
+#define BATCHCHECK_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <vector>
+#include "./Bridge.h"
+#include "./IsleGraph.h"
+
+// Checks the bridges of up to kLanes small boards (at most kMaxSize x
+// kMaxSize cells) at once, e.g. the solutions of a set of small puzzles.
+// The boards are stored as structure of arrays: a row of a board is a
+// 16 bit word of a bit plane (isles, single and double bridge cells of
+// both directions, the value bits of the isles), and the same row of all
+// boards lies side by side. One 256 bit AVX2 register holds a row of 16
+// boards, so every step of the check handles them in lockstep:
+//   - legality: every bridge cell continues straight with the same bridge
+//     until it reaches an isle on both ends
+//   - isle sums: bit-sliced adders count the bridges at every isle
+//   - connectivity: a flood fill from the first isle along the bridges,
+//     a row at a time (a whole row in log2(kMaxSize) shifts)
+// Without AVX2 (or with setAvx2(false)) the same steps run lane by lane.
+class BatchCheck {
+ public:
+  static const int kLanes = 32;
+  static const int kMaxSize = 16;
+
+  // Creates an empty batch.
+  BatchCheck();
+
+  // Add a board to the next free lane.
+  // Arguments:
+  //   const IsleGraph& graph - the isles of the puzzle
+  //   const std::vector<Bridge>& bridges - the bridges to check, e.g. a
+  //     solution (a bridge over an occupied cell, a bridge that isn't
+  //     straight and a count above 2 make the board illegal)
+  // Returns:
+  //   int - the lane of the board or -1 if the batch is full or the board
+  //     is larger than kMaxSize x kMaxSize
+  int add(const IsleGraph& graph, const std::vector<Bridge>& bridges);
+  FRIEND_TEST(BatchCheck, add);
+
+  // Remove all boards.
+  void clear();
+
+  // Returns: int - the amount of boards in the batch
+  int size() const { return _size; }
+
+  // Check all boards of the batch.
+  void run();
+  FRIEND_TEST(BatchCheck, run);
+
+  // Returns: bool - true if the processor supports the AVX2 kernel
+  static bool hasAvx2();
+
+  // Choose the kernel of run(): AVX2 (the default if supported) or the
+  // scalar one.
+  void setAvx2(const bool avx2) { _avx2 = avx2 && hasAvx2(); }
+
+  // Results of the last run() for a lane:
+  // every bridge is straight and ends at isles
+  bool legal(const int lane) const { return _illegal[lane] == 0; }
+  // every isle has as many bridges as its value
+  bool complete(const int lane) const { return _incomplete[lane] == 0; }
+  // the bridges connect all isles
+  bool connected(const int lane) const { return _disconnected[lane] == 0; }
+  bool solved(const int lane) const {
+    return legal(lane) && complete(lane) && connected(lane);
+  }
+
+  // Returns: int - the value of the isle (x, y) minus its bridges (negative
+  // if there are too many), 0 for other cells
+  int missing(const int lane, const int x, const int y) const;
+  FRIEND_TEST(BatchCheck, missing);
+
+ private:
+  // the bit planes, the cell (x, y) of a lane is bit x of
+  // _planes[plane][y + 1][lane] (the rows 0 and kMaxSize + 1 stay empty)
+  enum Plane {
+    kIsles = 0,
+    kSingleH = 1,
+    kDoubleH = 2,
+    kSingleV = 3,
+    kDoubleV = 4,
+    // the first isle of a board, the flood fill starts there
+    kSeed = 5,
+    // bit b of the isle values (4 planes)
+    kValue = 6
+  };
+  static const int kPlanes = kValue + 4;
+  static const int kRows = kMaxSize + 2;
+
+  uint16_t _planes[kPlanes][kRows][kLanes];
+  // results of run() per lane (a set bit: a cell that fails the check)
+  uint16_t _illegal[kLanes];
+  uint16_t _incomplete[kLanes];
+  uint16_t _disconnected[kLanes];
+  // bridges that add() couldn't draw
+  uint16_t _drawnIllegal[kLanes];
+  int _size;
+  // the height of the largest board
+  int _height;
+  bool _avx2;
+
+  // The kernels of run() (both check all lanes).
+  void runScalar();
+  FRIEND_TEST(BatchCheck, kernels);
+  void runAvx2();
+};
+
+#endif  // BATCHCHECK_H_
@@ -0,0 +1,144 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "./BatchCheck.h"
+#include "./Generator.h"
+#include "./IsleGraph.h"
+#include "./Solver.h"
+
+namespace {
+const IsleGraph kPuzzle({{4, 0, 0, 3},
+                         {0, 0, 0, 0},
+                         {2, 0, 0, 1}});
+const std::vector<Bridge> kSolution = {{0, 0, 3, 0, 2}, {0, 0, 0, 2, 2},
+                                       {3, 0, 3, 2, 1}};
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(BatchCheck, add) {
+  BatchCheck batch;
+  ASSERT_EQ(0, batch.add(kPuzzle, kSolution));
+  // row 0 of the board is row 1 of the planes
+  ASSERT_EQ(0x9, batch._planes[BatchCheck::kIsles][1][0]);
+  ASSERT_EQ(0x6, batch._planes[BatchCheck::kDoubleH][1][0]);
+  ASSERT_EQ(0x1, batch._planes[BatchCheck::kDoubleV][2][0]);
+  ASSERT_EQ(0x8, batch._planes[BatchCheck::kSingleV][2][0]);
+  ASSERT_EQ(0x1, batch._planes[BatchCheck::kSeed][1][0]);
+  // the values 4 (0100) and 3 (0011)
+  ASSERT_EQ(0x8, batch._planes[BatchCheck::kValue][1][0]);
+  ASSERT_EQ(0x8, batch._planes[BatchCheck::kValue + 1][1][0]);
+  ASSERT_EQ(0x1, batch._planes[BatchCheck::kValue + 2][1][0]);
+  ASSERT_EQ(3, batch._height);
+  ASSERT_EQ(0, batch._drawnIllegal[0]);
+  // crossing bridges, a bridge that isn't straight and a triple bridge
+  ASSERT_EQ(1, batch.add(IsleGraph({{0, 1, 0},
+                                    {1, 0, 1},
+                                    {0, 1, 0}}),
+                         {{1, 0, 1, 2, 1}, {0, 1, 2, 1, 1}}));
+  ASSERT_NE(0, batch._drawnIllegal[1]);
+  ASSERT_EQ(2, batch.add(kPuzzle, {{0, 0, 3, 2, 1}}));
+  ASSERT_NE(0, batch._drawnIllegal[2]);
+  ASSERT_EQ(3, batch.add(kPuzzle, {{0, 0, 3, 0, 3}}));
+  ASSERT_NE(0, batch._drawnIllegal[3]);
+  std::vector< std::vector<int> > large(17, std::vector<int>(3));
+  large[0][0] = large[16][0] = 1;
+  ASSERT_EQ(-1, batch.add(IsleGraph(large), {}));
+  while (batch.size() < BatchCheck::kLanes) {
+    batch.add(kPuzzle, {});
+  }
+  ASSERT_EQ(-1, batch.add(kPuzzle, {}));
+  batch.clear();
+  ASSERT_EQ(0, batch.size());
+  ASSERT_EQ(0, batch._planes[BatchCheck::kIsles][1][0]);
+}
+
+// _____________________________________________________________________________
+TEST(BatchCheck, run) {
+  for (int avx2 = 0; avx2 < 2; avx2++) {
+    BatchCheck batch;
+    batch.setAvx2(avx2);
+    batch.add(kPuzzle, kSolution);
+    // a bridge is missing
+    batch.add(kPuzzle, {{0, 0, 3, 0, 2}, {0, 0, 0, 2, 2}});
+    // a bridge ends in the water
+    batch.add(IsleGraph({{2, 0, 0, 0}}), {{0, 0, 3, 0, 2}});
+    // two separate pairs of isles
+    IsleGraph pairs({{1, 0, 1},
+                     {0, 0, 0},
+                     {1, 0, 1}});
+    batch.add(pairs, {{0, 0, 2, 0, 1}, {0, 2, 2, 2, 1}});
+    batch.add(pairs, {{0, 0, 2, 0, 1}, {0, 0, 0, 2, 1}});
+    // no bridges at all, a board without isles
+    batch.add(kPuzzle, {});
+    batch.add(IsleGraph(std::vector< std::vector<int> >(1,
+     std::vector<int>(1))), {});
+    batch.run();
+    ASSERT_TRUE(batch.solved(0));
+    ASSERT_TRUE(batch.legal(1));
+    ASSERT_FALSE(batch.complete(1));
+    // the isle (3, 2) is cut off
+    ASSERT_FALSE(batch.connected(1));
+    ASSERT_FALSE(batch.legal(2));
+    ASSERT_TRUE(batch.legal(3));
+    ASSERT_TRUE(batch.complete(3));
+    ASSERT_FALSE(batch.connected(3));
+    ASSERT_FALSE(batch.complete(4));
+    ASSERT_FALSE(batch.connected(4));
+    ASSERT_FALSE(batch.solved(5));
+    ASSERT_FALSE(batch.connected(5));
+    ASSERT_TRUE(batch.solved(6));
+  }
+}
+
+// _____________________________________________________________________________
+TEST(BatchCheck, missing) {
+  BatchCheck batch;
+  batch.add(kPuzzle, {{0, 0, 3, 0, 2}, {0, 0, 0, 2, 2}});
+  batch.add(kPuzzle, {{0, 0, 3, 0, 2}, {0, 0, 0, 2, 2}, {3, 0, 3, 2, 2}});
+  ASSERT_EQ(0, batch.missing(0, 0, 0));
+  ASSERT_EQ(1, batch.missing(0, 3, 0));
+  ASSERT_EQ(0, batch.missing(0, 0, 2));
+  ASSERT_EQ(1, batch.missing(0, 3, 2));
+  ASSERT_EQ(0, batch.missing(0, 1, 0));
+  ASSERT_EQ(-1, batch.missing(1, 3, 0));
+  ASSERT_EQ(-1, batch.missing(1, 3, 2));
+}
+
+// _____________________________________________________________________________
+TEST(BatchCheck, kernels) {
+  // both kernels agree with IsleGraph::verify() on solutions and on
+  // solutions with a changed bridge
+  BatchCheck scalar;
+  BatchCheck vector;
+  std::vector<bool> expected;
+  for (unsigned int seed = 1; scalar.size() < BatchCheck::kLanes; seed++) {
+    std::vector< std::vector<int> > numbers;
+    Generator generator(5 + seed % 12, 16 - seed % 7, seed);
+    generator.generate(4 + seed % 30, &numbers);
+    std::vector<Bridge> solution;
+    Solver solver(numbers);
+    ASSERT_TRUE(solver.solve(1, &solution));
+    if (seed % 2 == 0) {
+      solution[seed % solution.size()].count =
+          3 - solution[seed % solution.size()].count;
+    }
+    if (seed % 5 == 0) {
+      solution.erase(solution.begin());
+    }
+    IsleGraph graph(numbers);
+    expected.push_back(graph.verify(solution));
+    scalar.add(graph, solution);
+    vector.add(graph, solution);
+  }
+  scalar.runScalar();
+  vector.runAvx2();
+  for (int lane = 0; lane < BatchCheck::kLanes; lane++) {
+    ASSERT_EQ(expected[lane], scalar.solved(lane));
+    ASSERT_EQ(expected[lane], vector.solved(lane));
+    ASSERT_EQ(scalar._illegal[lane], vector._illegal[lane]);
+    ASSERT_EQ(scalar._incomplete[lane], vector._incomplete[lane]);
+    ASSERT_EQ(scalar._disconnected[lane], vector._disconnected[lane]);
+  }
+}
@@ -0,0 +1,119 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include "./BitBoard.h"
+#include <vector>
+
+// ____________________________________________________________________________
+BitBoard::BitBoard() {
+  _width = 0;
+  _height = 0;
+  _rowWords = 0;
+  _columnWords = 0;
+}
+
+// ____________________________________________________________________________
+void BitBoard::load(const std::vector< std::vector<int> >& numbers) {
+  _height = numbers.size();
+  _width = _height > 0 ? numbers[0].size() : 0;
+  _rowWords = (_width + 63) / 64;
+  _columnWords = (_height + 63) / 64;
+  for (int plane = 0; plane < kPlanes; plane++) {
+    _rows[plane].assign(_height * _rowWords, 0);
+    _columns[plane].assign(_width * _columnWords, 0);
+  }
+  for (int y = 0; y < _height; y++) {
+    for (int x = 0; x < _width && x < static_cast<int>(numbers[y].size());
+         x++) {
+      if (numbers[y][x] != 0) {
+        set(x, y, numbers[y][x]);
+      }
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void BitBoard::set(const int x, const int y, const int value) {
+  assign(kIsles, x, y, value > 0 && value < 9);
+  assign(kHorizontal, x, y, value == 10 || value == 11);
+  assign(kVertical, x, y, value == 12 || value == 13);
+  assign(kDouble, x, y, value == 11 || value == 13);
+}
+
+// ____________________________________________________________________________
+void BitBoard::assign(const int plane, const int x, const int y,
+ const bool bit) {
+  uint64_t* row = &_rows[plane][y * _rowWords + x / 64];
+  uint64_t* column = &_columns[plane][x * _columnWords + y / 64];
+  if (bit) {
+    *row |= uint64_t(1) << (x % 64);
+    *column |= uint64_t(1) << (y % 64);
+  } else {
+    *row &= ~(uint64_t(1) << (x % 64));
+    *column &= ~(uint64_t(1) << (y % 64));
+  }
+}
+
+// ____________________________________________________________________________
+bool BitBoard::test(const Plane plane, const int x, const int y) const {
+  return (_rows[plane][y * _rowWords + x / 64] >> (x % 64)) & 1;
+}
+
+// ____________________________________________________________________________
+int BitBoard::countRun(const std::vector<uint64_t>& words, const int offset,
+ const int first, const int last) {
+  int firstWord = first / 64;
+  int lastWord = last / 64;
+  // the bits first % 64 ... 63 of the first word and 0 ... last % 64 of
+  // the last word
+  uint64_t head = ~uint64_t(0) << (first % 64);
+  uint64_t tail = ~uint64_t(0) >> (63 - last % 64);
+  if (firstWord == lastWord) {
+    return __builtin_popcountll(words[offset + firstWord] & head & tail);
+  }
+  int count = __builtin_popcountll(words[offset + firstWord] & head);
+  for (int w = firstWord + 1; w < lastWord; w++) {
+    count += __builtin_popcountll(words[offset + w]);
+  }
+  return count + __builtin_popcountll(words[offset + lastWord] & tail);
+}
+
+// ____________________________________________________________________________
+int BitBoard::count(const Plane plane, const int x1, const int y1,
+ const int x2, const int y2) const {
+  if (y1 == y2) {
+    return countRun(_rows[plane], y1 * _rowWords, x1, x2);
+  }
+  return countRun(_columns[plane], x1 * _columnWords, y1, y2);
+}
+
+// ____________________________________________________________________________
+int BitBoard::segment(const int x1, const int y1, const int x2,
+ const int y2) const {
+  bool vertical = x1 == x2;
+  // the inner cells of the bridge, adjacent isles can't be connected
+  int ix1 = vertical ? x1 : x1 + 1;
+  int iy1 = vertical ? y1 + 1 : y1;
+  int ix2 = vertical ? x2 : x2 - 1;
+  int iy2 = vertical ? y2 - 1 : y2;
+  int cells = vertical ? iy2 - iy1 + 1 : ix2 - ix1 + 1;
+  if (cells <= 0) {
+    return 1;
+  }
+  // no isle and no crossing bridge may block the way
+  Plane crossing = vertical ? kHorizontal : kVertical;
+  if (count(kIsles, ix1, iy1, ix2, iy2) > 0
+      || count(crossing, ix1, iy1, ix2, iy2) > 0) {
+    return 1;
+  }
+  // the inner cells are either all empty or all part of the same bridge
+  int bridges = count(vertical ? kVertical : kHorizontal, ix1, iy1, ix2, iy2);
+  if (bridges == 0) {
+    return 0;
+  }
+  int doubles = count(kDouble, ix1, iy1, ix2, iy2);
+  if (bridges != cells || (doubles != 0 && doubles != cells)) {
+    return 1;
+  }
+  return (vertical ? 12 : 10) + (doubles > 0 ? 1 : 0);
+}
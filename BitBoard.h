@@ -0,0 +1,88 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef BITBOARD_H_
+#define BITBOARD_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <vector>
+
+// Bit-plane view of a _numbers matrix (see Hashi). Every plane stores one
+// bit per cell, 64 cells per word, once row by row and once transposed
+// (column by column). A horizontal segment is a run of bits in a row, a
+// vertical segment a run of bits in a column, so both are checked with a
+// few masked word operations instead of a walk over the cells.
+class BitBoard {
+ public:
+  enum Plane {
+    // isle cells (1 - 8)
+    kIsles = 0,
+    // horizontal bridge cells (10, 11)
+    kHorizontal = 1,
+    // vertical bridge cells (12, 13)
+    kVertical = 2,
+    // double bridge cells (11, 13)
+    kDouble = 3
+  };
+  static const int kPlanes = 4;
+
+  // Creates an empty 0 x 0 board.
+  BitBoard();
+
+  // Build all planes from a _numbers matrix (see Hashi).
+  void load(const std::vector< std::vector<int> >& numbers);
+
+  // Update the planes of one cell.
+  // Arguments:
+  //   const int x, const int y - the cell
+  //   const int value - the new value of the cell (_numbers encoding)
+  void set(const int x, const int y, const int value);
+
+  // Returns: bool - true if the cell (x, y) is set in the plane
+  bool test(const Plane plane, const int x, const int y) const;
+
+  // Count the cells of a plane in a horizontal or vertical segment.
+  // Arguments:
+  //   const Plane plane - the plane
+  //   the first and the last cell of the segment (both included, x1 <= x2
+  //   and y1 <= y2, either x1 == x2 or y1 == y2)
+  // Returns:
+  //   int - the amount of set cells in the segment
+  int count(const Plane plane, const int x1, const int y1, const int x2,
+   const int y2) const;
+  FRIEND_TEST(BitBoard, count);
+
+  // The bridge type between two isles, same as Hashi::isBridgeValid() for
+  // ordered coordinates (x1 <= x2, y1 <= y2) of two isles.
+  // Returns: int - 0 (free), 1 (blocked), 10 - 13 (the bridge between them)
+  int segment(const int x1, const int y1, const int x2, const int y2) const;
+  FRIEND_TEST(BitBoard, segment);
+
+  // proportions of the board
+  int width() const { return _width; }
+  int height() const { return _height; }
+
+ private:
+  int _width;
+  int _height;
+  // words per row / per column
+  int _rowWords;
+  int _columnWords;
+  // the planes row by row: the cell (x, y) is bit x % 64 of the word
+  // _rows[plane][y * _rowWords + x / 64]
+  std::vector<uint64_t> _rows[kPlanes];
+  // the transposed planes: the cell (x, y) is bit y % 64 of the word
+  // _columns[plane][x * _columnWords + y / 64]
+  std::vector<uint64_t> _columns[kPlanes];
+
+  // Set or clear the bit of a cell in both views of a plane.
+  void assign(const int plane, const int x, const int y, const bool bit);
+
+  // Count the set bits first ... last (both included) of a bit line that
+  // starts at words[offset].
+  static int countRun(const std::vector<uint64_t>& words, const int offset,
+   const int first, const int last);
+};
+
+#endif  // BITBOARD_H_
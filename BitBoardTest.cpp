@@ -0,0 +1,63 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "./BitBoard.h"
+
+// _____________________________________________________________________________
+TEST(BitBoard, count) {
+  // wide enough for runs across word boundaries in both views
+  std::vector< std::vector<int> > numbers(70, std::vector<int>(130, 0));
+  numbers[1][0] = 2;
+  numbers[1][129] = 2;
+  for (int x = 1; x < 129; x++) {
+    numbers[1][x] = 11;
+  }
+  numbers[0][64] = 1;
+  numbers[69][64] = 1;
+  BitBoard test1;
+  test1.load(numbers);
+  ASSERT_EQ(130, test1.width());
+  ASSERT_EQ(70, test1.height());
+  ASSERT_EQ(128, test1.count(BitBoard::kHorizontal, 0, 1, 129, 1));
+  ASSERT_EQ(128, test1.count(BitBoard::kDouble, 0, 1, 129, 1));
+  ASSERT_EQ(3, test1.count(BitBoard::kHorizontal, 62, 1, 64, 1));
+  ASSERT_EQ(2, test1.count(BitBoard::kIsles, 0, 1, 129, 1));
+  ASSERT_EQ(0, test1.count(BitBoard::kHorizontal, 0, 0, 129, 0));
+  // the transposed view
+  ASSERT_EQ(2, test1.count(BitBoard::kIsles, 64, 0, 64, 69));
+  ASSERT_EQ(1, test1.count(BitBoard::kHorizontal, 64, 0, 64, 69));
+  ASSERT_EQ(0, test1.count(BitBoard::kIsles, 64, 1, 64, 68));
+
+  test1.set(64, 1, 0);
+  ASSERT_FALSE(test1.test(BitBoard::kHorizontal, 64, 1));
+  ASSERT_EQ(127, test1.count(BitBoard::kDouble, 0, 1, 129, 1));
+  ASSERT_EQ(0, test1.count(BitBoard::kHorizontal, 64, 0, 64, 69));
+}
+
+// _____________________________________________________________________________
+TEST(BitBoard, segment) {
+  BitBoard test2;
+  test2.load({{2, 0, 0, 3, 0, 0, 0},
+              {0, 0, 0, 0, 0, 0, 0},
+              {3, 10, 10, 5, 0, 0, 4},
+              {0, 0, 1, 12, 1, 0, 0},
+              {0, 0, 0, 2, 0, 0, 0}});
+  ASSERT_EQ(0, test2.segment(0, 0, 3, 0));
+  ASSERT_EQ(0, test2.segment(3, 0, 3, 2));
+  ASSERT_EQ(10, test2.segment(0, 2, 3, 2));
+  ASSERT_EQ(12, test2.segment(3, 2, 3, 4));
+  // an isle in the way
+  ASSERT_EQ(1, test2.segment(0, 0, 6, 0));
+  // a crossing bridge
+  ASSERT_EQ(1, test2.segment(2, 3, 4, 3));
+  // adjacent isles
+  ASSERT_EQ(1, test2.segment(2, 3, 3, 3));
+  test2.set(1, 2, 11);
+  test2.set(2, 2, 11);
+  ASSERT_EQ(11, test2.segment(0, 2, 3, 2));
+  // a half drawn bridge is no valid state
+  test2.set(1, 2, 10);
+  ASSERT_EQ(1, test2.segment(0, 2, 3, 2));
+}
@@ -0,0 +1,152 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef BOUNDEDQUEUE_H_
+#define BOUNDEDQUEUE_H_
+
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+
+// Bounded lock-free queue for any amount of producers and consumers
+// (D. Vyukov's array queue). Every cell carries a sequence number that
+// tells producers and consumers whose turn it is, so push and pop need a
+// single compare-and-swap on the success path. The waiting push() and
+// pop() spin kSpins times and then sleep on a condition variable until
+// the other side makes room or brings an item, so a waiting stage does
+// not take a core from the others.
+template <class T>
+class BoundedQueue {
+ public:
+  // Arguments:
+  //   const size_t capacity - the amount of cells (rounded up to a power
+  //                           of two)
+  explicit BoundedQueue(const size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {size *= 2; }
+    _mask = size - 1;
+    _cells.reset(new Cell[size]);
+    for (size_t i = 0; i < size; i++) {
+      _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    _enqueue.store(0, std::memory_order_relaxed);
+    _dequeue.store(0, std::memory_order_relaxed);
+    _waitingPush = 0;
+    _waitingPop = 0;
+  }
+
+  // Returns: bool - false if the queue is full (the item is not moved)
+  bool tryPush(T* item) {
+    size_t position = _enqueue.load(std::memory_order_relaxed);
+    while (true) {
+      Cell* cell = &_cells[position & _mask];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      if (sequence == position) {
+        if (_enqueue.compare_exchange_weak(position, position + 1,
+         std::memory_order_relaxed)) {
+          cell->data = std::move(*item);
+          cell->sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (sequence < position) {
+        return false;
+      } else {
+        position = _enqueue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Returns: bool - false if the queue is empty
+  bool tryPop(T* item) {
+    size_t position = _dequeue.load(std::memory_order_relaxed);
+    while (true) {
+      Cell* cell = &_cells[position & _mask];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      if (sequence == position + 1) {
+        if (_dequeue.compare_exchange_weak(position, position + 1,
+         std::memory_order_relaxed)) {
+          *item = std::move(cell->data);
+          cell->sequence.store(position + _mask + 1,
+           std::memory_order_release);
+          return true;
+        }
+      } else if (sequence < position + 1) {
+        return false;
+      } else {
+        position = _dequeue.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Wait until there is room for the item.
+  void push(T* item) {
+    for (int i = 0; !tryPush(item); i++) {
+      if (i < kSpins) {
+        std::this_thread::yield();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(_mutex);
+      _waitingPush++;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (!tryPush(item)) {_notFull.wait(lock); }
+      _waitingPush--;
+      break;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waitingPop > 0) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _notEmpty.notify_one();
+    }
+  }
+
+  // Wait for the next item.
+  void pop(T* item) {
+    for (int i = 0; !tryPop(item); i++) {
+      if (i < kSpins) {
+        std::this_thread::yield();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(_mutex);
+      _waitingPop++;
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (!tryPop(item)) {_notEmpty.wait(lock); }
+      _waitingPop--;
+      break;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waitingPush > 0) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _notFull.notify_one();
+    }
+  }
+
+ private:
+  // attempts of push() and pop() before they sleep
+  static const int kSpins = 64;
+
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+  std::unique_ptr<Cell[]> _cells;
+  size_t _mask;
+  // producers and consumers work on different cache lines
+  alignas(64) std::atomic<size_t> _enqueue;
+  alignas(64) std::atomic<size_t> _dequeue;
+
+  // the sleeping push() and pop() calls: a successful push() or pop()
+  // takes the mutex to wake one of the other side, which holds the mutex
+  // from its last attempt until it waits
+  std::mutex _mutex;
+  std::condition_variable _notFull;
+  std::condition_variable _notEmpty;
+  std::atomic<int> _waitingPush;
+  std::atomic<int> _waitingPop;
+};
+
+#endif  // BOUNDEDQUEUE_H_
@@ -0,0 +1,38 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef BRIDGE_H_
+#define BRIDGE_H_
+
+#include <stdint.h>
+
+// A bridge between two isles, also used for moves (e.g. the undo list).
+// Solutions and move lists are stored as contiguous std::vector<Bridge>
+// without an allocation per row. The count says how often the bridge is
+// drawn: a double bridge has the count 2 and equals two rows
+// "x1,y1,x2,y2" of a .xy.solution file. Count 0 marks an empty entry.
+struct Bridge {
+  int16_t x1;
+  int16_t y1;
+  int16_t x2;
+  int16_t y2;
+  int16_t count;
+
+  Bridge() = default;
+  Bridge(const int x1, const int y1, const int x2, const int y2,
+   const int count)
+    : x1(x1), y1(y1), x2(x2), y2(y2), count(count) {}
+
+  // Returns: bool - true if both records connect the same coordinates
+  bool sameIsles(const Bridge& other) const {
+    return x1 == other.x1 && y1 == other.y1 && x2 == other.x2
+        && y2 == other.y2;
+  }
+
+  bool operator==(const Bridge& other) const {
+    return sameIsles(other) && count == other.count;
+  }
+  bool operator!=(const Bridge& other) const { return !(*this == other); }
+};
+
+#endif  // BRIDGE_H_
@@ -0,0 +1,47 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <vector>
+#include "./BuiltinPuzzles.h"
+
+namespace {
+#ifdef BUILTINPUZZLES_EMPTY
+// EmbedMain, which makes the table, is linked without it
+const BuiltinPuzzle* const kPuzzles = NULL;
+const int kSize = 0;
+#else
+// the generated arrays kGrids, kIsles, kBridges and kPuzzles
+#include "./BuiltinTable.inc"
+const int kSize = sizeof(kPuzzles) / sizeof(kPuzzles[0]);
+#endif
+}  // namespace
+
+// ____________________________________________________________________________
+int BuiltinPuzzles::size() {
+  return kSize;
+}
+
+// ____________________________________________________________________________
+const BuiltinPuzzle* BuiltinPuzzles::get(const int n) {
+  if (n < 1 || n > size()) {
+    return NULL;
+  }
+  return &kPuzzles[n - 1];
+}
+
+// ____________________________________________________________________________
+void BuiltinPuzzles::unpack(const BuiltinPuzzle& puzzle,
+ std::vector< std::vector<int> >* numbers, std::vector<Bridge>* solution) {
+  numbers->resize(puzzle.height);
+  for (int y = 0; y < puzzle.height; y++) {
+    const uint8_t* row = puzzle.grid + y * puzzle.width;
+    (*numbers)[y].assign(row, row + puzzle.width);
+  }
+  solution->clear();
+  solution->reserve(puzzle.bridgeCount);
+  for (int i = 0; i < puzzle.bridgeCount; i++) {
+    const uint8_t* bridge = puzzle.bridges + 5 * i;
+    solution->push_back(Bridge(bridge[0], bridge[1], bridge[2], bridge[3],
+     bridge[4]));
+  }
+}
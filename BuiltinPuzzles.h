@@ -0,0 +1,51 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef BUILTINPUZZLES_H_
+#define BUILTINPUZZLES_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <vector>
+#include "./Bridge.h"
+
+// A puzzle of the instances directory that is compiled into the binaries.
+// The Makefile converts the directory into the table BuiltinTable.inc with
+// EmbedMain, which also searches the solutions.
+struct BuiltinPuzzle {
+  // the file name without directory and extension
+  const char* name;
+  int width;
+  int height;
+  // the cells row by row: the values of the isles, 0 for empty cells
+  const uint8_t* grid;
+  // the isles as cell indexes (y * width + x), row by row like the isles of
+  // an IsleGraph
+  const uint16_t* isles;
+  int isleCount;
+  // the bridges of the solution: x1, y1, x2, y2 and count of each bridge
+  // (none if the solution is unknown)
+  const uint8_t* bridges;
+  int bridgeCount;
+};
+
+// The read-only table of the built-in puzzles, a puzzle is started without
+// opening or parsing a file.
+class BuiltinPuzzles {
+ public:
+  // Returns: int - the amount of built-in puzzles
+  static int size();
+
+  // Returns: const BuiltinPuzzle* - the puzzle n (counted from 1) or NULL
+  // if there is none
+  static const BuiltinPuzzle* get(const int n);
+  FRIEND_TEST(BuiltinPuzzles, get);
+
+  // Copy a puzzle into the format of the Hashi _numbers matrix and its
+  // solution into the format of the Hashi _sol.
+  static void unpack(const BuiltinPuzzle& puzzle,
+   std::vector< std::vector<int> >* numbers, std::vector<Bridge>* solution);
+  FRIEND_TEST(BuiltinPuzzles, unpack);
+};
+
+#endif  // BUILTINPUZZLES_H_
@@ -0,0 +1,57 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "./BuiltinPuzzles.h"
+#include "./FileInterpreter.h"
+#include "./IsleGraph.h"
+
+// _____________________________________________________________________________
+TEST(BuiltinPuzzles, get) {
+  ASSERT_LT(0, BuiltinPuzzles::size());
+  ASSERT_TRUE(BuiltinPuzzles::get(0) == NULL);
+  ASSERT_TRUE(BuiltinPuzzles::get(BuiltinPuzzles::size() + 1) == NULL);
+  // the puzzles in the order of their file names
+  const BuiltinPuzzle* first = BuiltinPuzzles::get(1);
+  ASSERT_STREQ("i001-n002-s03x01", first->name);
+  ASSERT_EQ(3, first->width);
+  ASSERT_EQ(1, first->height);
+  ASSERT_EQ(1, first->grid[0]);
+  ASSERT_EQ(0, first->grid[1]);
+  ASSERT_EQ(1, first->grid[2]);
+  ASSERT_EQ(2, first->isleCount);
+  ASSERT_EQ(0, first->isles[0]);
+  ASSERT_EQ(2, first->isles[1]);
+  ASSERT_EQ(1, first->bridgeCount);
+}
+
+// _____________________________________________________________________________
+TEST(BuiltinPuzzles, unpack) {
+  // every puzzle equals its file and the known solutions solve it
+  int solved = 0;
+  for (int n = 1; n <= BuiltinPuzzles::size(); n++) {
+    const BuiltinPuzzle* puzzle = BuiltinPuzzles::get(n);
+    std::vector< std::vector<int> > numbers;
+    std::vector<Bridge> solution;
+    BuiltinPuzzles::unpack(*puzzle, &numbers, &solution);
+    std::vector< std::vector<int> > file;
+    ASSERT_TRUE(FileInterpreter::readPuzzle(
+        std::string("instances/") + puzzle->name + ".xy", &file));
+    ASSERT_EQ(file, numbers) << puzzle->name;
+
+    IsleGraph graph(numbers);
+    ASSERT_EQ(graph.isles().size(), puzzle->isleCount) << puzzle->name;
+    for (int i = 0; i < puzzle->isleCount; i++) {
+      ASSERT_EQ(graph.isles()[i].y * puzzle->width + graph.isles()[i].x,
+       puzzle->isles[i]) << puzzle->name;
+    }
+    ASSERT_EQ(puzzle->bridgeCount, solution.size());
+    if (!solution.empty()) {
+      ASSERT_TRUE(graph.verify(solution)) << puzzle->name;
+      solved++;
+    }
+  }
+  ASSERT_LT(0, solved);
+}
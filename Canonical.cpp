@@ -0,0 +1,194 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "./Canonical.h"
+
+namespace {
+
+// ____________________________________________________________________________
+uint64_t rotl(const uint64_t x, const int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+// ____________________________________________________________________________
+uint64_t fmix(uint64_t k) {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+std::string PuzzleHash::hex() const {
+  char buffer[33];
+  snprintf(buffer, sizeof(buffer), "%016llx%016llx",
+   static_cast<unsigned long long>(hi),  // NOLINT
+   static_cast<unsigned long long>(lo));  // NOLINT
+  return buffer;
+}
+
+// ____________________________________________________________________________
+const char* Canonical::symmetryName(const int symmetry) {
+  switch (symmetry) {
+    case 0: return "identity";
+    case 1: return "mirror-x";
+    case 2: return "mirror-y";
+    case 3: return "rotate-180";
+    case 4: return "transpose";
+    case 5: return "rotate-90";
+    case 6: return "rotate-270";
+    case 7: return "anti-transpose";
+  }
+  return "unknown";
+}
+
+// ____________________________________________________________________________
+Isle Canonical::mapIsle(const Isle& isle, const int width, const int height,
+ const int symmetry) {
+  int x = isle.x;
+  int y = isle.y;
+  Isle result = isle;
+  switch (symmetry) {
+    case 1: result.x = width - 1 - x; break;
+    case 2: result.y = height - 1 - y; break;
+    case 3: result.x = width - 1 - x; result.y = height - 1 - y; break;
+    case 4: result.x = y; result.y = x; break;
+    case 5: result.x = height - 1 - y; result.y = x; break;
+    case 6: result.x = y; result.y = width - 1 - x; break;
+    case 7: result.x = height - 1 - y; result.y = width - 1 - x; break;
+  }
+  return result;
+}
+
+// ____________________________________________________________________________
+CanonicalForm Canonical::form(const std::vector<Isle>& isles,
+ const int width, const int height) {
+  // Every image has to be sorted row by row. The isles are sorted once row
+  // by row and once column by column: walking these lists forwards or
+  // backwards, line by line, gives the images in sorted order without
+  // sorting them again (the symmetries 4 - 7 swap rows and columns).
+  std::vector<Isle> lists[2] = {isles, isles};
+  std::sort(lists[0].begin(), lists[0].end(),
+      [](const Isle& a, const Isle& b) {
+    return a.y < b.y || (a.y == b.y && a.x < b.x);
+  });
+  std::sort(lists[1].begin(), lists[1].end(),
+      [](const Isle& a, const Isle& b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+  });
+  // the first index of every line (and the end of the list)
+  std::vector<int> lines[2];
+  for (int l = 0; l < 2; l++) {
+    for (unsigned int i = 0; i < lists[l].size(); i++) {
+      if (i == 0 || (l == 0 ? lists[l][i].y != lists[l][i - 1].y
+                            : lists[l][i].x != lists[l][i - 1].x)) {
+        lines[l].push_back(i);
+      }
+    }
+    lines[l].push_back(lists[l].size());
+  }
+
+  CanonicalForm best;
+  best.symmetry = -1;
+  std::vector<uint64_t> candidate(isles.size());
+  for (int s = 0; s < kSymmetries; s++) {
+    int w = (s & 4) ? height : width;
+    int h = (s & 4) ? width : height;
+    if (best.symmetry >= 0 && (w > best.width
+        || (w == best.width && h > best.height))) {
+      continue;
+    }
+    // < 0: better than the best form so far, 0: equal so far, > 0: worse
+    int order = best.symmetry < 0 || w < best.width || h < best.height
+        ? -1 : 0;
+    const std::vector<Isle>& list = lists[s >> 2];
+    const std::vector<int>& starts = lines[s >> 2];
+    int lineCount = starts.size() - 1;
+    unsigned int k = 0;
+    for (int j = 0; j < lineCount && order <= 0; j++) {
+      // mirroring the line axis reverses the lines, mirroring the other
+      // axis reverses the isles of a line
+      int line = (s & 2) ? lineCount - 1 - j : j;
+      int size = starts[line + 1] - starts[line];
+      for (int i = 0; i < size && order <= 0; i++, k++) {
+        const Isle& isle = list[starts[line] + ((s & 1) ? size - 1 - i : i)];
+        Isle image = mapIsle(isle, width, height, s);
+        candidate[k] = (static_cast<uint64_t>(image.y) << 32)
+            | (static_cast<uint64_t>(image.x) << 8) | image.value;
+        if (order == 0 && candidate[k] != best.isles[k]) {
+          order = candidate[k] < best.isles[k] ? -1 : 1;
+        }
+      }
+    }
+    if (order < 0) {
+      best.width = w;
+      best.height = h;
+      best.isles.swap(candidate);
+      candidate.resize(isles.size());
+      best.symmetry = s;
+    }
+  }
+  return best;
+}
+
+// ____________________________________________________________________________
+CanonicalForm Canonical::form(const std::vector< std::vector<int> >& numbers) {
+  int height = numbers.size();
+  int width = height > 0 ? numbers[0].size() : 0;
+  std::vector<Isle> isles;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      if (numbers[y][x] > 0 && numbers[y][x] < 9) {
+        Isle isle = {x, y, numbers[y][x]};
+        isles.push_back(isle);
+      }
+    }
+  }
+  return form(isles, width, height);
+}
+
+// ____________________________________________________________________________
+PuzzleHash Canonical::hash(const CanonicalForm& form) {
+  std::vector<uint64_t> words;
+  words.reserve(form.isles.size() + 1);
+  words.push_back((static_cast<uint64_t>(form.width) << 32) | form.height);
+  words.insert(words.end(), form.isles.begin(), form.isles.end());
+  return hashWords(words.data(), words.size());
+}
+
+// ____________________________________________________________________________
+PuzzleHash Canonical::hashWords(const uint64_t* words, const size_t count) {
+  const uint64_t c1 = 0x87c37b91114253d5ULL;
+  const uint64_t c2 = 0x4cf5ad432745937fULL;
+  uint64_t h1 = 0x9e3779b97f4a7c15ULL;
+  uint64_t h2 = 0x6a09e667f3bcc909ULL;
+  for (size_t i = 0; i < count; i++) {
+    // each word goes into both lanes with different multipliers
+    uint64_t k1 = rotl(words[i] * c1, 31) * c2;
+    uint64_t k2 = rotl(words[i] * c2, 33) * c1;
+    h1 ^= k1;
+    h1 = rotl(h1, 27) + h2;
+    h1 = h1 * 5 + 0x52dce729;
+    h2 ^= k2;
+    h2 = rotl(h2, 31) + h1;
+    h2 = h2 * 5 + 0x38495ab5;
+  }
+  h1 ^= count;
+  h2 ^= count;
+  h1 += h2;
+  h2 += h1;
+  h1 = fmix(h1);
+  h2 = fmix(h2);
+  h1 += h2;
+  h2 += h1;
+  PuzzleHash result = {h1, h2};
+  return result;
+}
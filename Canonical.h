@@ -0,0 +1,79 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef CANONICAL_H_
+#define CANONICAL_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "./IsleGraph.h"
+
+// 128-bit content hash of a puzzle.
+struct PuzzleHash {
+  uint64_t hi;
+  uint64_t lo;
+
+  bool operator==(const PuzzleHash& other) const {
+    return hi == other.hi && lo == other.lo;
+  }
+  bool operator!=(const PuzzleHash& other) const { return !(*this == other); }
+  bool operator<(const PuzzleHash& other) const {
+    return hi < other.hi || (hi == other.hi && lo < other.lo);
+  }
+
+  // Returns: std::string - the 32 hex digits of the hash
+  std::string hex() const;
+};
+
+// A puzzle in its canonical orientation: of the 8 images under the grid
+// symmetries (rotations and mirror images) the one with the smallest
+// proportions and isle list. Equivalent puzzles have the same form, no
+// matter how they were rotated, mirrored or stored (.xy or .plain).
+struct CanonicalForm {
+  int width;
+  int height;
+  // the isles packed as (y << 32 | x << 8 | value), sorted
+  std::vector<uint64_t> isles;
+  // the symmetry (see Canonical::symmetryName()) that maps the original
+  // puzzle to this form
+  int symmetry;
+};
+
+// Canonical forms and content hashes of puzzles.
+class Canonical {
+ public:
+  static const int kSymmetries = 8;
+
+  // Returns: const char* - the name of a symmetry (0 is the identity)
+  static const char* symmetryName(const int symmetry);
+
+  // Map an isle of a width x height number field by a symmetry. The
+  // symmetries 4 - 7 swap the proportions.
+  static Isle mapIsle(const Isle& isle, const int width, const int height,
+   const int symmetry);
+  FRIEND_TEST(Canonical, mapIsle);
+
+  // Compute the canonical form of a parsed isle list.
+  // Arguments:
+  //   const std::vector<Isle>& isles - the isles (in any order)
+  //   const int width, const int height - the proportions of the field
+  static CanonicalForm form(const std::vector<Isle>& isles, const int width,
+   const int height);
+  FRIEND_TEST(Canonical, form);
+
+  // Compute the canonical form of a _numbers matrix (see Hashi).
+  static CanonicalForm form(const std::vector< std::vector<int> >& numbers);
+
+  // Returns: PuzzleHash - the hash of the proportions and the isles of a
+  // canonical form
+  static PuzzleHash hash(const CanonicalForm& form);
+  FRIEND_TEST(Canonical, hash);
+
+ private:
+  // Hash 64-bit words with two lanes (in the style of MurmurHash3).
+  static PuzzleHash hashWords(const uint64_t* words, const size_t count);
+};
+
+#endif  // CANONICAL_H_
@@ -0,0 +1,80 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "./Canonical.h"
+
+// _____________________________________________________________________________
+TEST(Canonical, mapIsle) {
+  Isle isle = {1, 0, 3};
+  // a 4 x 2 field
+  int expected[8][2] = {{1, 0}, {2, 0}, {1, 1}, {2, 1},
+                        {0, 1}, {1, 1}, {0, 2}, {1, 2}};
+  for (int s = 0; s < Canonical::kSymmetries; s++) {
+    Isle image = Canonical::mapIsle(isle, 4, 2, s);
+    ASSERT_EQ(expected[s][0], image.x);
+    ASSERT_EQ(expected[s][1], image.y);
+    ASSERT_EQ(3, image.value);
+  }
+  ASSERT_STREQ("rotate-90", Canonical::symmetryName(5));
+}
+
+// _____________________________________________________________________________
+TEST(Canonical, form) {
+  std::vector< std::vector<int> > numbers = {{4, 0, 0, 3, 0, 0},
+                                              {0, 0, 0, 0, 0, 0},
+                                              {2, 0, 0, 1, 0, 0}};
+  CanonicalForm form = Canonical::form(numbers);
+  // the wide orientation comes first
+  ASSERT_EQ(3, form.width);
+  ASSERT_EQ(6, form.height);
+  ASSERT_EQ(4, form.isles.size());
+
+  // all images of the puzzle have the same form
+  std::vector<Isle> isles = {{0, 0, 4}, {3, 0, 3}, {0, 2, 2}, {3, 2, 1}};
+  for (int s = 0; s < Canonical::kSymmetries; s++) {
+    std::vector<Isle> images;
+    for (unsigned int i = 0; i < isles.size(); i++) {
+      images.push_back(Canonical::mapIsle(isles[i], 6, 3, s));
+    }
+    CanonicalForm imageForm = Canonical::form(images, s < 4 ? 6 : 3,
+        s < 4 ? 3 : 6);
+    ASSERT_EQ(form.isles, imageForm.isles);
+    ASSERT_EQ(form.width, imageForm.width);
+    // the symmetry maps the image back to the form
+    std::vector<Isle> back;
+    for (unsigned int i = 0; i < images.size(); i++) {
+      back.push_back(Canonical::mapIsle(images[i], s < 4 ? 6 : 3,
+          s < 4 ? 3 : 6, imageForm.symmetry));
+    }
+    ASSERT_EQ(form.isles, Canonical::form(back, 3, 6).isles);
+  }
+}
+
+// _____________________________________________________________________________
+TEST(Canonical, hash) {
+  CanonicalForm form = Canonical::form({{4, 0, 0, 3, 0, 0},
+                                        {0, 0, 0, 0, 0, 0},
+                                        {2, 0, 0, 1, 0, 0}});
+  // mirrored
+  CanonicalForm mirrored = Canonical::form({{0, 0, 3, 0, 0, 4},
+                                            {0, 0, 0, 0, 0, 0},
+                                            {0, 0, 1, 0, 0, 2}});
+  ASSERT_EQ(Canonical::hash(form), Canonical::hash(mirrored));
+  ASSERT_EQ(32, Canonical::hash(form).hex().size());
+  // another value or another position
+  CanonicalForm other = Canonical::form({{4, 0, 0, 3, 0, 0},
+                                         {0, 0, 0, 0, 0, 0},
+                                         {2, 0, 0, 2, 0, 0}});
+  ASSERT_NE(Canonical::hash(form), Canonical::hash(other));
+  other = Canonical::form({{4, 0, 3, 0, 0, 0},
+                           {0, 0, 0, 0, 0, 0},
+                           {2, 0, 1, 0, 0, 0}});
+  ASSERT_NE(Canonical::hash(form), Canonical::hash(other));
+  // the proportions count as well
+  other = Canonical::form({{4, 0, 0, 3, 0, 0, 0},
+                           {0, 0, 0, 0, 0, 0, 0},
+                           {2, 0, 0, 1, 0, 0, 0}});
+  ASSERT_NE(Canonical::hash(form), Canonical::hash(other));
+}
@@ -0,0 +1,99 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <string>
+#include <vector>
+#include "./ClauseSolver.h"
+#include "./FileInterpreter.h"
+#include "./IsleGraph.h"
+#include "./Solver.h"
+
+// Print the usage and exit.
+void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./ClauseBenchMain [--budget <ms>] <puzzlefiles>\n");
+  fprintf(stderr, "Solves every puzzle with the backtracking Solver (one "
+   "thread) and the\nClauseSolver, each within the budget (default 10000 "
+   "ms), e.g. the puzzles\nin benchmarks/.\n");
+  exit(1);
+}
+
+// Returns: const char* - the verdict of a search
+const char* verdict(const bool found, const bool stopped) {
+  return stopped ? "timeout" : (found ? "solved" : "unsolvable");
+}
+
+// Compares the backtracking search with the clause learning search on a
+// set of puzzle files.
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"budget", 1, NULL, 'b'},
+    {NULL, 0, NULL, 0}
+  };
+  int budget = 10000;
+  while (true) {
+    int c = getopt_long(argc, argv, "b:", options, NULL);
+    if (c == -1) {break; }
+    switch (c) {
+      case 'b':
+        budget = std::max(1, atoi(optarg));
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+  if (optind >= argc) {printUsageAndExit(); }
+
+  bool valid = true;
+  for (int i = optind; i < argc; i++) {
+    std::vector< std::vector<int> > numbers;
+    if (!FileInterpreter::readPuzzle(argv[i], &numbers)) {
+      fprintf(stderr, "Skipping invalid puzzle: %s\n", argv[i]);
+      continue;
+    }
+    IsleGraph graph(numbers);
+    std::vector<Bridge> solution;
+
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    Solver solver(numbers);
+    solver.setDeadline(start + std::chrono::milliseconds(budget));
+    bool found = solver.solve(1, &solution);
+    valid &= !found || graph.verify(solution);
+    std::chrono::steady_clock::time_point middle =
+        std::chrono::steady_clock::now();
+    ClauseSolver clauses(numbers);
+    clauses.setDeadline(middle + std::chrono::milliseconds(budget));
+    bool learned = clauses.solve(&solution);
+    valid &= !learned || graph.verify(solution);
+    std::chrono::steady_clock::time_point end =
+        std::chrono::steady_clock::now();
+
+    double backtracking = std::chrono::duration<double, std::milli>(
+        middle - start).count();
+    double learning = std::chrono::duration<double, std::milli>(
+        end - middle).count();
+    printf("%s\n  backtracking: %10.1f ms %-10s %10lld nodes\n"
+     "  clauses:      %10.1f ms %-10s %10lld conflicts %8lld learned  "
+     "speedup %s%.1f\n", argv[i], backtracking,
+     verdict(found, solver.stopped()),
+     static_cast<long long>(solver.nodes()),  // NOLINT
+     learning, verdict(learned, clauses.stopped()),
+     static_cast<long long>(clauses.conflicts()),  // NOLINT
+     static_cast<long long>(clauses.learned()),  // NOLINT
+     solver.stopped() ? ">" : "", learning > 0 ? backtracking / learning : 0);
+    if (!solver.stopped() && !clauses.stopped() && found != learned) {
+      fprintf(stderr, "The searches disagree on %s\n", argv[i]);
+      valid = false;
+    }
+  }
+  if (!valid) {
+    fprintf(stderr, "Invalid result\n");
+    return 1;
+  }
+  return 0;
+}
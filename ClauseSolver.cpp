@@ -0,0 +1,709 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "./ClauseSolver.h"
+
+namespace {
+// conflicts of the first restart interval (multiplied by the Luby sequence)
+const int kRestartBase = 100;
+// learned clauses before the first reduction and the growth per reduction
+const int kFirstReduce = 2000;
+const int kReduceStep = 300;
+// decay of the variable and clause activities
+const double kVariableDecay = 0.95;
+const double kClauseDecay = 0.999;
+// the stop flag and the deadline are checked every kCheckSteps decisions
+// and conflicts
+const int kCheckSteps = 1024;
+
+// ____________________________________________________________________________
+int positive(const int variable) { return 2 * variable; }
+
+// ____________________________________________________________________________
+int negative(const int variable) { return 2 * variable + 1; }
+}  // namespace
+
+// ____________________________________________________________________________
+ClauseSolver::ClauseSolver(const std::vector< std::vector<int> >& numbers)
+  : _graph(numbers) {
+  _unsolvable = false;
+  _head = 0;
+  _increment = 1;
+  _clauseIncrement = 1;
+  _stop = NULL;
+  _deadline = std::chrono::steady_clock::time_point::max();
+  _stopped = false;
+  _decisions = 0;
+  _conflicts = 0;
+  _restarts = 0;
+  _learnedTotal = 0;
+  _learnedCount = 0;
+  _connected = false;
+  _stamp = 0;
+
+  int slots = _graph.slots().size();
+  int variables = 2 * slots;
+  _watches.resize(2 * variables);
+  _values.assign(variables, -1);
+  _levels.assign(variables, 0);
+  _reasons.assign(variables, -1);
+  _phases.assign(variables, 0);
+  _activity.assign(variables, 0);
+  _heapIndex.assign(variables, -1);
+  _seen.assign(variables, 0);
+  _marks.assign(_graph.isles().size(), 0);
+
+  // crossing slots are not both used
+  std::vector<int> literals(2);
+  for (int s = 0; s < slots; s++) {
+    const std::vector<int>& crossings = _graph.crossings(s);
+    for (unsigned int c = 0; c < crossings.size(); c++) {
+      if (crossings[c] < s) {continue; }
+      literals[0] = negative(usedVariable(s));
+      literals[1] = negative(usedVariable(crossings[c]));
+      addClause(literals);
+    }
+  }
+  for (unsigned int i = 0; i < _graph.isles().size(); i++) {
+    addIsle(i);
+  }
+  for (int v = 0; v < variables; v++) {
+    heapInsert(v);
+  }
+}
+
+// ____________________________________________________________________________
+void ClauseSolver::addClause(const std::vector<int>& literals) {
+  if (literals.empty()) {
+    _unsolvable = true;
+    return;
+  }
+  if (literals.size() == 1) {
+    if (value(literals[0]) == 0) {
+      _unsolvable = true;
+    } else if (value(literals[0]) < 0) {
+      enqueue(literals[0], -1);
+    }
+    return;
+  }
+  Clause clause;
+  clause.literals = literals;
+  clause.learned = false;
+  clause.deleted = false;
+  clause.lbd = 0;
+  clause.activity = 0;
+  _watches[literals[0]].push_back(_clauses.size());
+  _watches[literals[1]].push_back(_clauses.size());
+  _clauses.push_back(clause);
+}
+
+// ____________________________________________________________________________
+void ClauseSolver::addIsle(const int isle) {
+  static const std::vector<IsleClauses> table = isleClauses();
+  const std::vector<int>& slots = _graph.isleSlots(isle);
+  int value = _graph.isles()[isle].value;
+  if (value > kMaxValue) {
+    _unsolvable = true;
+    return;
+  }
+  const IsleClauses& clauses = table[slots.size() * (kMaxValue + 1) + value];
+  std::vector<int> literals;
+  for (unsigned int c = 0; c < clauses.size(); c++) {
+    literals.clear();
+    for (unsigned int k = 0; k < clauses[c].size(); k++) {
+      // local variable 2 * j (+ 1) is used (double) of the j-th slot
+      int local = clauses[c][k] >> 1;
+      int slot = slots[local >> 1];
+      int variable = local & 1 ? doubleVariable(slot) : usedVariable(slot);
+      literals.push_back(2 * variable + (clauses[c][k] & 1));
+    }
+    addClause(literals);
+  }
+}
+
+// ____________________________________________________________________________
+std::vector<ClauseSolver::IsleClauses> ClauseSolver::isleClauses() {
+  std::vector<IsleClauses> table((kMaxSlots + 1) * (kMaxValue + 1));
+  for (int slots = 0; slots <= kMaxSlots; slots++) {
+    // a partial assignment of the 2 * slots local variables in base 3
+    // (0 open, 1 false, 2 true)
+    int variables = 2 * slots;
+    int partials = 1;
+    for (int v = 0; v < variables; v++) {partials *= 3; }
+    int combinations = 1;
+    for (int j = 0; j < slots; j++) {combinations *= 3; }
+    for (int value = 0; value <= kMaxValue; value++) {
+      // nogood: no bridge counts with the right sum match the assignment.
+      // Every such count combination makes the assignments good that set
+      // some of the variables to its values.
+      std::vector<char> nogood(partials, 1);
+      for (int counts = 0; counts < combinations; counts++) {
+        int digits[2 * kMaxSlots];
+        int sum = 0;
+        for (int j = 0, c = counts; j < slots; j++, c /= 3) {
+          sum += c % 3;
+          digits[2 * j] = c % 3 > 0 ? 2 : 1;
+          digits[2 * j + 1] = c % 3 == 2 ? 2 : 1;
+        }
+        if (sum != value) {continue; }
+        for (int mask = 0; mask < (1 << variables); mask++) {
+          int p = 0;
+          for (int v = variables - 1; v >= 0; v--) {
+            p = 3 * p + ((mask >> v) & 1 ? digits[v] : 0);
+          }
+          nogood[p] = 0;
+        }
+      }
+      // keep the minimal nogoods (every open variable would make it good)
+      for (int p = 0; p < partials; p++) {
+        if (!nogood[p]) {continue; }
+        bool minimal = true;
+        std::vector<int> clause;
+        int power = 1;
+        for (int v = 0; v < variables && minimal; v++, power *= 3) {
+          int digit = p / power % 3;
+          if (digit == 0) {continue; }
+          minimal = !nogood[p - digit * power];
+          // the clause forbids the assignment: false -> positive literal
+          clause.push_back(2 * v + (digit == 2));
+        }
+        if (minimal) {
+          table[slots * (kMaxValue + 1) + value].push_back(clause);
+        }
+      }
+    }
+  }
+  return table;
+}
+
+// ____________________________________________________________________________
+void ClauseSolver::enqueue(const int literal, const int reason) {
+  int variable = literal >> 1;
+  _values[variable] = (literal & 1) ^ 1;
+  _levels[variable] = level();
+  _reasons[variable] = reason;
+  _trail.push_back(literal);
+  // a slot is ruled out (see checkConnectivity())
+  if (literal == negative(usedVariable(variable >> 1))) {
+    _removed.push_back(variable >> 1);
+  }
+}
+
+// ____________________________________________________________________________
+int ClauseSolver::propagate() {
+  while (_head < _trail.size()) {
+    int falseLiteral = _trail[_head++] ^ 1;
+    std::vector<int>& watches = _watches[falseLiteral];
+    unsigned int i = 0;
+    unsigned int j = 0;
+    while (i < watches.size()) {
+      int c = watches[i++];
+      Clause& clause = _clauses[c];
+      // deleted clauses leave the watch lists here
+      if (clause.deleted) {continue; }
+      std::vector<int>& literals = clause.literals;
+      if (literals[0] == falseLiteral) {
+        std::swap(literals[0], literals[1]);
+      }
+      if (value(literals[0]) == 1) {
+        watches[j++] = c;
+        continue;
+      }
+      // look for another literal to watch
+      bool moved = false;
+      for (unsigned int k = 2; k < literals.size(); k++) {
+        if (value(literals[k]) != 0) {
+          std::swap(literals[1], literals[k]);
+          _watches[literals[1]].push_back(c);
+          moved = true;
+          break;
+        }
+      }
+      if (moved) {continue; }
+      watches[j++] = c;
+      if (value(literals[0]) == 0) {
+        while (i < watches.size()) {
+          watches[j++] = watches[i++];
+        }
+        watches.resize(j);
+        return c;
+      }
+      enqueue(literals[0], c);
+    }
+    watches.resize(j);
+  }
+  return -1;
+}
+
+// ____________________________________________________________________________
+int ClauseSolver::checkConnectivity() {
+  int isles = _graph.isles().size();
+  if (isles <= 1) {
+    return -1;
+  }
+  if (_connected) {
+    // a graph that was connected stays connected if the isles of every
+    // slot removed since are still connected
+    while (!_removed.empty()) {
+      int s = _removed.back();
+      const BridgeSlot& slot = _graph.slots()[s];
+      int side = _values[usedVariable(s)] == 0 ? separate(slot.a, slot.b) : -1;
+      if (side >= 0) {
+        return addCut(_sides[side], _stamp + side);
+      }
+      _removed.pop_back();
+    }
+    return -1;
+  }
+
+  // the groups of isles connected by slots that are not ruled out
+  _component.assign(isles, -1);
+  int components = 0;
+  for (int start = 0; start < isles; start++) {
+    if (_component[start] >= 0) {continue; }
+    _component[start] = components;
+    _stack.clear();
+    _stack.push_back(start);
+    while (!_stack.empty()) {
+      int isle = _stack.back();
+      _stack.pop_back();
+      const std::vector<int>& slots = _graph.isleSlots(isle);
+      for (unsigned int j = 0; j < slots.size(); j++) {
+        if (_values[usedVariable(slots[j])] == 0) {continue; }
+        const BridgeSlot& slot = _graph.slots()[slots[j]];
+        int other = slot.a == isle ? slot.b : slot.a;
+        if (_component[other] < 0) {
+          _component[other] = components;
+          _stack.push_back(other);
+        }
+      }
+    }
+    components++;
+  }
+  if (components == 1) {
+    _connected = true;
+    _removed.clear();
+    return -1;
+  }
+
+  // the group with the fewest ruled out slots to other groups gives the
+  // shortest clause
+  const std::vector<BridgeSlot>& slots = _graph.slots();
+  std::vector<int> cut(components, 0);
+  for (unsigned int s = 0; s < slots.size(); s++) {
+    int a = _component[slots[s].a];
+    int b = _component[slots[s].b];
+    if (a != b) {
+      cut[a]++;
+      cut[b]++;
+    }
+  }
+  int best = std::min_element(cut.begin(), cut.end()) - cut.begin();
+  if (cut[best] == 0) {
+    return -2;
+  }
+  _stamp += 2;
+  _sides[0].clear();
+  for (int i = 0; i < isles; i++) {
+    if (_component[i] == best) {
+      _marks[i] = _stamp;
+      _sides[0].push_back(i);
+    }
+  }
+  return addCut(_sides[0], _stamp);
+}
+
+// ____________________________________________________________________________
+int ClauseSolver::separate(const int a, const int b) {
+  _stamp += 2;
+  int ends[2] = {a, b};
+  unsigned int next[2] = {0, 0};
+  for (int side = 0; side < 2; side++) {
+    _marks[ends[side]] = _stamp + side;
+    _sides[side].clear();
+    _sides[side].push_back(ends[side]);
+  }
+  // expand one isle per side in turn (breadth first, the list of a side
+  // keeps all its isles)
+  while (true) {
+    for (int side = 0; side < 2; side++) {
+      if (next[side] == _sides[side].size()) {
+        return side;
+      }
+      int isle = _sides[side][next[side]++];
+      const std::vector<int>& slots = _graph.isleSlots(isle);
+      for (unsigned int j = 0; j < slots.size(); j++) {
+        if (_values[usedVariable(slots[j])] == 0) {continue; }
+        const BridgeSlot& slot = _graph.slots()[slots[j]];
+        int other = slot.a == isle ? slot.b : slot.a;
+        if (_marks[other] == _stamp + 1 - side) {
+          return -1;
+        }
+        if (_marks[other] != _stamp + side) {
+          _marks[other] = _stamp + side;
+          _sides[side].push_back(other);
+        }
+      }
+    }
+  }
+}
+
+// ____________________________________________________________________________
+int ClauseSolver::addCut(const std::vector<int>& group, const int stamp) {
+  Clause clause;
+  for (unsigned int i = 0; i < group.size(); i++) {
+    const std::vector<int>& slots = _graph.isleSlots(group[i]);
+    for (unsigned int j = 0; j < slots.size(); j++) {
+      const BridgeSlot& slot = _graph.slots()[slots[j]];
+      int other = slot.a == group[i] ? slot.b : slot.a;
+      if (_marks[other] != stamp) {
+        clause.literals.push_back(positive(usedVariable(slots[j])));
+      }
+    }
+  }
+  // watch the literals that were assigned last
+  std::sort(clause.literals.begin(), clause.literals.end(),
+      [this](int x, int y) { return _levels[x >> 1] > _levels[y >> 1]; });
+  clause.learned = true;
+  clause.deleted = false;
+  clause.lbd = clause.literals.size();
+  clause.activity = 0;
+  if (clause.literals.size() > 1) {
+    _watches[clause.literals[0]].push_back(_clauses.size());
+    _watches[clause.literals[1]].push_back(_clauses.size());
+  }
+  _clauses.push_back(clause);
+  _learnedTotal++;
+  _learnedCount++;
+  return _clauses.size() - 1;
+}
+
+// ____________________________________________________________________________
+int ClauseSolver::analyze(int conflict, std::vector<int>* learned) {
+  learned->clear();
+  learned->push_back(-1);
+  int pending = 0;
+  int literal = -1;
+  int index = _trail.size() - 1;
+  do {
+    if (_clauses[conflict].learned) {bumpClause(conflict); }
+    const std::vector<int>& literals = _clauses[conflict].literals;
+    for (unsigned int j = literal < 0 ? 0 : 1; j < literals.size(); j++) {
+      int variable = literals[j] >> 1;
+      if (_seen[variable] || _levels[variable] == 0) {continue; }
+      _seen[variable] = 1;
+      bumpVariable(variable);
+      if (_levels[variable] >= level()) {
+        pending++;
+      } else {
+        learned->push_back(literals[j]);
+      }
+    }
+    // the next literal of the current level on the trail
+    while (!_seen[_trail[index] >> 1]) {index--; }
+    literal = _trail[index--];
+    conflict = _reasons[literal >> 1];
+    _seen[literal >> 1] = 0;
+    pending--;
+  } while (pending > 0);
+  (*learned)[0] = literal ^ 1;
+
+  // drop literals that are implied by the other ones
+  _stack.assign(learned->begin() + 1, learned->end());
+  unsigned int size = 1;
+  for (unsigned int i = 1; i < learned->size(); i++) {
+    int reason = _reasons[(*learned)[i] >> 1];
+    bool implied = reason >= 0;
+    if (implied) {
+      const std::vector<int>& literals = _clauses[reason].literals;
+      for (unsigned int k = 1; k < literals.size() && implied; k++) {
+        int variable = literals[k] >> 1;
+        implied = _seen[variable] || _levels[variable] == 0;
+      }
+    }
+    if (!implied) {(*learned)[size++] = (*learned)[i]; }
+  }
+  learned->resize(size);
+  for (unsigned int i = 0; i < _stack.size(); i++) {
+    _seen[_stack[i] >> 1] = 0;
+  }
+
+  // the backjump level is the highest level of the other literals
+  int back = 0;
+  for (unsigned int i = 1; i < learned->size(); i++) {
+    if (_levels[(*learned)[i] >> 1] > _levels[(*learned)[1] >> 1]) {
+      std::swap((*learned)[1], (*learned)[i]);
+    }
+  }
+  if (learned->size() > 1) {
+    back = _levels[(*learned)[1] >> 1];
+  }
+  return back;
+}
+
+// ____________________________________________________________________________
+void ClauseSolver::backtrack(const int level) {
+  if (this->level() <= level) {
+    return;
+  }
+  for (int i = _trail.size() - 1; i >= _levelStarts[level]; i--) {
+    int variable = _trail[i] >> 1;
+    _phases[variable] = _values[variable];
+    _values[variable] = -1;
+    _reasons[variable] = -1;
+    heapInsert(variable);
+  }
+  _trail.resize(_levelStarts[level]);
+  _levelStarts.resize(level);
+  _head = _trail.size();
+}
+
+// ____________________________________________________________________________
+bool ClauseSolver::resolve(const int conflict) {
+  // a connectivity clause may be false below the current level
+  int highest = 0;
+  const std::vector<int>& literals = _clauses[conflict].literals;
+  for (unsigned int j = 0; j < literals.size(); j++) {
+    highest = std::max(highest, _levels[literals[j] >> 1]);
+  }
+  if (highest == 0) {
+    return false;
+  }
+  backtrack(highest);
+
+  std::vector<int> learned;
+  int back = analyze(conflict, &learned);
+  backtrack(back);
+  if (learned.size() == 1) {
+    enqueue(learned[0], -1);
+  } else {
+    Clause clause;
+    clause.literals = learned;
+    clause.learned = true;
+    clause.deleted = false;
+    clause.activity = 0;
+    // the amount of different decision levels
+    std::vector<int> levels;
+    for (unsigned int i = 0; i < learned.size(); i++) {
+      levels.push_back(_levels[learned[i] >> 1]);
+    }
+    std::sort(levels.begin(), levels.end());
+    clause.lbd = std::unique(levels.begin(), levels.end()) - levels.begin();
+    _watches[learned[0]].push_back(_clauses.size());
+    _watches[learned[1]].push_back(_clauses.size());
+    _clauses.push_back(clause);
+    bumpClause(_clauses.size() - 1);
+    _learnedTotal++;
+    _learnedCount++;
+    enqueue(learned[0], _clauses.size() - 1);
+  }
+  _increment /= kVariableDecay;
+  _clauseIncrement /= kClauseDecay;
+  return true;
+}
+
+// ____________________________________________________________________________
+void ClauseSolver::reduce() {
+  std::vector<int> candidates;
+  for (unsigned int c = 0; c < _clauses.size(); c++) {
+    const Clause& clause = _clauses[c];
+    if (!clause.learned || clause.deleted || clause.lbd <= 2) {continue; }
+    // a reason clause has to stay
+    int first = clause.literals[0];
+    if (value(first) == 1 && _reasons[first >> 1] == static_cast<int>(c)) {
+      continue;
+    }
+    candidates.push_back(c);
+  }
+  std::sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+    return _clauses[a].lbd > _clauses[b].lbd
+        || (_clauses[a].lbd == _clauses[b].lbd
+            && _clauses[a].activity < _clauses[b].activity);
+  });
+  for (unsigned int i = 0; i < candidates.size() / 2; i++) {
+    Clause& clause = _clauses[candidates[i]];
+    clause.deleted = true;
+    std::vector<int>().swap(clause.literals);
+    _learnedCount--;
+  }
+}
+
+// ____________________________________________________________________________
+bool ClauseSolver::solve(std::vector<Bridge>* solution) {
+  _decisions = 0;
+  _conflicts = 0;
+  _restarts = 0;
+  _stopped = false;
+  if (_unsolvable) {
+    return false;
+  }
+  backtrack(0);
+  int64_t restart = 1;
+  int64_t untilRestart = kRestartBase * luby(restart);
+  int64_t reduceLimit = kFirstReduce;
+  while (true) {
+    int conflict = propagate();
+    if (conflict < 0) {
+      conflict = checkConnectivity();
+      if (conflict == -2) {
+        return false;
+      }
+    }
+    if (conflict >= 0) {
+      _conflicts++;
+      if (!resolve(conflict)) {
+        return false;
+      }
+      if (--untilRestart == 0) {
+        backtrack(0);
+        _restarts++;
+        untilRestart = kRestartBase * luby(++restart);
+      }
+      if (_learnedCount > reduceLimit) {
+        reduce();
+        reduceLimit += kReduceStep;
+      }
+      if (_conflicts % kCheckSteps == 0 && interrupted()) {
+        _stopped = true;
+        return false;
+      }
+      continue;
+    }
+
+    // decide the most active unassigned variable, or take the solution
+    if (_decisions % kCheckSteps == 0 && interrupted()) {
+      _stopped = true;
+      return false;
+    }
+    int variable = -1;
+    while (!_heap.empty() && variable < 0) {
+      int v = heapPop();
+      if (_values[v] < 0) {variable = v; }
+    }
+    if (variable < 0) {
+      break;
+    }
+    _decisions++;
+    _levelStarts.push_back(_trail.size());
+    enqueue(_phases[variable] == 1 ? positive(variable) : negative(variable),
+     -1);
+  }
+
+  solution->clear();
+  for (unsigned int s = 0; s < _graph.slots().size(); s++) {
+    int count = _values[usedVariable(s)] + _values[doubleVariable(s)];
+    if (count == 0) {continue; }
+    const Isle& a = _graph.isles()[_graph.slots()[s].a];
+    const Isle& b = _graph.isles()[_graph.slots()[s].b];
+    solution->push_back(Bridge(a.x, a.y, b.x, b.y, count));
+  }
+  backtrack(0);
+  return true;
+}
+
+// ____________________________________________________________________________
+bool ClauseSolver::interrupted() const {
+  return (_stop && *_stop) || std::chrono::steady_clock::now() > _deadline;
+}
+
+// ____________________________________________________________________________
+void ClauseSolver::bumpVariable(const int variable) {
+  _activity[variable] += _increment;
+  if (_activity[variable] > 1e100) {
+    for (unsigned int v = 0; v < _activity.size(); v++) {
+      _activity[v] *= 1e-100;
+    }
+    _increment *= 1e-100;
+  }
+  if (_heapIndex[variable] >= 0) {
+    heapUp(_heapIndex[variable]);
+  }
+}
+
+// ____________________________________________________________________________
+void ClauseSolver::bumpClause(const int clause) {
+  _clauses[clause].activity += _clauseIncrement;
+  if (_clauses[clause].activity > 1e20) {
+    for (unsigned int c = 0; c < _clauses.size(); c++) {
+      _clauses[c].activity *= 1e-20;
+    }
+    _clauseIncrement *= 1e-20;
+  }
+}
+
+// ____________________________________________________________________________
+void ClauseSolver::heapInsert(const int variable) {
+  if (_heapIndex[variable] >= 0) {
+    return;
+  }
+  _heapIndex[variable] = _heap.size();
+  _heap.push_back(variable);
+  heapUp(_heap.size() - 1);
+}
+
+// ____________________________________________________________________________
+int ClauseSolver::heapPop() {
+  int top = _heap[0];
+  _heapIndex[top] = -1;
+  int last = _heap.back();
+  _heap.pop_back();
+  if (!_heap.empty()) {
+    _heap[0] = last;
+    _heapIndex[last] = 0;
+    heapDown(0);
+  }
+  return top;
+}
+
+// ____________________________________________________________________________
+void ClauseSolver::heapUp(int index) {
+  int variable = _heap[index];
+  while (index > 0) {
+    int parent = (index - 1) / 2;
+    if (_activity[_heap[parent]] >= _activity[variable]) {break; }
+    _heap[index] = _heap[parent];
+    _heapIndex[_heap[index]] = index;
+    index = parent;
+  }
+  _heap[index] = variable;
+  _heapIndex[variable] = index;
+}
+
+// ____________________________________________________________________________
+void ClauseSolver::heapDown(int index) {
+  int variable = _heap[index];
+  int size = _heap.size();
+  while (2 * index + 1 < size) {
+    int child = 2 * index + 1;
+    if (child + 1 < size
+        && _activity[_heap[child + 1]] > _activity[_heap[child]]) {
+      child++;
+    }
+    if (_activity[_heap[child]] <= _activity[variable]) {break; }
+    _heap[index] = _heap[child];
+    _heapIndex[_heap[index]] = index;
+    index = child;
+  }
+  _heap[index] = variable;
+  _heapIndex[variable] = index;
+}
+
+// ____________________________________________________________________________
+int64_t ClauseSolver::luby(int64_t i) {
+  // find the finished subsequence of length 2^k - 1 that contains i
+  int64_t size = 1;
+  int exponent = 0;
+  while (size < i) {
+    size = 2 * size + 1;
+    exponent++;
+  }
+  while (size != i) {
+    size = (size - 1) / 2;
+    exponent--;
+    if (i > size) {i -= size; }
+  }
+  return int64_t(1) << exponent;
+}
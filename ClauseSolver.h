@@ -0,0 +1,232 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef CLAUSESOLVER_H_
+#define CLAUSESOLVER_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <vector>
+#include "./Bridge.h"
+#include "./IsleGraph.h"
+
+// Conflict driven clause learning search for a solution of a number field,
+// for huge and adversarial puzzles on which the backtracking of Solver
+// explodes. Every slot of the IsleGraph has two boolean variables: "used"
+// (at least one bridge) and "double" (two bridges). The rules become
+// clauses:
+//   - crossing slots: not both used
+//   - isle values: the bridge counts of the isle's slots add up to the
+//     value, a double bridge is used (see isleClauses())
+// Connectivity is handled lazily: whenever the slots that are not ruled
+// out split the isles into several groups, the slots leaving one group
+// form a new clause (one of them has to be used). Conflicts are analysed
+// to the first unique implication point and the learned clauses are
+// kept (and reduced now and then). The search restarts after a growing
+// amount of conflicts (Luby sequence).
+//
+// The solver is single threaded and uses no external library.
+class ClauseSolver {
+ public:
+  // Prepare a search for the isles of the given _numbers matrix (see Hashi).
+  explicit ClauseSolver(const std::vector< std::vector<int> >& numbers);
+  FRIEND_TEST(ClauseSolver, constructor);
+
+  // Search a solution.
+  // Arguments:
+  //   std::vector<Bridge>* solution - receives the bridges, a double
+  //     bridge has the count 2
+  // Returns:
+  //   bool - true if a solution was found, false if there is none (or the
+  //          search was stopped, see stopped())
+  bool solve(std::vector<Bridge>* solution);
+  FRIEND_TEST(ClauseSolver, solve);
+  FRIEND_TEST(ClauseSolver, unsolvable);
+
+  // Interrupt the search as soon as *stop becomes true or the deadline has
+  // passed (see Solver::setStop()).
+  void setStop(const std::atomic<bool>* stop) { _stop = stop; }
+  void setDeadline(const std::chrono::steady_clock::time_point deadline) {
+    _deadline = deadline;
+  }
+  FRIEND_TEST(ClauseSolver, stop);
+
+  // Returns: bool - true if the last search was interrupted
+  bool stopped() const { return _stopped; }
+
+  // statistics of the last search
+  int64_t decisions() const { return _decisions; }
+  int64_t conflicts() const { return _conflicts; }
+  int64_t restarts() const { return _restarts; }
+  // the amount of learned clauses (including the connectivity clauses)
+  int64_t learned() const { return _learnedTotal; }
+
+ private:
+  // A clause: the literals (2 * variable + 1 if negated), the first two are
+  // watched. A reason clause has the implied literal first.
+  struct Clause {
+    std::vector<int> literals;
+    bool learned;
+    bool deleted;
+    // amount of different decision levels when learned (smaller is better)
+    int lbd;
+    double activity;
+  };
+
+  IsleGraph _graph;
+  // the puzzle is unsolvable without search (e.g. an isle with more
+  // bridges than it can get)
+  bool _unsolvable;
+
+  std::vector<Clause> _clauses;
+  // the clauses watching each literal
+  std::vector< std::vector<int> > _watches;
+
+  // per variable: -1 unassigned, 0 false, 1 true
+  std::vector<int8_t> _values;
+  std::vector<int> _levels;
+  // the clause that implied the variable (-1 for decisions)
+  std::vector<int> _reasons;
+  // the last value of each variable (phase saving)
+  std::vector<int8_t> _phases;
+  // the true literals in assignment order
+  std::vector<int> _trail;
+  // the trail size at the start of every decision level
+  std::vector<int> _levelStarts;
+  // the next trail literal to propagate
+  unsigned int _head;
+
+  // variable activity (VSIDS) and a binary max heap of the unassigned
+  // variables ordered by it
+  std::vector<double> _activity;
+  double _increment;
+  std::vector<int> _heap;
+  std::vector<int> _heapIndex;
+  double _clauseIncrement;
+
+  // the slots that were ruled out since the last connectivity check that
+  // passed; _connected is false until a check of the whole graph passed
+  std::vector<int> _removed;
+  bool _connected;
+
+  // scratch space of analyze() and checkConnectivity(): the isles of a
+  // search are marked with the current stamp (one per side)
+  std::vector<char> _seen;
+  std::vector<int> _component;
+  std::vector<int> _stack;
+  std::vector<int> _marks;
+  int _stamp;
+  std::vector<int> _sides[2];
+
+  // see setStop() and setDeadline()
+  const std::atomic<bool>* _stop;
+  std::chrono::steady_clock::time_point _deadline;
+  bool _stopped;
+
+  int64_t _decisions;
+  int64_t _conflicts;
+  int64_t _restarts;
+  int64_t _learnedTotal;
+  int _learnedCount;
+
+  // the variables of a slot
+  static int usedVariable(const int slot) { return 2 * slot; }
+  static int doubleVariable(const int slot) { return 2 * slot + 1; }
+
+  // Returns: int - 1 if the literal is true, 0 if it is false, -1 if its
+  // variable is unassigned
+  int value(const int literal) const {
+    int v = _values[literal >> 1];
+    return v < 0 ? -1 : v ^ (literal & 1);
+  }
+
+  int level() const { return _levelStarts.size(); }
+
+  // Add a clause of the puzzle rules. A unit clause is assigned at once.
+  void addClause(const std::vector<int>& literals);
+
+  // Add the clauses of an isle (see the class comment).
+  void addIsle(const int isle);
+  FRIEND_TEST(ClauseSolver, addIsle);
+
+  // The clauses of an isle with up to kMaxSlots slots and a value up to
+  // kMaxValue (index slots * (kMaxValue + 1) + value) over the local
+  // variables 2 * j (used) and 2 * j + 1 (double) of its j-th slot. These
+  // are all minimal nogoods: assignments of some of the variables that
+  // no bridge counts with the right sum match, so unit propagation narrows
+  // the bridge counts as much as the isle allows.
+  typedef std::vector< std::vector<int> > IsleClauses;
+  static const int kMaxSlots = 4;
+  static const int kMaxValue = 8;
+  static std::vector<IsleClauses> isleClauses();
+  FRIEND_TEST(ClauseSolver, isleClauses);
+
+  // Make a literal true.
+  void enqueue(const int literal, const int reason);
+
+  // Propagate the trail.
+  // Returns: int - the conflicting clause or -1
+  int propagate();
+  FRIEND_TEST(ClauseSolver, propagate);
+
+  // Check that the slots which are not ruled out connect all isles. The
+  // first check walks the whole graph, later ones only search a path
+  // between the isles of every slot in _removed (from both ends at once,
+  // so the search stops at the smaller side of a split).
+  // Returns: int - -1 if they do, otherwise the index of a new clause whose
+  // literals are all false: one of the slots leaving a group of isles is
+  // used. -2 if there is no such slot at all (unsolvable).
+  int checkConnectivity();
+  FRIEND_TEST(ClauseSolver, checkConnectivity);
+
+  // Search the isles a and b from both sides over the slots that are not
+  // ruled out.
+  // Returns: int - -1 if they are connected, otherwise the side (0 for a,
+  // 1 for b) whose group of isles (in _sides) is closed
+  int separate(const int a, const int b);
+
+  // Add the clause "one of the slots leaving the group is used" for the
+  // isles marked with the given stamp.
+  // Returns: int - the clause
+  int addCut(const std::vector<int>& group, const int stamp);
+
+  // Learn from a conflict: the first unique implication point clause.
+  // Arguments:
+  //   int conflict - the conflicting clause
+  //   std::vector<int>* learned - receives the clause, the asserting
+  //     literal first and a literal of the backjump level second
+  // Returns: int - the backjump level
+  int analyze(int conflict, std::vector<int>* learned);
+
+  // Undo the assignments above the given decision level.
+  void backtrack(const int level);
+
+  // Handle a conflict: analyze it, backjump and assert the learned clause.
+  // Returns: bool - false if the conflict is on decision level 0
+  bool resolve(const int conflict);
+
+  // Remove about half of the learned clauses (the least useful ones that
+  // are not the reason of an assignment).
+  void reduce();
+
+  // Returns: bool - true if the search has to be interrupted
+  bool interrupted() const;
+
+  // activity of variables and clauses
+  void bumpVariable(const int variable);
+  void bumpClause(const int clause);
+
+  // the heap of the unassigned variables
+  void heapInsert(const int variable);
+  int heapPop();
+  void heapUp(int index);
+  void heapDown(int index);
+
+  // Returns: int - the i-th element of the Luby sequence (1 1 2 1 1 2 4 ...)
+  static int64_t luby(int64_t i);
+  FRIEND_TEST(ClauseSolver, luby);
+};
+
+#endif  // CLAUSESOLVER_H_
@@ -0,0 +1,186 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <vector>
+#include "./ClauseSolver.h"
+#include "./Generator.h"
+#include "./IsleGraph.h"
+
+// _____________________________________________________________________________
+TEST(ClauseSolver, constructor) {
+  // two slots: 3 - 1 horizontal, 3 - 2 vertical
+  ClauseSolver solver({{3, 0, 1},
+                       {0, 0, 0},
+                       {2, 0, 0}});
+  ASSERT_FALSE(solver._unsolvable);
+  ASSERT_EQ(4, solver._values.size());
+  ASSERT_EQ(4, solver._heap.size());
+  // an isle with more bridges than its slots can take
+  ClauseSolver tooMany({{5, 0, 1},
+                        {0, 0, 0},
+                        {2, 0, 0}});
+  ASSERT_TRUE(tooMany._unsolvable);
+}
+
+// _____________________________________________________________________________
+TEST(ClauseSolver, addIsle) {
+  // two 1-isles: the slot is used and not double
+  ClauseSolver solver({{1, 0, 1}});
+  ASSERT_EQ(0, solver._clauses.size());
+  ASSERT_EQ(1, solver._values[solver.usedVariable(0)]);
+  ASSERT_EQ(0, solver._values[solver.doubleVariable(0)]);
+  // a 4-isle with 4 variables: all of them are unit clauses
+  ClauseSolver four({{2, 0, 4, 0, 2}});
+  for (int v = 0; v < 4; v++) {
+    ASSERT_EQ(1, four._values[v]);
+  }
+}
+
+// _____________________________________________________________________________
+TEST(ClauseSolver, isleClauses) {
+  std::vector<ClauseSolver::IsleClauses> table = ClauseSolver::isleClauses();
+  const int row = ClauseSolver::kMaxValue + 1;
+  // a 3-isle with two slots uses both of them
+  const ClauseSolver::IsleClauses& three = table[2 * row + 3];
+  ASSERT_NE(three.end(), std::find(three.begin(), three.end(),
+      std::vector<int>({0})));
+  ASSERT_NE(three.end(), std::find(three.begin(), three.end(),
+      std::vector<int>({4})));
+  // a double bridge is used (at a 2-isle with two slots, where the single
+  // slot is not ruled out already)
+  const ClauseSolver::IsleClauses& two = table[2 * row + 2];
+  ASSERT_NE(two.end(), std::find(two.begin(), two.end(),
+      std::vector<int>({0, 3})));
+  // a 0-isle with one slot: not used, not double
+  ASSERT_EQ(2, table[1 * row + 0].size());
+  // a 5-isle with two slots: the empty assignment is a nogood already
+  ASSERT_EQ(1, table[2 * row + 5].size());
+  ASSERT_EQ(0, table[2 * row + 5][0].size());
+}
+
+// _____________________________________________________________________________
+TEST(ClauseSolver, propagate) {
+  // the 2-isle has a single slot, so it is a double bridge
+  ClauseSolver solver({{3, 0, 1},
+                       {0, 0, 0},
+                       {2, 0, 0}});
+  ASSERT_EQ(-1, solver.propagate());
+  int vertical = solver._graph.slotBetween(0, 0, 0, 2);
+  ASSERT_EQ(1, solver._values[solver.usedVariable(vertical)]);
+  ASSERT_EQ(1, solver._values[solver.doubleVariable(vertical)]);
+
+  // two double bridges at a 2-isle contradict its value
+  ClauseSolver ring({{2, 0, 2},
+                     {0, 0, 0},
+                     {2, 0, 2}});
+  ASSERT_EQ(-1, ring.propagate());
+  ring._levelStarts.push_back(ring._trail.size());
+  ring.enqueue(2 * ring.doubleVariable(ring._graph.slotBetween(0, 0, 2, 0)),
+   -1);
+  ring.enqueue(2 * ring.doubleVariable(ring._graph.slotBetween(0, 0, 0, 2)),
+   -1);
+  ASSERT_LE(0, ring.propagate());
+}
+
+// _____________________________________________________________________________
+TEST(ClauseSolver, checkConnectivity) {
+  ClauseSolver solver({{2, 0, 2},
+                       {0, 0, 0},
+                       {2, 0, 2}});
+  ASSERT_EQ(-1, solver.propagate());
+  ASSERT_EQ(-1, solver.checkConnectivity());
+  // a double bridge at the top leaves the bottom isles only each other, the
+  // new clause demands one of the vertical slots
+  solver._levelStarts.push_back(solver._trail.size());
+  solver.enqueue(2 * solver.doubleVariable(
+      solver._graph.slotBetween(0, 0, 2, 0)), -1);
+  ASSERT_EQ(-1, solver.propagate());
+  int clause = solver.checkConnectivity();
+  ASSERT_LE(0, clause);
+  ASSERT_EQ(2, solver._clauses[clause].literals.size());
+  for (unsigned int j = 0; j < 2; j++) {
+    ASSERT_EQ(0, solver.value(solver._clauses[clause].literals[j]));
+  }
+  // isles without any slot to the others
+  ClauseSolver apart({{1, 0, 0},
+                      {0, 0, 0},
+                      {0, 0, 1}});
+  ASSERT_EQ(-2, apart.checkConnectivity());
+}
+
+// _____________________________________________________________________________
+TEST(ClauseSolver, solve) {
+  std::vector< std::vector<int> > numbers = {{4, 0, 0, 3, 0, 0},
+                                              {0, 0, 0, 0, 0, 0},
+                                              {2, 0, 0, 1, 0, 0}};
+  std::vector<Bridge> solution;
+  ClauseSolver solver(numbers);
+  ASSERT_TRUE(solver.solve(&solution));
+  ASSERT_EQ(3, solution.size());
+  ASSERT_TRUE(IsleGraph(numbers).verify(solution));
+
+  // a generated puzzle that needs search
+  Generator generator(40, 40, 7);
+  generator.generate(250, &numbers);
+  ClauseSolver large(numbers);
+  ASSERT_TRUE(large.solve(&solution));
+  ASSERT_TRUE(IsleGraph(numbers).verify(solution));
+  ASSERT_FALSE(large.stopped());
+}
+
+// _____________________________________________________________________________
+TEST(ClauseSolver, unsolvable) {
+  std::vector<Bridge> solution;
+  // two isles that can't be connected
+  ClauseSolver apart({{1, 0, 0},
+                      {0, 0, 0},
+                      {0, 0, 1}});
+  ASSERT_FALSE(apart.solve(&solution));
+  // the 1-isles must not be connected to each other
+  ClauseSolver disconnected({{1, 0, 1, 0, 0},
+                             {0, 0, 0, 0, 0},
+                             {0, 0, 0, 0, 0},
+                             {0, 0, 2, 0, 2}});
+  ASSERT_FALSE(disconnected.solve(&solution));
+  ASSERT_FALSE(disconnected.stopped());
+  // a ring of 2-isles with one 4-isle: the values add up to an odd sum
+  ClauseSolver odd({{2, 0, 2, 0, 0},
+                    {0, 0, 0, 0, 0},
+                    {2, 0, 4, 0, 1}});
+  ASSERT_FALSE(odd.solve(&solution));
+  ASSERT_LT(0, odd.conflicts() + odd.decisions());
+}
+
+// _____________________________________________________________________________
+TEST(ClauseSolver, stop) {
+  std::vector< std::vector<int> > numbers;
+  Generator generator(20, 20, 7);
+  generator.generate(60, &numbers);
+  std::vector<Bridge> solution;
+  ClauseSolver solver(numbers);
+  std::atomic<bool> stop(true);
+  solver.setStop(&stop);
+  ASSERT_FALSE(solver.solve(&solution));
+  ASSERT_TRUE(solver.stopped());
+  stop = false;
+  solver.setDeadline(std::chrono::steady_clock::now());
+  ASSERT_FALSE(solver.solve(&solution));
+  ASSERT_TRUE(solver.stopped());
+  // without limits the search finishes
+  solver.setDeadline(std::chrono::steady_clock::now()
+      + std::chrono::hours(1));
+  ASSERT_TRUE(solver.solve(&solution));
+  ASSERT_FALSE(solver.stopped());
+}
+
+// _____________________________________________________________________________
+TEST(ClauseSolver, luby) {
+  int64_t expected[] = {1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, 1};
+  for (int i = 0; i < 16; i++) {
+    ASSERT_EQ(expected[i], ClauseSolver::luby(i + 1));
+  }
+}
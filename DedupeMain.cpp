@@ -0,0 +1,132 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "./Canonical.h"
+#include "./FileInterpreter.h"
+#include "./ThreadPool.h"
+
+// Print the usage and exit.
+void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./DedupeMain [--threads <int>] [--list <file>] "
+   "[<puzzlefiles>]\n");
+  fprintf(stderr, "Hashes the canonical form of .xy / .plain puzzles and "
+   "prints the clusters of\nequivalent puzzles (equal up to rotations and "
+   "mirror images). --list reads\nthe file names line by line (- for "
+   "stdin).\n");
+  exit(1);
+}
+
+// The canonical hash of a puzzle file.
+struct Entry {
+  PuzzleHash hash;
+  int symmetry;
+  bool valid;
+};
+
+// Hashes a corpus of puzzles in parallel and reports the clusters of
+// equivalent puzzles.
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"threads", 1, NULL, 't'},
+    {"list", 1, NULL, 'l'},
+    {NULL, 0, NULL, 0}
+  };
+  int threads = 4;
+  std::vector<std::string> files;
+  while (true) {
+    int c = getopt_long(argc, argv, "t:l:", options, NULL);
+    if (c == -1) {break; }
+    switch (c) {
+      case 't':
+        threads = std::max(1, atoi(optarg));
+        break;
+      case 'l': {
+        // a corpus of a million files does not fit the command line
+        std::ifstream list;
+        std::istream* in = &std::cin;
+        if (std::string(optarg) != "-") {
+          list.open(optarg);
+          if (!list.is_open()) {
+            fprintf(stderr, "Error reading the list: %s\n", optarg);
+            return 1;
+          }
+          in = &list;
+        }
+        std::string line;
+        while (std::getline(*in, line)) {
+          if (!line.empty()) {files.push_back(line); }
+        }
+        break;
+      }
+      default:
+        printUsageAndExit();
+    }
+  }
+  for (int i = optind; i < argc; i++) {
+    files.push_back(argv[i]);
+  }
+  if (files.empty()) {printUsageAndExit(); }
+
+  std::vector<Entry> entries(files.size());
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  ThreadPool pool(threads);
+  pool.run(files.size(), [&](int i) {
+    std::vector< std::vector<int> > numbers;
+    entries[i].valid = FileInterpreter::readPuzzle(files[i], &numbers);
+    if (entries[i].valid) {
+      CanonicalForm form = Canonical::form(numbers);
+      entries[i].hash = Canonical::hash(form);
+      entries[i].symmetry = form.symmetry;
+    }
+  });
+  double ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+
+  // equivalent puzzles are neighbours after sorting by the hash
+  std::vector<int> order;
+  for (unsigned int i = 0; i < entries.size(); i++) {
+    if (entries[i].valid) {
+      order.push_back(i);
+    } else {
+      fprintf(stderr, "Skipping invalid puzzle: %s\n", files[i].c_str());
+    }
+  }
+  std::sort(order.begin(), order.end(), [&](int a, int b) {
+    return entries[a].hash < entries[b].hash
+        || (entries[a].hash == entries[b].hash && a < b);
+  });
+  int clusters = 0;
+  int duplicates = 0;
+  for (unsigned int i = 0; i < order.size();) {
+    unsigned int end = i + 1;
+    while (end < order.size()
+           && entries[order[end]].hash == entries[order[i]].hash) {
+      end++;
+    }
+    if (end - i > 1) {
+      clusters++;
+      duplicates += end - i - 1;
+      printf("%s  %u puzzles\n", entries[order[i]].hash.hex().c_str(),
+       end - i);
+      for (unsigned int j = i; j < end; j++) {
+        printf("  %-14s  %s\n",
+         Canonical::symmetryName(entries[order[j]].symmetry),
+         files[order[j]].c_str());
+      }
+    }
+    i = end;
+  }
+  printf("hashed %zu puzzles with %d threads in %.1f ms: %d clusters, "
+   "%d duplicates\n", order.size(), threads, ms, clusters, duplicates);
+  return 0;
+}
@@ -0,0 +1,122 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <fstream>
+#include <string>
+#include <vector>
+#include "./FileInterpreter.h"
+#include "./IsleGraph.h"
+#include "./RegionSolver.h"
+
+// Print the usage and exit.
+void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./EmbedMain [--budget <ms>] <puzzlefiles>\n");
+  fprintf(stderr, "Writes the table of the built-in puzzles (see "
+   "BuiltinPuzzles.h) to stdout. The\nsolution of a puzzle is read from "
+   "its .solution file or searched within the\nbudget (default 10000 ms), "
+   "e.g. for instances/*.xy.\n");
+  exit(1);
+}
+
+// Write the values of an array, 16 per line, with a trailing 0 (an array
+// must not be empty).
+void writeArray(const char* declaration, const std::vector<int>& values) {
+  printf("%s[] = {\n", declaration);
+  for (unsigned int i = 0; i <= values.size(); i++) {
+    printf(i % 16 == 0 ? "  " : " ");
+    printf("%d,", i < values.size() ? values[i] : 0);
+    if (i % 16 == 15 || i == values.size()) {printf("\n"); }
+  }
+  printf("};\n");
+}
+
+// Converts a set of puzzle files into the table of the built-in puzzles.
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"budget", 1, NULL, 'b'},
+    {NULL, 0, NULL, 0}
+  };
+  int budget = 10000;
+  while (true) {
+    int c = getopt_long(argc, argv, "b:", options, NULL);
+    if (c == -1) {break; }
+    switch (c) {
+      case 'b':
+        budget = std::max(1, atoi(optarg));
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+  if (optind >= argc) {printUsageAndExit(); }
+
+  std::vector<int> grids;
+  std::vector<int> isles;
+  std::vector<int> bridges;
+  std::vector<std::string> puzzles;
+  for (int i = optind; i < argc; i++) {
+    std::string file = argv[i];
+    std::vector< std::vector<int> > numbers;
+    // the coordinates of the solution have to fit a byte
+    if (!FileInterpreter::readPuzzle(file, &numbers) || numbers.empty()
+        || numbers.size() > 256 || numbers[0].size() > 256) {
+      fprintf(stderr, "Skipping %s: no valid puzzle up to 256x256\n",
+       file.c_str());
+      continue;
+    }
+    int width = numbers[0].size();
+    int height = numbers.size();
+    IsleGraph graph(numbers);
+
+    // the solution file or a search
+    std::vector<Bridge> solution;
+    std::ifstream in((file + ".solution").c_str());
+    if (!in.is_open() || !FileInterpreter::readSolution(&in, &solution)
+        || !graph.verify(solution)) {
+      RegionSolver solver(numbers);
+      solver.setDeadline(std::chrono::steady_clock::now()
+          + std::chrono::milliseconds(budget));
+      if (!solver.solve(1, &solution)) {
+        fprintf(stderr, "No solution of %s%s\n", file.c_str(),
+         solver.stopped() ? " within the budget" : "");
+        solution.clear();
+      }
+    }
+
+    std::string name = file.substr(file.find_last_of('/') + 1);
+    name = name.substr(0, name.find('.'));
+    char entry[256];
+    snprintf(entry, sizeof(entry), "  {\"%s\", %d, %d, kGrids + %zu, "
+     "kIsles + %zu, %zu, kBridges + %zu, %zu},", name.c_str(), width, height,
+     grids.size(), isles.size(), graph.isles().size(), bridges.size(),
+     solution.size());
+    puzzles.push_back(entry);
+    for (int y = 0; y < height; y++) {
+      grids.insert(grids.end(), numbers[y].begin(), numbers[y].end());
+    }
+    for (unsigned int j = 0; j < graph.isles().size(); j++) {
+      isles.push_back(graph.isles()[j].y * width + graph.isles()[j].x);
+    }
+    for (unsigned int j = 0; j < solution.size(); j++) {
+      int values[5] = {solution[j].x1, solution[j].y1, solution[j].x2,
+                       solution[j].y2, solution[j].count};
+      bridges.insert(bridges.end(), values, values + 5);
+    }
+  }
+
+  printf("// Generated by EmbedMain, do not edit.\n");
+  writeArray("const uint8_t kGrids", grids);
+  writeArray("const uint16_t kIsles", isles);
+  writeArray("const uint8_t kBridges", bridges);
+  printf("const BuiltinPuzzle kPuzzles[] = {\n");
+  for (unsigned int i = 0; i < puzzles.size(); i++) {
+    printf("%s\n", puzzles[i].c_str());
+  }
+  printf("};\n");
+  return 0;
+}
@@ -2,29 +2,84 @@
 // Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
 
 #include <getopt.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
 #include <fstream>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
+#include "./BuiltinPuzzles.h"
 #include "./FileInterpreter.h"
+#include "./GameServer.h"
 #include "./Hashi.h"
+#include "./Pipeline.h"
+#include "./Playlist.h"
+#include "./SaveGame.h"
+#include "./SolutionCache.h"
+#include "./SolveService.h"
 
 // ____________________________________________________________________________
 FileInterpreter::FileInterpreter() {
   // set default values
   _inputFile = "";
   _solutionFile = "";
+  _cacheFile = "";
+  _saveFile = "";
+  _serve = false;
+  _socketFile = "";
+  _pipeline = false;
+  _gameAddress = "";
+  _timing = false;
+  _builtin = 0;
   _undoOperations = 5;
+  _threads = 1;
+  _clauseSolver = false;
 }
 
 // ____________________________________________________________________________
 void FileInterpreter::printUsageAndExit() const {
   std::cerr << "Usage: ./HashiMain [options] <inputfile>\n";
+  std::cerr << "       ./HashiMain [options] <inputfiles> | <directory> | "
+  "<pattern> | <packfile>\n";
+  std::cerr << "       ./HashiMain [options] --builtin <n>\n";
+  std::cerr << "       ./HashiMain [options] --serve | --socket <path>\n";
+  std::cerr << "       ./HashiMain --games <port|path> <inputfiles>\n";
   std::cerr << "Available options:\n";
   std::cerr << "--solution <solutionfile> : "
   "A solution for the given input file.\n";
   std::cerr << " (default: null)\n";
   std::cerr << "--undos <int> : Amount of allowed undo-operations.\n";
-  std::cerr << " (default: 5)\n";
+  std::cerr << " (default: 5, also per session of --games)\n";
+  std::cerr << "--cache <cachefile> : "
+  "Solution cache shared by all runs.\n";
+  std::cerr << " (default: null)\n";
+  std::cerr << "--save <savefile> : Autosave the game and resume it "
+  "on the next start.\n";
+  std::cerr << " (default: null)\n";
+  std::cerr << "--serve : Answer solve / verify requests on stdin.\n";
+  std::cerr << "--socket <path> : Answer solve / verify requests on a "
+  "Unix domain socket.\n";
+  std::cerr << "--pipeline : Solve a stream of concatenated puzzle files "
+  "from stdin.\n";
+  std::cerr << "--games <port|path> : Host games of the input files for "
+  "many players on a\n local TCP port or a Unix domain socket.\n";
+  std::cerr << "--threads <int> : Amount of worker threads used to solve "
+  "the puzzle\n when no solution file is given.\n";
+  std::cerr << " (default: 1)\n";
+  std::cerr << "--solver region|clause : The solver of the game, --serve, "
+  "--socket and\n --pipeline: the RegionSolver or the ClauseSolver (for "
+  "huge puzzles).\n";
+  std::cerr << " (default: region)\n";
+  std::cerr << "--timing : Report the phases of the startup when the game "
+  "ends.\n";
+  std::cerr << "--builtin <n> : Play the built-in puzzle n (1 to "
+  << BuiltinPuzzles::size() << ", the puzzles\n of instances/ in the order "
+  "of their names) instead of an input file.\n";
   exit(1);
 }
 
@@ -32,17 +87,40 @@ void FileInterpreter::printUsageAndExit() const {
 void FileInterpreter::parseCommandLineArguments(int argc, char** argv) {
   struct option options[] = {
     {"solution", 1, NULL, 's'},
-    {"undos", 1, NULL, 'u' }
+    {"undos", 1, NULL, 'u' },
+    {"threads", 1, NULL, 't' },
+    {"cache", 1, NULL, 'c' },
+    {"save", 1, NULL, 'a' },
+    {"serve", 0, NULL, 'S' },
+    {"socket", 1, NULL, 'k' },
+    {"pipeline", 0, NULL, 'P' },
+    {"games", 1, NULL, 'g' },
+    {"timing", 0, NULL, 'T' },
+    {"builtin", 1, NULL, 'b' },
+    {"solver", 1, NULL, 'v' },
+    {NULL, 0, NULL, 0 }
   };
   optind = 1;
 
   // Default values
   _inputFile = "";
   _solutionFile = "";
+  _cacheFile = "";
+  _saveFile = "";
+  _serve = false;
+  _socketFile = "";
+  _pipeline = false;
+  _gameAddress = "";
+  _gameFiles.clear();
+  _playlistSources.clear();
+  _timing = false;
+  _builtin = 0;
   _undoOperations = 5;
+  _threads = 1;
+  _clauseSolver = false;
 
   while (true) {
-    char c = getopt_long(argc, argv, "s:u:", options, NULL);
+    char c = getopt_long(argc, argv, "s:u:t:c:a:Sk:Pg:Tb:v:", options, NULL);
     if (c == -1) {break; }
     switch (c) {
       case 's':
@@ -51,15 +129,68 @@ void FileInterpreter::parseCommandLineArguments(int argc, char** argv) {
       case 'u':
         _undoOperations = atoi(optarg);
         break;
+      case 't':
+        _threads = atoi(optarg);
+        break;
+      case 'c':
+        _cacheFile = optarg;
+        break;
+      case 'a':
+        _saveFile = optarg;
+        break;
+      case 'S':
+        _serve = true;
+        break;
+      case 'k':
+        _socketFile = optarg;
+        break;
+      case 'P':
+        _pipeline = true;
+        break;
+      case 'g':
+        _gameAddress = optarg;
+        break;
+      case 'T':
+        _timing = true;
+        break;
+      case 'b':
+        _builtin = atoi(optarg);
+        if (_builtin < 1) {
+          printUsageAndExit();
+        }
+        break;
+      case 'v':
+        if (strcmp(optarg, "clause") == 0) {
+          _clauseSolver = true;
+        } else if (strcmp(optarg, "region") != 0) {
+          printUsageAndExit();
+        }
+        break;
       default:
         printUsageAndExit();
     }
   }
+  // the game server hosts all given puzzle files
+  if (_gameAddress[0] != '\0') {
+    _gameFiles.assign(argv + optind, argv + argc);
+    if (_gameFiles.empty()) {
+      printUsageAndExit();
+    }
+    return;
+  }
+  // the service reads the puzzles from its requests, a built-in puzzle
+  // needs no file
+  if ((isServiceMode() || _builtin > 0) && optind == argc) {
+    return;
+  }
   // require input file
-  if (optind + 1 != argc) {
+  if (optind >= argc) {
     printUsageAndExit();
   }
   _inputFile = argv[optind];
+  if (optind + 1 < argc || Playlist::isPlaylist(_inputFile)) {
+    _playlistSources.assign(argv + optind, argv + argc);
+  }
 }
 
 // ____________________________________________________________________________
@@ -70,179 +201,392 @@ const {
 }
 
 // ____________________________________________________________________________
-void FileInterpreter::processFiles(Hashi* hashi) const {
-  if (checkFileEnding(_inputFile, ".xy")) {
-    setFieldxy(hashi);
-  } else if (checkFileEnding(_inputFile, ".plain")) {
-    setFieldPlain(hashi);
-  } else {
+void FileInterpreter::checkInputFormat() const {
+  if (_builtin == 0 && _playlistSources.empty()
+      && !checkFileEnding(_inputFile, ".xy")
+      && !checkFileEnding(_inputFile, ".plain")) {
     std::cerr << "<inputfile> has to have a .xy or .plain format! \n";
     printUsageAndExit();
   }
-  if (checkFileEnding(_solutionFile, ".xy.solution")) {
+}
+
+// ____________________________________________________________________________
+bool FileInterpreter::processFiles(Hashi* hashi, std::string* error) const {
+  checkInputFormat();
+  bool valid;
+  if (_builtin > 0) {
+    valid = setBuiltin(hashi, error);
+  } else if (!_playlistSources.empty()) {
+    valid = setPlaylist(hashi, error);
+  } else if (checkFileEnding(_inputFile, ".xy")) {
+    valid = setFieldxy(hashi, error);
+  } else {
+    valid = setFieldPlain(hashi, error);
+  }
+  if (!valid) {return false; }
+  if (_builtin == 0 && _playlistSources.empty()
+      && checkFileEnding(_solutionFile, ".xy.solution")) {
     setSolution(hashi);
   } else {
     // no valid solution file
     hashi->_solutionFile = "";
   }
+  hashi->_cacheFile = _cacheFile;
+  if (hashi->_sol.size() == 0 && _cacheFile[0] != '\0') {
+    SolutionCache cache(_cacheFile);
+    cache.lookup(hashi->_numbers, &hashi->_sol);
+  }
+  hashi->_threads = _threads > 0 ? _threads : 1;
+  hashi->_clauseSolver = _clauseSolver;
   try {
     // set allowed amount of undo operations
-    hashi->_undos.resize(_undoOperations,  std::vector<int>(4));
+    hashi->_undos.resize(_undoOperations);
   }
   catch (std::exception& e) {
-    hashi->_undos.resize(5,  std::vector<int>(4));
+    hashi->_undos.resize(5);
   }
+  // resume the saved game (a save file of another puzzle is overwritten)
+  hashi->_saveFile = _saveFile;
+  GameSnapshot snapshot;
+  if (_saveFile[0] != '\0' && SaveGame::load(_saveFile, &snapshot)) {
+    hashi->restore(snapshot);
+  }
+  return true;
 }
 
 // ____________________________________________________________________________
-void FileInterpreter::setFieldxy(Hashi* hashi) const {
-  std::ifstream file(_inputFile);
-  if (!file.is_open()) {
-    std::cerr << "Error opening input file: "<< _inputFile << std::endl;
-    exit(1);
-  }
-
-  // determine the size of the _numbers matrix
-  std::string line;
-  while (getline(file, line)) {
-    std::stringstream ss(line);
-    if (line[0] != '#' && line.length() != 0) {
-      try {
-        getline(ss, line, ',');
-        if (std::stoi(line) > hashi->_max_x) {
-          hashi->_max_x = std::stoi(line);
-        }
-        getline(ss, line, ',');
-        if (std::stoi(line) > hashi->_max_y) {
-          hashi->_max_y = std::stoi(line);
-        }
-      }
-      catch (std::exception& e) {
-          std::cerr << "Error reading the input file. Does it have the correct "
-          "format? \n";
-          exit(1);
+void FileInterpreter::runService() const {
+  if (_gameAddress[0] != '\0') {
+    GameServer server;
+    server.setUndoLimit(_undoOperations);
+    for (unsigned int i = 0; i < _gameFiles.size(); i++) {
+      std::vector< std::vector<int> > numbers;
+      if (readPuzzle(_gameFiles[i], &numbers) && !numbers.empty()) {
+        server.addPuzzle(numbers);
+      } else {
+        std::cerr << "Skipping invalid puzzle: " << _gameFiles[i]
+         << std::endl;
       }
     }
+    // digits only: a TCP port
+    bool tcp = strspn(_gameAddress, "0123456789") == strlen(_gameAddress);
+    bool listening = tcp ? server.listenTcp(atoi(_gameAddress))
+        : server.listenUnix(_gameAddress);
+    if (server.puzzles() == 0 || !listening) {
+      std::cerr << "Error opening the game server: " << _gameAddress
+       << std::endl;
+      exit(1);
+    }
+    server.run();
+    return;
   }
-  // Consider that the index of _numbers starts with 0.
-  hashi->_max_x++;
-  hashi->_max_y++;
-
-  // resize matrix
-  hashi->_numbers.resize(hashi->_max_y,
-   std::vector<int>(hashi->_max_x));
-
-  // go to the beginning of the file
-  file.clear();
-  file.seekg(0, std::ios::beg);
-
-  // read file
-  int coordList[3];
-  while (getline(file, line)) {
-    std::stringstream ss(line);
-    if (line[0] != '#' && line.length() != 0) {
-      for (int i = 0; i < 3; i++) {
-        getline(ss, line, ',');
-        try {
-          coordList[i] = std::stoi(line);
-        }
-        catch (std::exception& e) {
-          std::cerr << "Error reading the input file. Does it have the correct "
-          "format? \n";
-          exit(1);
-        }
-      }
+  if (_pipeline) {
+    Pipeline pipeline(_threads);
+    pipeline.setClauseSolver(_clauseSolver);
+    pipeline.run(0, 1);
+    return;
+  }
+  SolveService service(_threads > 0 ? _threads : 1, _cacheFile);
+  service.setClauseSolver(_clauseSolver);
+  if (_socketFile[0] != '\0') {
+    if (!service.serveSocket(_socketFile, 0)) {
+      std::cerr << "Error opening socket: " << _socketFile << std::endl;
+      exit(1);
+    }
+  } else {
+    service.serveStream(0, 1);
+  }
+}
 
-      // write numb in the given y,x position in the _numbers matrix
-      hashi->_numbers[coordList[1]][coordList[0]] = coordList[2];
+// ____________________________________________________________________________
+bool FileInterpreter::setPlaylist(Hashi* hashi, std::string* error) const {
+  std::unique_ptr<Playlist> playlist(new Playlist(_threads, _cacheFile));
+  for (unsigned int i = 0; i < _playlistSources.size(); i++) {
+    if (!playlist->add(_playlistSources[i], error)) {
+      return false;
     }
   }
+  // the second puzzle is prepared in the background from now on
+  PreparedPuzzle puzzle;
+  if (!playlist->next(&puzzle)) {
+    *error = "The playlist has no valid puzzle!";
+    return false;
+  }
+  hashi->load(&puzzle);
+  hashi->_playlist = std::move(playlist);
+  return true;
+}
+
+// ____________________________________________________________________________
+bool FileInterpreter::setBuiltin(Hashi* hashi, std::string* error) const {
+  const BuiltinPuzzle* puzzle = BuiltinPuzzles::get(_builtin);
+  if (puzzle == NULL) {
+    *error = "There is no built-in puzzle " + std::to_string(_builtin)
+        + " (1 to " + std::to_string(BuiltinPuzzles::size()) + ")";
+    return false;
+  }
+  BuiltinPuzzles::unpack(*puzzle, &hashi->_numbers, &hashi->_sol);
+  hashi->_max_y = puzzle->height;
+  hashi->_max_x = puzzle->width;
+  return true;
 }
 
 // ____________________________________________________________________________
-void FileInterpreter::setFieldPlain(Hashi* hashi) const {
+bool FileInterpreter::setFieldxy(Hashi* hashi, std::string* error) const {
   std::ifstream file(_inputFile);
   if (!file.is_open()) {
-    std::cerr << "Error opening input file: "<< _inputFile << std::endl;
-    exit(1);
+    *error = std::string("Error opening input file: ") + _inputFile;
+    return false;
+  }
+  if (!readFieldxy(&file, &hashi->_numbers, error)) {
+    return false;
   }
+  hashi->_max_y = hashi->_numbers.size();
+  hashi->_max_x = hashi->_max_y > 0 ? hashi->_numbers[0].size() : 0;
+  return true;
+}
 
-  // determine the size of the _numbers matrix
-  std::string line;
-  size_t temp = 0;
-  while (getline(file, line)) {
-    if (line[0] != '#' && line.length() != 0) {
-      hashi->_max_y++;
-      if (temp != line.length() && temp != 0) {
-        std::cerr << "The lines of the input file do not have the same "
-         "length! Consider deleting redundant spaces at the end of the "
-         "lines." << std::endl;
-        exit(1);
-      }
-      if (line.length() > (unsigned)hashi->_max_x) {
-        hashi->_max_x = line.length();
-      }
-      temp = line.length();
-    }
-  }
-
-  // resize matrices
-  hashi->_numbers.resize(hashi->_max_y,
-   std::vector<int>(hashi->_max_x));
-
-  // go to the beginning of the file
-  file.clear();
-  file.seekg(0, std::ios::beg);
-
-  // read file the file char by char
-  int linenr = 0;
-  while (getline(file, line)) {
-    if (line[0] != '#' && line.length() != 0) {
-      for (size_t i = 0; i < line.length(); i++) {
-        if (line[i] == 32) {
-          hashi->_numbers[linenr][i] = 0;
-        } else if (line[i] < 32 || line[i] > 56) {
-          std::cerr << "Error reading the input file. Does it have the correct "
-          "format? \n";
-        } else {
-          hashi->_numbers[linenr][i] = line[i] - '0';
-        }
-      }
-      linenr++;
-    }
+// ____________________________________________________________________________
+bool FileInterpreter::setFieldPlain(Hashi* hashi, std::string* error)
+const {
+  std::ifstream file(_inputFile);
+  if (!file.is_open()) {
+    *error = std::string("Error opening input file: ") + _inputFile;
+    return false;
   }
+  if (!readFieldPlain(&file, &hashi->_numbers, error)) {
+    return false;
+  }
+  hashi->_max_y = hashi->_numbers.size();
+  hashi->_max_x = hashi->_max_y > 0 ? hashi->_numbers[0].size() : 0;
+  return true;
 }
 
 // ____________________________________________________________________________
 void FileInterpreter::setSolution(Hashi* hashi) const {
   std::ifstream file(_solutionFile);
-  if (!file.is_open()) {
+  if (!file.is_open() || !readSolution(&file, &hashi->_sol)) {
     // program should continue even if the solution file is not valid.
+    hashi->_sol.clear();
     hashi->_solutionFile = "";
+    return;
   }
 
-  // read file
+  // set the _solutionFile name for the Hashi class
+  hashi->_solutionFile = _solutionFile;
+}
+
+// ____________________________________________________________________________
+bool FileInterpreter::readPuzzle(const std::string& file,
+ std::vector< std::vector<int> >* numbers) {
+  // a directory opens as an empty stream
+  struct stat info;
+  if (stat(file.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+    return false;
+  }
+  std::ifstream in(file.c_str());
+  std::string error;
+  if (!in.is_open()) {
+    return false;
+  }
+  if (file.size() > 6 && file.compare(file.size() - 6, 6, ".plain") == 0) {
+    return readFieldPlain(&in, numbers, &error);
+  }
+  return readFieldxy(&in, numbers, &error);
+}
+
+// ____________________________________________________________________________
+bool FileInterpreter::readFieldxy(std::istream* in,
+ std::vector< std::vector<int> >* numbers, std::string* error,
+ const LoadLimits& limits) {
+  numbers->clear();
+  // collect the isles, the size of the matrix is known afterwards
+  std::vector<int> isles;
+  int maxX = -1;
+  int maxY = -1;
+  int64_t budget = limits.maxBytes;
   std::string line;
-  int coordList[4];
-  while (getline(file, line)) {
-    std::stringstream ss(line);
-    if (line[0] != '#' && line.length() != 0) {
-      for (int i = 0; i < 4; i++) {
-        getline(ss, line, ',');
-        try {
-          coordList[i] = std::stoi(line);
-        }
-        catch (std::exception& e) {
-          // continue without solution file
-          hashi->_solutionFile = "";
-        }
+  int read;
+  while ((read = readLine(in, &line, &budget)) > 0) {
+    if (line.length() == 0 || line[0] == '#') {continue; }
+    // three fields "x,y,value", only spaces may follow the value
+    const char* text = line.c_str();
+    long coordList[3];  // NOLINT
+    for (int i = 0; i < 3; i++) {
+      char* end;
+      coordList[i] = strtol(text, &end, 10);
+      while (end != text && *end == ' ') {end++; }
+      if (end == text || (i < 2 && *end != ',')
+          || (i == 2 && *end != '\0')) {
+        *error = "Error reading the input file. Does it have the correct "
+         "format? ";
+        return false;
       }
-      // add the row to the matrix
-      hashi->_sol.push_back
-       ({coordList[0], coordList[1], coordList[2], coordList[3]});
+      text = end + 1;
+    }
+    if (coordList[0] < 0 || coordList[1] < 0) {
+      *error = "Error reading the input file. Negative coordinates.";
+      return false;
+    }
+    if (coordList[0] >= limits.maxWidth || coordList[1] >= limits.maxHeight) {
+      *error = "The puzzle is too large.";
+      return false;
     }
+    // the same isle values as in a .plain file
+    if (coordList[2] < 1 || coordList[2] > 8) {
+      *error = "Error reading the input file. An isle value is not 1 to 8.";
+      return false;
+    }
+    if (static_cast<int>(isles.size()) / 3 >= limits.maxIsles) {
+      *error = "The puzzle has too many isles.";
+      return false;
+    }
+    for (int i = 0; i < 3; i++) {
+      isles.push_back(coordList[i]);
+    }
+    maxX = std::max(maxX, isles[isles.size() - 3]);
+    maxY = std::max(maxY, isles[isles.size() - 2]);
+  }
+  if (read < 0) {
+    *error = "The input file is too large.";
+    return false;
+  }
+  if (isles.empty()) {
+    *error = "The input file holds no isles.";
+    return false;
   }
 
-  // set the _solutionFile name for the Hashi class
-  hashi->_solutionFile = _solutionFile;
+  // Consider that the index of _numbers starts with 0.
+  numbers->assign(maxY + 1, std::vector<int>(maxX + 1));
+  for (unsigned int i = 0; i < isles.size(); i += 3) {
+    // write numb in the given y,x position in the _numbers matrix
+    (*numbers)[isles[i + 1]][isles[i]] = isles[i + 2];
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool FileInterpreter::readFieldPlain(std::istream* in,
+ std::vector< std::vector<int> >* numbers, std::string* error,
+ const LoadLimits& limits) {
+  numbers->clear();
+  int64_t budget = limits.maxBytes;
+  int isles = 0;
+  std::string line;
+  int read;
+  while ((read = readLine(in, &line, &budget)) > 0) {
+    if (line.length() == 0 || line[0] == '#') {continue; }
+    if (numbers->size() > 0 && line.length() != (*numbers)[0].size()) {
+      *error = "The lines of the input file do not have the same "
+       "length! Consider deleting redundant spaces at the end of the "
+       "lines.";
+      numbers->clear();
+      return false;
+    }
+    if (static_cast<int>(line.length()) > limits.maxWidth
+        || static_cast<int>(numbers->size()) >= limits.maxHeight) {
+      *error = "The puzzle is too large.";
+      numbers->clear();
+      return false;
+    }
+    // read the line char by char
+    numbers->push_back(std::vector<int>(line.length()));
+    for (size_t i = 0; i < line.length(); i++) {
+      if (line[i] >= '1' && line[i] <= '8') {
+        numbers->back()[i] = line[i] - '0';
+        isles++;
+      } else if (line[i] != ' ' && line[i] != '0') {
+        *error = "Error reading the input file. Does it have the correct "
+         "format? ";
+        numbers->clear();
+        return false;
+      }
+    }
+    if (isles > limits.maxIsles) {
+      *error = "The puzzle has too many isles.";
+      numbers->clear();
+      return false;
+    }
+  }
+  if (read < 0) {
+    *error = "The input file is too large.";
+    numbers->clear();
+    return false;
+  }
+  if (isles == 0) {
+    *error = "The input file holds no isles.";
+    numbers->clear();
+    return false;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+int FileInterpreter::readLine(std::istream* in, std::string* line,
+ int64_t* budget) {
+  line->clear();
+  char c;
+  if (!in->get(c)) {return 0; }
+  while (true) {
+    if (--(*budget) < 0) {return -1; }
+    if (c == '\n') {break; }
+    line->push_back(c);
+    if (!in->get(c)) {break; }
+  }
+  // the line break of a CRLF file
+  if (!line->empty() && (*line)[line->size() - 1] == '\r') {
+    line->resize(line->size() - 1);
+  }
+  return 1;
+}
+
+// ____________________________________________________________________________
+bool FileInterpreter::readSolution(std::istream* in,
+ std::vector<Bridge>* solution, const LoadLimits& limits) {
+  solution->clear();
+  int64_t budget = limits.maxBytes;
+  std::string line;
+  int read;
+  while ((read = readLine(in, &line, &budget)) > 0) {
+    if (line.length() == 0 || line[0] == '#') {continue; }
+    // parse the line in place, the coordinates have to fit 16 bits
+    const char* text = line.c_str();
+    long coordList[4];  // NOLINT
+    for (int i = 0; i < 4; i++) {
+      char* end;
+      coordList[i] = strtol(text, &end, 10);
+      while (end != text && *end == ' ') {end++; }
+      // the last coordinate ends the line
+      if (end == text || coordList[i] < INT16_MIN || coordList[i] > INT16_MAX
+          || (i < 3 && *end != ',')
+          || (i == 3 && *end != '\0')) {
+        return false;
+      }
+      text = end + 1;
+    }
+    Bridge bridge(coordList[0], coordList[1], coordList[2], coordList[3], 1);
+    // a repeated line draws the same bridge again
+    if (!solution->empty() && solution->back().sameIsles(bridge)
+        && solution->back().count < INT16_MAX) {
+      solution->back().count++;
+    } else {
+      solution->push_back(bridge);
+    }
+  }
+  if (read < 0) {
+    solution->clear();
+    return false;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+void FileInterpreter::writeSolution(std::ostream* out,
+ const std::vector<Bridge>& solution) {
+  for (unsigned int i = 0; i < solution.size(); i++) {
+    for (int j = 0; j < solution[i].count; j++) {
+      *out << solution[i].x1 << "," << solution[i].y1 << ","
+       << solution[i].x2 << "," << solution[i].y2 << "\n";
+    }
+  }
 }
@@ -5,6 +5,13 @@
 #define FILEINTERPRETER_H_
 
 #include <gtest/gtest.h>
+#include <stdint.h>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "./Bridge.h"
+#include "./LoadLimits.h"
 #include "Hashi.h"
 
 class Hashi;
@@ -20,24 +27,143 @@ class FileInterpreter {
   FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsNoArguments);
   FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsArguments);
   FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsArgumentsSetUndos);
+  FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsSetThreads);
+  FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsSetCache);
+  FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsSetSave);
+  FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsPlaylist);
+  FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsGames);
+  FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsTiming);
+  FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsBuiltin);
+  FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsSolver);
+
+  // Stop with the usage information if the input file has neither the .xy
+  // nor the .plain format (a playlist is checked while it is loaded, a
+  // built-in puzzle needs no input file).
+  void checkInputFormat() const;
 
   // Process the command line arguments by calling the
   // matching private set-function below. If the input file is
-  // invalid, the program stops and shows a error message.
+  // invalid, false is returned with an error message.
   // If the solution file is invalid, the program continues
-  // without it.
-  void processFiles(Hashi* hashi) const;
+  // without it. Without a valid solution file, the solution is
+  // taken from the solution cache (if given). A save file that belongs
+  // to the input file is resumed.
+  bool processFiles(Hashi* hashi, std::string* error) const;
   FRIEND_TEST(FileInterpreter, processFiles);
+  FRIEND_TEST(FileInterpreter, processFilesPlaylist);
+
+  // Returns: bool - true if the solve service, the pipeline or the game
+  //                 server was requested by the --serve, --socket,
+  //                 --pipeline or --games option (no game in the terminal)
+  bool isServiceMode() const {
+    return _serve || _pipeline || _socketFile[0] != '\0'
+        || _gameAddress[0] != '\0';
+  }
+
+  // Returns: bool - true if the phases of the startup should be reported
+  //                 (the --timing option)
+  bool timing() const { return _timing; }
+
+  // Run the Pipeline or the SolveService until the input ends (--pipeline,
+  // --serve) or forever (--socket), or the GameServer forever (--games).
+  void runService() const;
+  FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsService);
+  FRIEND_TEST(FileInterpreter, processFilesCache);
+
+  // Read a number field in the .xy format (lines "x,y,value").
+  // Arguments:
+  //   std::istream* in - the input
+  //   std::vector< std::vector<int> >* numbers - receives the field in the
+  //     format of the Hashi _numbers matrix
+  //   std::string* error - receives the error message
+  //   const LoadLimits& limits - the input is rejected as soon as it
+  //     exceeds one of them
+  // Returns:
+  //   bool - false if the input is invalid or holds no isle (numbers is
+  //     empty then)
+  static bool readFieldxy(std::istream* in,
+   std::vector< std::vector<int> >* numbers, std::string* error,
+   const LoadLimits& limits = LoadLimits());
+  FRIEND_TEST(FileInterpreter, readFieldxy);
+  FRIEND_TEST(FileInterpreter, readFieldFuzz);
+
+  // Read a number field in the .plain format (one line per row).
+  // (see readFieldxy() for the arguments)
+  static bool readFieldPlain(std::istream* in,
+   std::vector< std::vector<int> >* numbers, std::string* error,
+   const LoadLimits& limits = LoadLimits());
+  FRIEND_TEST(FileInterpreter, readFieldPlain);
+
+  // Read a puzzle file, the .plain format is chosen by the file name
+  // extension, any other file is read in the .xy format.
+  // Returns:
+  //   bool - false if the file is no regular file, can't be read or is
+  //     invalid
+  static bool readPuzzle(const std::string& file,
+   std::vector< std::vector<int> >* numbers);
+  FRIEND_TEST(FileInterpreter, readPuzzle);
+
+  // Read a solution in the .xy.solution format (lines "x1,y1,x2,y2", nothing
+  // but spaces may follow the last coordinate).
+  // Repeated lines are merged into one Bridge with a higher count.
+  // Arguments:
+  //   std::istream* in - the input
+  //   std::vector<Bridge>* solution - receives the bridges (see Hashi _sol)
+  //   const LoadLimits& limits - only maxBytes applies
+  // Returns:
+  //   bool - false if the input is invalid or longer than maxBytes
+  static bool readSolution(std::istream* in, std::vector<Bridge>* solution,
+   const LoadLimits& limits = LoadLimits());
+
+  // Read the next line (without the line break, LF or CRLF) from the input,
+  // every byte counts against the budget, so a reader of untrusted input
+  // never holds more than its LoadLimits::maxBytes.
+  // Returns:
+  //   int - 1 if a line was read, 0 at the end of the input, -1 if the
+  //     budget ran out before the end of the line
+  static int readLine(std::istream* in, std::string* line, int64_t* budget);
+
+  // Write a solution in the .xy.solution format (see readSolution()), a
+  // Bridge is written count times.
+  static void writeSolution(std::ostream* out,
+   const std::vector<Bridge>& solution);
+  FRIEND_TEST(FileInterpreter, writeSolution);
 
  private:
   // Name of the input file.
   const char* _inputFile;
   // Name of the solution file.
   const char* _solutionFile;
+  // Name of the solution cache file.
+  const char* _cacheFile;
+  // Name of the save file (autosave and resume, "" for none).
+  const char* _saveFile;
+  // Run the solve service on stdin / stdout instead of the game.
+  bool _serve;
+  // Run the solve service on this Unix domain socket ("" for none).
+  const char* _socketFile;
+  // Solve a stream of puzzles from stdin instead of playing.
+  bool _pipeline;
+  // Host the games of the _gameFiles on this TCP port of 127.0.0.1 or
+  // Unix domain socket ("" for none).
+  const char* _gameAddress;
+  std::vector<std::string> _gameFiles;
+  // The sources of a playlist (empty for a single input file).
+  std::vector<std::string> _playlistSources;
+  // Report the phases of the startup.
+  bool _timing;
+  // The built-in puzzle to play (counted from 1, 0 for none).
+  int _builtin;
 
   // The allowed amount of undo operations
   int _undoOperations;
 
+  // The amount of worker threads used to solve the puzzle
+  int _threads;
+
+  // Solve with the ClauseSolver instead of the RegionSolver (--solver)
+  bool _clauseSolver;
+
   // Print errors and usage information when the programm is called with
   // the wrong parameters
   void printUsageAndExit() const;
@@ -54,13 +180,16 @@ class FileInterpreter {
 
   // Sets the initial array values for the game according to
   // a .xy input file.
-  void setFieldxy(Hashi* hashi) const;
+  // Returns:
+  //   bool - false if the file can't be read or is invalid, the error
+  //     message is written to error
+  bool setFieldxy(Hashi* hashi, std::string* error) const;
   FRIEND_TEST(FileInterpreter, setFieldxy);
   FRIEND_TEST(FileInterpreter, readInvalidFilexy);
 
   // Sets the initial array values for the game according to
-  // a .plain input file.
-  void setFieldPlain(Hashi* hashi) const;
+  // a .plain input file (see setFieldxy()).
+  bool setFieldPlain(Hashi* hashi, std::string* error) const;
   FRIEND_TEST(FileInterpreter, setFieldPlain);
   FRIEND_TEST(FileInterpreter, readInvalidFilePlain);
 
@@ -68,6 +197,16 @@ class FileInterpreter {
   // to a .xy.solution input file.
   void setSolution(Hashi* hashi) const;
   FRIEND_TEST(FileInterpreter, setSolution);
+
+  // Sets the first puzzle of a playlist of the _playlistSources and hands
+  // the playlist to the game (the solution option is ignored, every puzzle
+  // brings its own solution file). See setFieldxy() for the result.
+  bool setPlaylist(Hashi* hashi, std::string* error) const;
+
+  // Sets the field and the solution of the built-in puzzle _builtin (no
+  // file is read). See setFieldxy() for the result.
+  bool setBuiltin(Hashi* hashi, std::string* error) const;
+  FRIEND_TEST(FileInterpreter, processFilesBuiltin);
 };
 
 #endif  // FILEINTERPRETER_H_
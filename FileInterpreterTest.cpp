@@ -2,7 +2,14 @@
 // Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
 
 #include <gtest/gtest.h>
+#include <string.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
 #include "./FileInterpreter.h"
+#include "./SaveGame.h"
+#include "./SolutionCache.h"
 
 // _____________________________________________________________________________
 TEST(FileInterpreter, constructor) {
@@ -82,7 +89,9 @@ TEST(FileInterpreter, processFiles) {
   };
   test7.parseCommandLineArguments(argc, argv);
   ::testing::FLAGS_gtest_death_test_style = "threadsafe";
-  ASSERT_DEATH(test7.processFiles(&gametest7), "<inputfile> has to have .*");
+  std::string error;
+  ASSERT_DEATH(test7.processFiles(&gametest7, &error),
+   "<inputfile> has to have .*");
 }
 
 // _____________________________________________________________________________
@@ -96,7 +105,8 @@ TEST(FileInterpreter, setFieldxy) {
                  "4,4,2\n");
   fclose(input);
   test8._inputFile = "thisIsATest.xy";
-  test8.setFieldxy(&gametest8);
+  std::string error;
+  ASSERT_TRUE(test8.setFieldxy(&gametest8, &error));
   ASSERT_EQ(5, gametest8._max_x);
   ASSERT_EQ(5, gametest8._max_y);
   ASSERT_EQ(3, gametest8._numbers[4][0]);
@@ -108,8 +118,9 @@ TEST(FileInterpreter, setFieldxy) {
 TEST(FileInterpreter, readInvalidFilexy) {
   FileInterpreter test9;
   Hashi gametest9;
-  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
-  ASSERT_DEATH(test9.setFieldxy(&gametest9), "Error opening .*");
+  std::string error;
+  ASSERT_FALSE(test9.setFieldxy(&gametest9, &error));
+  ASSERT_EQ(0, error.find("Error opening"));
 }
 
 // _____________________________________________________________________________
@@ -125,7 +136,8 @@ TEST(FileInterpreter, setFieldPlain) {
                  "3   2");
   fclose(input);
   test10._inputFile = "thisIsATest.plain";
-  test10.setFieldPlain(&gametest10);
+  std::string error;
+  ASSERT_TRUE(test10.setFieldPlain(&gametest10, &error));
   ASSERT_EQ(5, gametest10._max_x);
   ASSERT_EQ(5, gametest10._max_y);
   ASSERT_EQ(3, gametest10._numbers[4][0]);
@@ -137,8 +149,9 @@ TEST(FileInterpreter, setFieldPlain) {
 TEST(FileInterpreter, readInvalidFilePlain) {
   FileInterpreter test11;
   Hashi gametest11;
-  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
-  ASSERT_DEATH(test11.setFieldxy(&gametest11), "Error opening .*");
+  std::string error;
+  ASSERT_FALSE(test11.setFieldPlain(&gametest11, &error));
+  ASSERT_EQ(0, error.find("Error opening"));
 }
 
 // _____________________________________________________________________________
@@ -154,8 +167,485 @@ TEST(FileInterpreter, setSolution) {
   test12._solutionFile = "thisIsATest.xy.solution";
   test12.setSolution(&gametest12);
   ASSERT_EQ(4, gametest12._sol.size());
-  ASSERT_EQ(8, gametest12._sol[1][3]);
-  ASSERT_EQ(11, gametest12._sol[2][2]);
+  ASSERT_EQ(8, gametest12._sol[1].y2);
+  ASSERT_EQ(11, gametest12._sol[2].x2);
+  ASSERT_EQ(1, gametest12._sol[2].count);
   ASSERT_STREQ("thisIsATest.xy.solution", gametest12._solutionFile);
   unlink("thisIsATest.xy.solution");
 }
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, parseCommandLineArgumentsSetThreads) {
+  FileInterpreter test13;
+  int argc = 4;
+  char* argv[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--threads"),
+    const_cast<char*>("8"),
+    const_cast<char*>("myInputFile")
+  };
+  ASSERT_EQ(1, test13._threads);
+  test13.parseCommandLineArguments(argc, argv);
+  ASSERT_STREQ("myInputFile", test13._inputFile);
+  ASSERT_EQ(8, test13._threads);
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, parseCommandLineArgumentsTiming) {
+  FileInterpreter test19;
+  int argc = 3;
+  char* argv[3] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--timing"),
+    const_cast<char*>("myInputFile.xy")
+  };
+  ASSERT_FALSE(test19.timing());
+  test19.parseCommandLineArguments(argc, argv);
+  ASSERT_STREQ("myInputFile.xy", test19._inputFile);
+  ASSERT_TRUE(test19.timing());
+  test19.parseCommandLineArguments(2, argv + 1);
+  ASSERT_FALSE(test19.timing());
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, parseCommandLineArgumentsBuiltin) {
+  FileInterpreter test20;
+  int argc = 3;
+  char* argv[3] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--builtin"),
+    const_cast<char*>("2")
+  };
+  ASSERT_EQ(0, test20._builtin);
+  // no input file is needed
+  test20.parseCommandLineArguments(argc, argv);
+  ASSERT_EQ(2, test20._builtin);
+  ASSERT_STREQ("", test20._inputFile);
+  argv[2] = const_cast<char*>("0");
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_DEATH(test20.parseCommandLineArguments(argc, argv), "Usage: .*");
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, parseCommandLineArgumentsSolver) {
+  FileInterpreter test22;
+  Hashi gametest22;
+  int argc = 4;
+  char* argv[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--solver"),
+    const_cast<char*>("clause"),
+    const_cast<char*>("instances/i001-n002-s03x01.xy")
+  };
+  test22.parseCommandLineArguments(argc, argv);
+  ASSERT_TRUE(test22._clauseSolver);
+  std::string error;
+  ASSERT_TRUE(test22.processFiles(&gametest22, &error));
+  ASSERT_TRUE(gametest22._clauseSolver);
+  argv[2] = const_cast<char*>("region");
+  test22.parseCommandLineArguments(argc, argv);
+  ASSERT_FALSE(test22._clauseSolver);
+  argv[2] = const_cast<char*>("sat");
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  ASSERT_DEATH(test22.parseCommandLineArguments(argc, argv), "Usage: .*");
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, processFilesBuiltin) {
+  FileInterpreter test21;
+  Hashi gametest21;
+  int argc = 3;
+  char* argv[3] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--builtin"),
+    const_cast<char*>("2")
+  };
+  test21.parseCommandLineArguments(argc, argv);
+  std::string error;
+  ASSERT_TRUE(test21.processFiles(&gametest21, &error));
+  // the second puzzle of instances/ with its solution
+  std::vector< std::vector<int> > numbers;
+  ASSERT_TRUE(FileInterpreter::readPuzzle("instances/i002-n003-s04x06.xy",
+      &numbers));
+  ASSERT_EQ(numbers, gametest21._numbers);
+  ASSERT_EQ(4, gametest21._max_x);
+  ASSERT_EQ(6, gametest21._max_y);
+  ASSERT_FALSE(gametest21._sol.empty());
+
+  argv[2] = const_cast<char*>("100000");
+  test21.parseCommandLineArguments(argc, argv);
+  ASSERT_FALSE(test21.processFiles(&gametest21, &error));
+  ASSERT_EQ(0, error.find("There is no built-in puzzle 100000"));
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, parseCommandLineArgumentsSetCache) {
+  FileInterpreter test14;
+  int argc = 4;
+  char* argv[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--cache"),
+    const_cast<char*>("myCache"),
+    const_cast<char*>("myInputFile")
+  };
+  ASSERT_STREQ("", test14._cacheFile);
+  test14.parseCommandLineArguments(argc, argv);
+  ASSERT_STREQ("myCache", test14._cacheFile);
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, processFilesCache) {
+  FILE* input = fopen("thisIsATest.xy", "w");
+  fprintf(input, "0,0,4\n"
+                 "3,0,3\n"
+                 "0,2,2\n"
+                 "3,2,1\n");
+  fclose(input);
+  unlink("thisIsATest.cache");
+  std::vector<Bridge> solution = {{0, 0, 3, 0, 2}, {0, 0, 0, 2, 2},
+                                   {3, 0, 3, 2, 1}};
+  {
+    SolutionCache cache("thisIsATest.cache");
+    cache.insert({{4, 0, 0, 3},
+                  {0, 0, 0, 0},
+                  {2, 0, 0, 1}}, solution);
+  }
+  FileInterpreter test15;
+  Hashi gametest15;
+  int argc = 4;
+  char* argv[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--cache"),
+    const_cast<char*>("thisIsATest.cache"),
+    const_cast<char*>("thisIsATest.xy")
+  };
+  test15.parseCommandLineArguments(argc, argv);
+  std::string error;
+  ASSERT_TRUE(test15.processFiles(&gametest15, &error));
+  ASSERT_EQ(solution, gametest15._sol);
+  ASSERT_STREQ("thisIsATest.cache", gametest15._cacheFile);
+  unlink("thisIsATest.xy");
+  unlink("thisIsATest.cache");
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, parseCommandLineArgumentsSetSave) {
+  FileInterpreter test16;
+  int argc = 4;
+  char* argv[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--save"),
+    const_cast<char*>("mySave"),
+    const_cast<char*>("myInputFile")
+  };
+  ASSERT_STREQ("", test16._saveFile);
+  test16.parseCommandLineArguments(argc, argv);
+  ASSERT_STREQ("mySave", test16._saveFile);
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, writeSolution) {
+  std::vector<Bridge> solution = {{0, 0, 3, 0, 2}, {0, 0, 0, 2, 1}};
+  std::stringstream out;
+  FileInterpreter::writeSolution(&out, solution);
+  ASSERT_EQ("0,0,3,0\n0,0,3,0\n0,0,0,2\n", out.str());
+  // repeated lines are merged again
+  std::vector<Bridge> read;
+  ASSERT_TRUE(FileInterpreter::readSolution(&out, &read));
+  ASSERT_EQ(solution, read);
+  // coordinates have to fit 16 bits
+  std::stringstream large("0,0,70000,0\n");
+  ASSERT_FALSE(FileInterpreter::readSolution(&large, &read));
+  std::stringstream missing("0,0,3\n");
+  ASSERT_FALSE(FileInterpreter::readSolution(&missing, &read));
+  // nothing may follow the last coordinate but spaces
+  std::stringstream trailing("0,0,3,0xyz\n");
+  ASSERT_FALSE(FileInterpreter::readSolution(&trailing, &read));
+  std::stringstream fifth("0,0,3,0,7\n");
+  ASSERT_FALSE(FileInterpreter::readSolution(&fifth, &read));
+  std::stringstream spaces("0, 0, 3, 0  \r\n0,0,0,2\n");
+  ASSERT_TRUE(FileInterpreter::readSolution(&spaces, &read));
+  ASSERT_EQ(2, read.size());
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, readFieldxy) {
+  std::vector< std::vector<int> > numbers;
+  std::string error;
+  std::stringstream valid("# 4:3\n0,0,4\n3,0,3\n0,2,2\n3,2,1\n");
+  ASSERT_TRUE(FileInterpreter::readFieldxy(&valid, &numbers, &error));
+  ASSERT_EQ(std::vector< std::vector<int> >({{4, 0, 0, 3},
+                                             {0, 0, 0, 0},
+                                             {2, 0, 0, 1}}), numbers);
+  // a single line must not allocate a huge field
+  std::stringstream huge("0,0,1\n100000,100000,1\n");
+  ASSERT_FALSE(FileInterpreter::readFieldxy(&huge, &numbers, &error));
+  ASSERT_EQ("The puzzle is too large.", error);
+  ASSERT_TRUE(numbers.empty());
+  std::stringstream negative("0,-1,1\n");
+  ASSERT_FALSE(FileInterpreter::readFieldxy(&negative, &numbers, &error));
+  // isle values 1 to 8 like in a .plain file, nothing after the value
+  const char* invalid[] = {"0,0,12\n", "0,0,-3\n", "0,0,9\n", "0,0,0\n",
+                           "0,0,3abc\n", "0,0,3,4\n", "0,0\n", "0,,3\n"};
+  for (unsigned int i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+    std::stringstream in(invalid[i]);
+    ASSERT_FALSE(FileInterpreter::readFieldxy(&in, &numbers, &error))
+        << invalid[i];
+  }
+  std::stringstream spaces("0, 0, 3  \r\n2,0,3\n");
+  ASSERT_TRUE(FileInterpreter::readFieldxy(&spaces, &numbers, &error));
+  ASSERT_EQ(std::vector< std::vector<int> >({{3, 0, 3}}), numbers);
+  // a file without isles is no puzzle
+  std::stringstream empty("");
+  ASSERT_FALSE(FileInterpreter::readFieldxy(&empty, &numbers, &error));
+  ASSERT_EQ("The input file holds no isles.", error);
+  std::stringstream comments("# 4:3\n\n");
+  ASSERT_FALSE(FileInterpreter::readFieldxy(&comments, &numbers, &error));
+  ASSERT_TRUE(numbers.empty());
+
+  // the limits are checked while reading
+  LoadLimits limits;
+  limits.maxWidth = 4;
+  limits.maxHeight = 2;
+  valid.clear();
+  valid.seekg(0);
+  ASSERT_FALSE(FileInterpreter::readFieldxy(&valid, &numbers, &error,
+   limits));
+  ASSERT_EQ("The puzzle is too large.", error);
+  limits.maxHeight = 3;
+  limits.maxIsles = 3;
+  valid.clear();
+  valid.seekg(0);
+  ASSERT_FALSE(FileInterpreter::readFieldxy(&valid, &numbers, &error,
+   limits));
+  ASSERT_EQ("The puzzle has too many isles.", error);
+  limits.maxIsles = 4;
+  limits.maxBytes = 40;
+  std::string text(1000000, '#');
+  std::stringstream large(text);
+  ASSERT_FALSE(FileInterpreter::readFieldxy(&large, &numbers, &error,
+   limits));
+  ASSERT_EQ("The input file is too large.", error);
+  // the rest of the input isn't read
+  ASSERT_GE(41, large.tellg());
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, readFieldPlain) {
+  std::vector< std::vector<int> > numbers;
+  std::string error;
+  std::stringstream valid("# 4:3\n4  3\n    \n2  1\n");
+  ASSERT_TRUE(FileInterpreter::readFieldPlain(&valid, &numbers, &error));
+  ASSERT_EQ(std::vector< std::vector<int> >({{4, 0, 0, 3},
+                                             {0, 0, 0, 0},
+                                             {2, 0, 0, 1}}), numbers);
+  // invalid characters reject the whole file
+  std::stringstream invalid("4  3\n x  \n2  1\n");
+  ASSERT_FALSE(FileInterpreter::readFieldPlain(&invalid, &numbers, &error));
+  ASSERT_TRUE(numbers.empty());
+  std::stringstream unequal("4  3\n   \n2  1\n");
+  ASSERT_FALSE(FileInterpreter::readFieldPlain(&unequal, &numbers, &error));
+  // line breaks like in a .xy file
+  std::stringstream crlf("4  3\r\n    \r\n2  1\r\n");
+  ASSERT_TRUE(FileInterpreter::readFieldPlain(&crlf, &numbers, &error));
+  ASSERT_EQ(std::vector< std::vector<int> >({{4, 0, 0, 3},
+                                             {0, 0, 0, 0},
+                                             {2, 0, 0, 1}}), numbers);
+  // a file without isles is no puzzle
+  std::stringstream empty("");
+  ASSERT_FALSE(FileInterpreter::readFieldPlain(&empty, &numbers, &error));
+  ASSERT_EQ("The input file holds no isles.", error);
+  std::stringstream water("   \n   \n");
+  ASSERT_FALSE(FileInterpreter::readFieldPlain(&water, &numbers, &error));
+  ASSERT_TRUE(numbers.empty());
+
+  LoadLimits limits;
+  limits.maxWidth = 3;
+  valid.clear();
+  valid.seekg(0);
+  ASSERT_FALSE(FileInterpreter::readFieldPlain(&valid, &numbers, &error,
+   limits));
+  ASSERT_EQ("The puzzle is too large.", error);
+  limits.maxWidth = 4;
+  limits.maxIsles = 3;
+  valid.clear();
+  valid.seekg(0);
+  ASSERT_FALSE(FileInterpreter::readFieldPlain(&valid, &numbers, &error,
+   limits));
+  ASSERT_EQ("The puzzle has too many isles.", error);
+  // a line without end
+  limits.maxBytes = 40;
+  std::string text(1000000, ' ');
+  std::stringstream large(text);
+  ASSERT_FALSE(FileInterpreter::readFieldPlain(&large, &numbers, &error,
+   limits));
+  ASSERT_EQ("The input file is too large.", error);
+  ASSERT_GE(41, large.tellg());
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, readFieldFuzz) {
+  // random mutations of valid files (.xy, .plain, .xy.solution and save
+  // files), with random digits, separators, line breaks and long numbers
+  const char* kBytes = "0123456789,,,-\n\n #x";
+  const char* kBases[4] = {"0,0,4\n3,0,3\n0,2,2\n3,2,1\n",
+                           "4  3\n    \n2  1\n",
+                           "0,0,3,0\n0,0,3,0\n0,0,0,2\n",
+                           "puzzle 7\nelapsed 1.5\nbridges 2\n0,0,3,0\n"
+                           "0,0,3,0\nundos 2\n0,0,0,0\n0,0,3,0\n"};
+  LoadLimits limits;
+  limits.maxWidth = 20;
+  limits.maxHeight = 10;
+  limits.maxIsles = 12;
+  limits.maxBytes = 200;
+  std::mt19937 random(42);
+  for (int round = 0; round < 8000; round++) {
+    int format = round % 4;
+    bool plain = format == 1;
+    std::string text = kBases[format];
+    int mutations = 1 + random() % 4;
+    for (int m = 0; m < mutations; m++) {
+      int at = random() % (text.size() + 1);
+      switch (random() % 4) {
+        case 0:
+          text.insert(at, 1, kBytes[random() % strlen(kBytes)]);
+          break;
+        case 1:
+          if (at < static_cast<int>(text.size())) {text.erase(at, 1); }
+          break;
+        case 2:
+          // mostly small numbers
+          text.insert(at,
+           std::to_string(random() % (round % 3 ? 20 : 100000)));
+          break;
+        default:
+          // repeat a part of the file
+          text.insert(at, text.substr(random() % text.size(), random() % 64));
+      }
+    }
+    std::stringstream in(text);
+    if (format >= 2) {
+      // no more than the byte budget is read
+      std::vector<Bridge> bridges;
+      GameSnapshot snapshot;
+      bool valid = format == 2
+          ? FileInterpreter::readSolution(&in, &bridges, limits)
+          : SaveGame::read(&in, &snapshot, limits);
+      in.clear();
+      int64_t consumed = in.tellg();
+      ASSERT_GE(limits.maxBytes + 1, consumed) << text;
+      if (valid) {
+        ASSERT_GE(limits.maxBytes, consumed) << text;
+      }
+      continue;
+    }
+    std::vector< std::vector<int> > numbers;
+    std::string error;
+    bool valid = plain
+        ? FileInterpreter::readFieldPlain(&in, &numbers, &error, limits)
+        : FileInterpreter::readFieldxy(&in, &numbers, &error, limits);
+    // the field never exceeds the limits, a rejected one is empty
+    if (!valid) {
+      ASSERT_TRUE(numbers.empty()) << text;
+      ASSERT_FALSE(error.empty()) << text;
+      continue;
+    }
+    ASSERT_GE(limits.maxHeight, static_cast<int>(numbers.size())) << text;
+    int isles = 0;
+    for (unsigned int y = 0; y < numbers.size(); y++) {
+      ASSERT_EQ(numbers[0].size(), numbers[y].size()) << text;
+      ASSERT_GE(limits.maxWidth, static_cast<int>(numbers[y].size()))
+          << text;
+      for (unsigned int x = 0; x < numbers[y].size(); x++) {
+        isles += numbers[y][x] != 0;
+      }
+    }
+    ASSERT_GE(limits.maxIsles, isles) << text;
+    ASSERT_GE(limits.maxBytes, static_cast<int>(text.size())) << text;
+  }
+
+  // a huge solution or save file is rejected after the budget
+  std::string lines;
+  for (int i = 0; i < 100000; i++) {
+    lines += "0,0,3,0\n";
+  }
+  std::stringstream solution(lines);
+  std::vector<Bridge> bridges;
+  ASSERT_FALSE(FileInterpreter::readSolution(&solution, &bridges, limits));
+  ASSERT_TRUE(bridges.empty());
+  ASSERT_GE(limits.maxBytes + 1, solution.tellg());
+  std::stringstream save("puzzle 7\nelapsed 1\nbridges 100000\n" + lines
+      + "undos 0\n");
+  GameSnapshot snapshot;
+  ASSERT_FALSE(SaveGame::read(&save, &snapshot, limits));
+  ASSERT_GE(limits.maxBytes + 1, save.tellg());
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, readPuzzle) {
+  // the same puzzle in both formats
+  std::vector< std::vector<int> > xy;
+  std::vector< std::vector<int> > plain;
+  ASSERT_TRUE(FileInterpreter::readPuzzle("instances/i001-n002-s03x01.xy",
+      &xy));
+  ASSERT_TRUE(FileInterpreter::readPuzzle(
+      "instances/i001-n002-s03x01.plain", &plain));
+  ASSERT_EQ(xy, plain);
+  ASSERT_FALSE(FileInterpreter::readPuzzle("thisIsATest.missing", &xy));
+  ASSERT_FALSE(FileInterpreter::readPuzzle("instances", &xy));
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, parseCommandLineArgumentsPlaylist) {
+  FileInterpreter test17;
+  int argc = 3;
+  char* argv[3] = {
+    const_cast<char*>(""),
+    const_cast<char*>("instances/i001-n002-s03x01.xy"),
+    const_cast<char*>("instances/i002-n003-s04x06.xy")
+  };
+  test17.parseCommandLineArguments(argc, argv);
+  ASSERT_EQ(2, test17._playlistSources.size());
+  ASSERT_EQ("instances/i002-n003-s04x06.xy", test17._playlistSources[1]);
+  // a single puzzle file is no playlist, a pattern is
+  test17.parseCommandLineArguments(2, argv);
+  ASSERT_TRUE(test17._playlistSources.empty());
+  argv[1] = const_cast<char*>("instances/i00[12]*.xy");
+  test17.parseCommandLineArguments(2, argv);
+  ASSERT_EQ(1, test17._playlistSources.size());
+}
+
+// _____________________________________________________________________________
+TEST(FileInterpreter, processFilesPlaylist) {
+  FileInterpreter test18;
+  Hashi gametest18;
+  int argc = 4;
+  char* argv[4] = {
+    const_cast<char*>(""),
+    const_cast<char*>("--undos"),
+    const_cast<char*>("3"),
+    const_cast<char*>("instances/i00[12]*.xy")
+  };
+  test18.parseCommandLineArguments(argc, argv);
+  std::string error;
+  ASSERT_TRUE(test18.processFiles(&gametest18, &error));
+  ASSERT_TRUE(gametest18._playlist != NULL);
+  ASSERT_EQ(2, gametest18._playlist->size());
+  ASSERT_EQ(1, gametest18._playlist->current());
+  ASSERT_EQ(3, gametest18._max_x);
+  ASSERT_EQ(1, gametest18._max_y);
+  ASSERT_EQ(3, gametest18._undos.size());
+  ASSERT_TRUE(gametest18._checker != NULL);
+  ASSERT_TRUE(gametest18.nextPuzzle());
+  ASSERT_EQ(2, gametest18._playlist->current());
+  ASSERT_EQ(4, gametest18._max_x);
+  ASSERT_EQ(6, gametest18._max_y);
+  ASSERT_EQ(3, gametest18._undos.size());
+  ASSERT_FALSE(gametest18.nextPuzzle());
+
+  // a source without puzzles
+  argv[3] = const_cast<char*>("thisIsATest.missing/*.xy");
+  test18.parseCommandLineArguments(argc, argv);
+  ASSERT_FALSE(test18.processFiles(&gametest18, &error));
+  ASSERT_EQ(0, error.find("No .xy or .plain"));
+}
@@ -0,0 +1,242 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "./IsleGraph.h"
+
+// a simulated player
+struct Player {
+  int fd;
+  std::string buffer;
+  int puzzle;
+  // false until the board arrived
+  bool playing;
+  int remaining;
+  std::chrono::steady_clock::time_point sent;
+};
+
+// Connect to the game server (a port of 127.0.0.1 or a Unix domain socket).
+// Returns: int - the socket or -1
+int connectTo(const char* address) {
+  bool tcp = strspn(address, "0123456789") == strlen(address);
+  int fd = socket(tcp ? AF_INET : AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {return -1; }
+  int connected;
+  if (tcp) {
+    struct sockaddr_in in;
+    memset(&in, 0, sizeof(in));
+    in.sin_family = AF_INET;
+    in.sin_port = htons(atoi(address));
+    in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    connected = connect(fd, reinterpret_cast<struct sockaddr*>(&in),
+     sizeof(in));
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  } else {
+    struct sockaddr_un un;
+    memset(&un, 0, sizeof(un));
+    un.sun_family = AF_UNIX;
+    strncpy(un.sun_path, address, sizeof(un.sun_path) - 1);
+    connected = connect(fd, reinterpret_cast<struct sockaddr*>(&un),
+     sizeof(un));
+  }
+  if (connected != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// Send a request line.
+// Returns: bool - false if the connection is broken
+bool sendLine(const int fd, const std::string& line) {
+  std::string data = line + "\n";
+  return write(fd, data.data(), data.size())
+      == static_cast<ssize_t>(data.size());
+}
+
+// Parse a "board <W>:<H> <x,y,value;...>" reply into a _numbers matrix.
+// Returns: bool - false if the reply is no board
+bool readBoard(const std::string& reply,
+ std::vector< std::vector<int> >* numbers) {
+  int width;
+  int height;
+  int offset;
+  if (sscanf(reply.c_str(), "board %d:%d %n", &width, &height, &offset) != 2
+      || width <= 0 || height <= 0) {
+    return false;
+  }
+  numbers->assign(height, std::vector<int>(width));
+  std::istringstream cells(reply.substr(offset));
+  std::string cell;
+  while (getline(cells, cell, ';')) {
+    int x, y, value;
+    if (sscanf(cell.c_str(), "%d,%d,%d", &x, &y, &value) == 3
+        && x >= 0 && y >= 0 && x < width && y < height) {
+      (*numbers)[y][x] = value;
+    }
+  }
+  return true;
+}
+
+// Load generator for the game server: opens many sessions, plays random
+// moves on each of them (one request in flight per session) and reports
+// the move latency.
+int main(int argc, char** argv) {
+  if (argc != 4) {
+    fprintf(stderr, "Usage: ./GameClientMain <socket|port> <sessions> "
+     "<moves per session>\n");
+    fprintf(stderr, "Plays random moves on the game server of "
+     "./HashiMain --games <socket|port>\n");
+    return 1;
+  }
+  int sessions = std::max(1, atoi(argv[2]));
+  int moves = std::max(1, atoi(argv[3]));
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+
+  std::vector<Player> players(sessions);
+  for (int i = 0; i < sessions; i++) {
+    players[i].fd = connectTo(argv[1]);
+    if (players[i].fd < 0) {
+      fprintf(stderr, "Error connecting session %d to %s\n", i, argv[1]);
+      return 1;
+    }
+  }
+  // ask for the amount of puzzles before the sockets become non-blocking
+  char chunk[1 << 14];
+  int puzzles = 0;
+  ssize_t bytes;
+  if (!sendLine(players[0].fd, "puzzles")
+      || (bytes = read(players[0].fd, chunk, sizeof(chunk) - 1)) <= 0
+      || sscanf(std::string(chunk, bytes).c_str(), "puzzles %d", &puzzles) != 1
+      || puzzles <= 0) {
+    fprintf(stderr, "The server has no puzzles\n");
+    return 1;
+  }
+
+  int epoll = epoll_create1(0);
+  for (int i = 0; i < sessions; i++) {
+    Player& player = players[i];
+    fcntl(player.fd, F_SETFL, fcntl(player.fd, F_GETFL) | O_NONBLOCK);
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = i;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, player.fd, &event);
+    player.puzzle = i % puzzles;
+    player.playing = false;
+    player.remaining = moves;
+    sendLine(player.fd, "play " + std::to_string(player.puzzle));
+  }
+
+  // the graphs of the puzzles (the moves are chosen from their slots)
+  std::vector< std::unique_ptr<IsleGraph> > graphs(puzzles);
+  std::mt19937 random(42);
+  std::vector<double> latencies;
+  latencies.reserve(static_cast<size_t>(sessions) * moves);
+  int rejected = 0;
+  int solved = 0;
+  int active = sessions;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  struct epoll_event events[256];
+  while (active > 0) {
+    int ready = epoll_wait(epoll, events, 256, 10000);
+    if (ready <= 0) {
+      fprintf(stderr, "The server does not answer\n");
+      return 1;
+    }
+    for (int e = 0; e < ready; e++) {
+      Player& player = players[events[e].data.u32];
+      bytes = read(player.fd, chunk, sizeof(chunk));
+      if (bytes <= 0) {
+        fprintf(stderr, "Connection closed\n");
+        return 1;
+      }
+      player.buffer.append(chunk, bytes);
+      size_t end;
+      while ((end = player.buffer.find('\n')) != std::string::npos) {
+        std::string reply = player.buffer.substr(0, end);
+        player.buffer.erase(0, end + 1);
+        std::chrono::steady_clock::time_point now =
+            std::chrono::steady_clock::now();
+        if (player.playing) {
+          latencies.push_back(std::chrono::duration<double, std::micro>(
+              now - player.sent).count());
+          rejected += reply.compare(0, 5, "error") == 0;
+          solved += reply.find(" solved") != std::string::npos;
+          player.remaining--;
+        } else {
+          std::vector< std::vector<int> > numbers;
+          if (!readBoard(reply, &numbers)) {
+            fprintf(stderr, "Unexpected reply: %s\n", reply.c_str());
+            return 1;
+          }
+          if (!graphs[player.puzzle]) {
+            graphs[player.puzzle].reset(new IsleGraph(numbers));
+          }
+          player.playing = true;
+        }
+        if (player.remaining == 0) {
+          active--;
+          continue;
+        }
+        // a random bridge, now and then an undo
+        const IsleGraph& graph = *graphs[player.puzzle];
+        std::string request = "show";
+        if (random() % 8 == 0) {
+          request = "undo";
+        } else if (!graph.slots().empty()) {
+          const BridgeSlot& slot = graph.slots()[random()
+              % graph.slots().size()];
+          const Isle& a = graph.isles()[slot.a];
+          const Isle& b = graph.isles()[slot.b];
+          request = "move " + std::to_string(a.x) + "," + std::to_string(a.y)
+              + "," + std::to_string(b.x) + "," + std::to_string(b.y);
+        }
+        player.sent = std::chrono::steady_clock::now();
+        if (!sendLine(player.fd, request)) {
+          fprintf(stderr, "Error sending a move\n");
+          return 1;
+        }
+      }
+    }
+  }
+  double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  std::sort(latencies.begin(), latencies.end());
+  size_t n = latencies.size();
+  printf("%d sessions, %zu moves in %.3f s: %.0f moves/s\n", sessions, n,
+   seconds, n / seconds);
+  printf("latency p50 %.1f us, p99 %.1f us, max %.1f us (%d rejected, "
+   "%d solved)\n", latencies[n / 2], latencies[n * 99 / 100],
+   latencies[n - 1], rejected, solved);
+  for (int i = 0; i < sessions; i++) {
+    close(players[i].fd);
+  }
+  close(epoll);
+  return 0;
+}
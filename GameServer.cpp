@@ -0,0 +1,376 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./GameServer.h"
+
+namespace {
+// events handled per epoll_wait() call
+const int kEvents = 256;
+// moves a session can take back unless setUndoLimit() says otherwise
+const int kUndos = 5;
+}  // namespace
+
+// ____________________________________________________________________________
+GameServer::GameServer() {
+  _epoll = epoll_create1(EPOLL_CLOEXEC);
+  _port = 0;
+  _moves = 0;
+  _undoLimit = kUndos;
+  _stopped = false;
+  _wakeup[0] = -1;
+  _wakeup[1] = -1;
+  if (pipe2(_wakeup, O_NONBLOCK | O_CLOEXEC) == 0) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = _wakeup[0];
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, _wakeup[0], &event);
+  }
+}
+
+// ____________________________________________________________________________
+GameServer::~GameServer() {
+  for (auto it = _sessions.begin(); it != _sessions.end(); it++) {
+    close(it->first);
+  }
+  for (unsigned int i = 0; i < _listeners.size(); i++) {
+    close(_listeners[i]);
+  }
+  if (!_socketPath.empty()) {
+    unlink(_socketPath.c_str());
+  }
+  close(_wakeup[0]);
+  close(_wakeup[1]);
+  close(_epoll);
+}
+
+// ____________________________________________________________________________
+void GameServer::setUndoLimit(const int limit) {
+  _undoLimit = limit >= 0 ? limit : kUndos;
+}
+
+// ____________________________________________________________________________
+int GameServer::addPuzzle(const std::vector< std::vector<int> >& numbers) {
+  Puzzle puzzle;
+  puzzle.graph.reset(new IsleGraph(numbers));
+  const IsleGraph& graph = *puzzle.graph;
+  puzzle.board = "board " + std::to_string(graph.width()) + ":"
+      + std::to_string(graph.height()) + " ";
+  for (unsigned int i = 0; i < graph.isles().size(); i++) {
+    const Isle& isle = graph.isles()[i];
+    puzzle.board += (i > 0 ? ";" : "") + std::to_string(isle.x) + ","
+        + std::to_string(isle.y) + "," + std::to_string(isle.value);
+  }
+  _puzzles.push_back(std::move(puzzle));
+  return _puzzles.size() - 1;
+}
+
+// ____________________________________________________________________________
+bool GameServer::listenUnix(const char* path) {
+  int server = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (server < 0) {
+    return false;
+  }
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+  unlink(path);
+  if (bind(server, reinterpret_cast<struct sockaddr*>(&address),
+       sizeof(address)) != 0 || !addListener(server)) {
+    close(server);
+    return false;
+  }
+  _socketPath = path;
+  return true;
+}
+
+// ____________________________________________________________________________
+bool GameServer::listenTcp(const int port) {
+  int server = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (server < 0) {
+    return false;
+  }
+  int on = 1;
+  setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  if (bind(server, reinterpret_cast<struct sockaddr*>(&address),
+       sizeof(address)) != 0 || !addListener(server)
+      || getsockname(server, reinterpret_cast<struct sockaddr*>(&address),
+       &length) != 0) {
+    close(server);
+    return false;
+  }
+  _port = ntohs(address.sin_port);
+  return true;
+}
+
+// ____________________________________________________________________________
+bool GameServer::addListener(const int fd) {
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  if (listen(fd, SOMAXCONN) != 0
+      || epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+    return false;
+  }
+  _listeners.push_back(fd);
+  return true;
+}
+
+// ____________________________________________________________________________
+void GameServer::stop() {
+  _stopped = true;
+  char byte = 0;
+  if (write(_wakeup[1], &byte, 1) < 0) {
+    // the pipe is full, the loop is woken up already
+  }
+}
+
+// ____________________________________________________________________________
+void GameServer::run() {
+  // thousands of sessions need more descriptors than the usual soft limit
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0
+      && limit.rlim_cur < limit.rlim_max) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+  // a client that disconnects early must not kill the server
+  signal(SIGPIPE, SIG_IGN);
+
+  struct epoll_event events[kEvents];
+  while (!_stopped) {
+    int ready = epoll_wait(_epoll, events, kEvents, -1);
+    if (ready < 0 && errno != EINTR) {break; }
+    for (int i = 0; i < ready && !_stopped; i++) {
+      int fd = events[i].data.fd;
+      if (fd == _wakeup[0]) {continue; }
+      bool listener = false;
+      for (unsigned int j = 0; j < _listeners.size(); j++) {
+        listener = listener || _listeners[j] == fd;
+      }
+      if (listener) {
+        acceptAll(fd);
+        continue;
+      }
+      // the session may have been closed by an earlier event
+      auto it = _sessions.find(fd);
+      if (it == _sessions.end()) {continue; }
+      Session* session = &it->second;
+      if ((events[i].events & EPOLLOUT) && !flush(session)) {continue; }
+      if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        receive(session);
+      }
+    }
+  }
+  // drain the wake up bytes, the server may run again
+  char bytes[64];
+  while (read(_wakeup[0], bytes, sizeof(bytes)) > 0) {}
+  _stopped = false;
+}
+
+// ____________________________________________________________________________
+void GameServer::acceptAll(const int listener) {
+  while (true) {
+    int client = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (client < 0) {break; }
+    // the replies are small and awaited, don't delay them (fails
+    // harmlessly on Unix domain sockets)
+    int on = 1;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = client;
+    if (epoll_ctl(_epoll, EPOLL_CTL_ADD, client, &event) != 0) {
+      close(client);
+      continue;
+    }
+    Session& session = _sessions[client];
+    session.fd = client;
+    session.writing = false;
+    session.puzzle = -1;
+  }
+}
+
+// ____________________________________________________________________________
+bool GameServer::receive(Session* session) {
+  char chunk[1 << 14];
+  ssize_t bytes = read(session->fd, chunk, sizeof(chunk));
+  if (bytes == 0 || (bytes < 0 && errno != EAGAIN && errno != EINTR)) {
+    closeSession(session);
+    return false;
+  }
+  if (bytes < 0) {
+    return true;
+  }
+  session->in.append(chunk, bytes);
+
+  // answer the complete lines
+  size_t start = 0;
+  size_t end;
+  while ((end = session->in.find('\n', start)) != std::string::npos) {
+    size_t length = end - start;
+    if (length > 0 && session->in[end - 1] == '\r') {length--; }
+    if (length > 0) {
+      session->out += handle(session, session->in.substr(start, length));
+      session->out += '\n';
+    }
+    start = end + 1;
+  }
+  session->in.erase(0, start);
+  if (session->in.size() > kMaxLine) {
+    closeSession(session);
+    return false;
+  }
+  return flush(session);
+}
+
+// ____________________________________________________________________________
+bool GameServer::flush(Session* session) {
+  size_t written = 0;
+  while (written < session->out.size()) {
+    ssize_t n = write(session->fd, session->out.data() + written,
+     session->out.size() - written);
+    if (n < 0 && errno == EINTR) {continue; }
+    if (n < 0 && errno == EAGAIN) {break; }
+    if (n <= 0) {
+      closeSession(session);
+      return false;
+    }
+    written += n;
+  }
+  session->out.erase(0, written);
+  if (session->out.size() > kMaxOutput) {
+    // the client doesn't read its replies
+    closeSession(session);
+    return false;
+  }
+  bool writing = !session->out.empty();
+  if (writing != session->writing) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = writing ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    event.data.fd = session->fd;
+    epoll_ctl(_epoll, EPOLL_CTL_MOD, session->fd, &event);
+    session->writing = writing;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+void GameServer::closeSession(Session* session) {
+  int fd = session->fd;
+  epoll_ctl(_epoll, EPOLL_CTL_DEL, fd, NULL);
+  close(fd);
+  _sessions.erase(fd);
+}
+
+// ____________________________________________________________________________
+std::string GameServer::slotCells(const GameState& game, const int slot) {
+  const BridgeSlot& s = game.graph().slots()[slot];
+  const Isle& a = game.graph().isles()[s.a];
+  const Isle& b = game.graph().isles()[s.b];
+  int count = game.count(slot);
+  int value = count == 0 ? 0 : (s.vertical ? 11 : 9) + count;
+  std::string cells;
+  int dx = s.vertical ? 0 : 1;
+  int dy = s.vertical ? 1 : 0;
+  for (int x = a.x + dx, y = a.y + dy; x < b.x || y < b.y; x += dx, y += dy) {
+    cells += (cells.empty() ? "" : ";") + std::to_string(x) + ","
+        + std::to_string(y) + "," + std::to_string(value);
+  }
+  return cells;
+}
+
+// ____________________________________________________________________________
+std::string GameServer::handle(Session* session, const std::string& request) {
+  size_t space = request.find(' ');
+  std::string command = request.substr(0, space);
+  std::string argument = space == std::string::npos ? ""
+      : request.substr(space + 1);
+
+  if (command == "puzzles") {
+    return "puzzles " + std::to_string(_puzzles.size());
+  }
+  if (command == "play") {
+    char* end;
+    int64_t number = strtol(argument.c_str(), &end, 10);
+    if (argument.empty() || *end != '\0' || number < 0
+        || number >= static_cast<int64_t>(_puzzles.size())) {
+      return "error unknown puzzle " + argument;
+    }
+    session->puzzle = number;
+    session->game.reset(new GameState(_puzzles[number].graph.get()));
+    session->game->setHistoryLimit(_undoLimit);
+    return _puzzles[number].board;
+  }
+  if (!session->game) {
+    return "error no game, expected: play <number>";
+  }
+  GameState& game = *session->game;
+  if (command == "move") {
+    int x1, y1, x2, y2;
+    char rest;
+    if (sscanf(argument.c_str(), "%d,%d,%d,%d%c", &x1, &y1, &x2, &y2, &rest)
+        != 4) {
+      return "error expected: move x1,y1,x2,y2";
+    }
+    Move move = {game.graph().slotBetween(x1, y1, x2, y2), 0};
+    if (move.slot < 0) {
+      return "error no bridge possible";
+    }
+    // like a click in the game: single, double, none
+    move.count = (game.count(move.slot) + 1) % 3;
+    if (!game.isLegal(move)) {
+      return "error crossing bridge";
+    }
+    game.apply(move);
+    _moves++;
+    return "update " + slotCells(game, move.slot)
+        + (game.isSolved() ? " solved" : "");
+  }
+  if (command == "undo") {
+    int slot = game.lastSlot();
+    if (!game.undo()) {
+      return "error nothing to undo";
+    }
+    _moves++;
+    return "update " + slotCells(game, slot)
+        + (game.isSolved() ? " solved" : "");
+  }
+  if (command == "show") {
+    std::string board = _puzzles[session->puzzle].board;
+    for (unsigned int s = 0; s < game.graph().slots().size(); s++) {
+      if (game.count(s) > 0) {
+        board += ";" + slotCells(game, s);
+      }
+    }
+    return board + (game.isSolved() ? " solved" : "");
+  }
+  return "error unknown command " + command;
+}
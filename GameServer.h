@@ -0,0 +1,143 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef GAMESERVER_H_
+#define GAMESERVER_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "./GameState.h"
+#include "./IsleGraph.h"
+
+// Game server that hosts the games of many players in one process. All
+// connections are served by a single thread on an epoll event loop with
+// non-blocking sockets (Unix domain or local TCP). The puzzles are parsed
+// once: their IsleGraph and board line are shared by all sessions, a
+// session only keeps its GameState (a few bytes per slot) and its buffers.
+// Requests and replies are single lines:
+//   puzzles             ->  puzzles <amount>
+//   play <number>       ->  board <W>:<H> <x,y,value;...>
+//     start a new game of a puzzle (counted from 0), lists the isles
+//   move <x1,y1,x2,y2>  ->  update <x,y,value;...>[ solved]
+//     click on two isles like in the game (no bridge -> single -> double
+//     -> no bridge), lists the changed cells
+//   undo                ->  update <x,y,value;...>[ solved]
+//     take back one of the last moves (see setUndoLimit())
+//   show                ->  board <W>:<H> <x,y,value;...>[ solved]
+//     the isles and the bridge cells of the current game
+//   any request         ->  error <message>
+// The values are those of the Hashi _numbers matrix (1 - 8 isle, 10 - 13
+// bridge, 0 empty).
+class GameServer {
+ public:
+  GameServer();
+  FRIEND_TEST(GameServer, constructor);
+
+  // Closes all connections and the listening sockets.
+  ~GameServer();
+
+  // Add a puzzle (before run()).
+  // Arguments:
+  //   const std::vector< std::vector<int> >& numbers - the isles in the
+  //     format of the Hashi _numbers matrix
+  // Returns: int - the number of the puzzle
+  int addPuzzle(const std::vector< std::vector<int> >& numbers);
+
+  // Returns: int - the amount of puzzles
+  int puzzles() const { return _puzzles.size(); }
+
+  // Set how many moves a session can take back (default 5 like the game,
+  // see --undos), so a session can't grow its history without end. Takes
+  // effect for the games started afterwards.
+  void setUndoLimit(const int limit);
+
+  // Listen on a Unix domain socket (the file is replaced).
+  // Returns: bool - false if the socket can't be created
+  bool listenUnix(const char* path);
+
+  // Listen on a TCP port of 127.0.0.1 (0: any free port, see port()).
+  // Returns: bool - false if the socket can't be created
+  bool listenTcp(const int port);
+
+  // Returns: int - the TCP port of the last listenTcp() call
+  int port() const { return _port; }
+
+  // Serve the clients until stop() is called.
+  void run();
+  FRIEND_TEST(GameServer, run);
+
+  // Let run() return (thread-safe).
+  void stop();
+
+  // statistics: the open sessions and the applied moves (including undos)
+  int sessions() const { return _sessions.size(); }
+  int64_t moves() const { return _moves; }
+
+ private:
+  // a shared puzzle: the graph of the GameStates and the isles of the
+  // "board" reply
+  struct Puzzle {
+    std::unique_ptr<const IsleGraph> graph;
+    std::string board;
+  };
+
+  // a connection and its game (NULL before the first "play")
+  struct Session {
+    int fd;
+    std::string in;
+    std::string out;
+    // the socket is watched for EPOLLOUT (out didn't fit)
+    bool writing;
+    int puzzle;
+    std::unique_ptr<GameState> game;
+  };
+
+  // limits of a request line and of the replies a client doesn't read
+  static const unsigned int kMaxLine = 4096;
+  static const unsigned int kMaxOutput = 1 << 20;
+
+  std::vector<Puzzle> _puzzles;
+  std::unordered_map<int, Session> _sessions;
+  int _epoll;
+  std::vector<int> _listeners;
+  std::string _socketPath;
+  int _port;
+  // stop() writes to the pipe to wake up the event loop
+  int _wakeup[2];
+  std::atomic<bool> _stopped;
+  int64_t _moves;
+  int _undoLimit;
+
+  // Answer a request of a session.
+  std::string handle(Session* session, const std::string& request);
+  FRIEND_TEST(GameServer, handle);
+
+  // Returns: std::string - the cells of a slot as "x,y,value;..." (without
+  // the isles)
+  static std::string slotCells(const GameState& game, const int slot);
+
+  // Start listening on a bound socket.
+  bool addListener(const int fd);
+
+  // Accept the waiting connections of a listening socket.
+  void acceptAll(const int listener);
+
+  // Read the requests of a session and answer the complete lines.
+  // Returns: bool - false if the session was closed
+  bool receive(Session* session);
+
+  // Write as much of the replies as the socket takes, wait for EPOLLOUT
+  // if there is more.
+  // Returns: bool - false if the session was closed
+  bool flush(Session* session);
+
+  // Close a session (the pointer becomes invalid).
+  void closeSession(Session* session);
+};
+
+#endif  // GAMESERVER_H_
@@ -0,0 +1,153 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include "./GameServer.h"
+
+namespace {
+// Send a request and read the reply line.
+std::string request(const int fd, const std::string& line) {
+  // an empty line only reads the next reply
+  std::string data = line + "\n";
+  if (!line.empty()
+      && write(fd, data.data(), data.size()) != (ssize_t) data.size()) {
+    return "";
+  }
+  std::string reply;
+  char c;
+  while (read(fd, &c, 1) == 1 && c != '\n') {
+    reply += c;
+  }
+  return reply;
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(GameServer, constructor) {
+  GameServer server;
+  ASSERT_EQ(0, server.puzzles());
+  ASSERT_EQ(0, server.sessions());
+  ASSERT_EQ(0, server.addPuzzle({{4, 0, 0, 3},
+                                 {0, 0, 0, 0},
+                                 {2, 0, 0, 1}}));
+  ASSERT_EQ(1, server.addPuzzle({{1, 0, 1}}));
+  ASSERT_EQ(2, server.puzzles());
+  ASSERT_EQ("board 4:3 0,0,4;3,0,3;0,2,2;3,2,1", server._puzzles[0].board);
+  ASSERT_EQ("board 3:1 0,0,1;2,0,1", server._puzzles[1].board);
+}
+
+// _____________________________________________________________________________
+TEST(GameServer, handle) {
+  GameServer server;
+  server.addPuzzle({{4, 0, 0, 3},
+                    {0, 0, 0, 0},
+                    {2, 0, 0, 1}});
+  GameServer::Session session;
+  session.puzzle = -1;
+  ASSERT_EQ("puzzles 1", server.handle(&session, "puzzles"));
+  ASSERT_EQ(0, server.handle(&session, "move 0,0,3,0").find("error"));
+  ASSERT_EQ(0, server.handle(&session, "play 1").find("error"));
+  ASSERT_EQ(0, server.handle(&session, "play x").find("error"));
+  ASSERT_EQ("board 4:3 0,0,4;3,0,3;0,2,2;3,2,1",
+            server.handle(&session, "play 0"));
+
+  // every move clicks the same bridge once more
+  ASSERT_EQ("update 1,0,10;2,0,10", server.handle(&session, "move 0,0,3,0"));
+  ASSERT_EQ("update 1,0,11;2,0,11", server.handle(&session, "move 3,0,0,0"));
+  ASSERT_EQ("update 0,1,12", server.handle(&session, "move 0,0,0,2"));
+  ASSERT_EQ(0, server.handle(&session, "move 0,0,3,2").find("error"));
+  ASSERT_EQ(0, server.handle(&session, "move 0,0,3").find("error"));
+  ASSERT_EQ("update 0,1,13", server.handle(&session, "move 0,0,0,2"));
+  ASSERT_EQ("update 3,1,12 solved", server.handle(&session, "move 3,0,3,2"));
+  ASSERT_EQ("board 4:3 0,0,4;3,0,3;0,2,2;3,2,1;1,0,11;2,0,11;0,1,13;3,1,12"
+            " solved", server.handle(&session, "show"));
+  ASSERT_EQ(5, server.moves());
+
+  // undo reports the cells of the bridge that was taken back
+  ASSERT_EQ("update 3,1,0", server.handle(&session, "undo"));
+  ASSERT_EQ("update 0,1,12", server.handle(&session, "undo"));
+  ASSERT_EQ(0, server.handle(&session, "jump").find("error"));
+  // a new game starts without bridges
+  server.handle(&session, "play 0");
+  ASSERT_EQ(0, server.handle(&session, "undo").find("error"));
+
+  // only the last move can be taken back
+  server.setUndoLimit(1);
+  server.handle(&session, "play 0");
+  server.handle(&session, "move 0,0,3,0");
+  server.handle(&session, "move 0,0,0,2");
+  ASSERT_EQ("update 0,1,0", server.handle(&session, "undo"));
+  ASSERT_EQ(0, server.handle(&session, "undo").find("error"));
+}
+
+// _____________________________________________________________________________
+TEST(GameServer, run) {
+  GameServer server;
+  server.addPuzzle({{1, 0, 1}});
+  ASSERT_TRUE(server.listenTcp(0));
+  ASSERT_TRUE(server.listenUnix("thisIsATest.socket"));
+  ASSERT_LT(0, server.port());
+  std::thread loop([&server] { server.run(); });
+
+  // many sessions over both sockets, each with its own game
+  const int kSessions = 100;
+  int clients[kSessions];
+  for (int i = 0; i < kSessions; i++) {
+    if (i % 2 == 0) {
+      struct sockaddr_in address;
+      memset(&address, 0, sizeof(address));
+      address.sin_family = AF_INET;
+      address.sin_port = htons(server.port());
+      address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      clients[i] = socket(AF_INET, SOCK_STREAM, 0);
+      ASSERT_EQ(0, connect(clients[i],
+       reinterpret_cast<struct sockaddr*>(&address), sizeof(address)));
+    } else {
+      struct sockaddr_un address;
+      memset(&address, 0, sizeof(address));
+      address.sun_family = AF_UNIX;
+      strncpy(address.sun_path, "thisIsATest.socket",
+       sizeof(address.sun_path) - 1);
+      clients[i] = socket(AF_UNIX, SOCK_STREAM, 0);
+      ASSERT_EQ(0, connect(clients[i],
+       reinterpret_cast<struct sockaddr*>(&address), sizeof(address)));
+    }
+    ASSERT_EQ("board 3:1 0,0,1;2,0,1", request(clients[i], "play 0"));
+  }
+  ASSERT_EQ("update 1,0,10 solved", request(clients[0], "move 0,0,2,0"));
+  ASSERT_EQ("board 3:1 0,0,1;2,0,1", request(clients[1], "show"));
+  ASSERT_EQ("update 1,0,10 solved", request(clients[1], "move 2,0,0,0"));
+  // several requests at once, the last one unterminated until later
+  const char* batch = "move 0,0,2,0\nshow\nmo";
+  ASSERT_EQ(strlen(batch), write(clients[2], batch, strlen(batch)));
+  ASSERT_EQ("update 1,0,10 solved", request(clients[2], ""));
+  ASSERT_EQ("board 3:1 0,0,1;2,0,1;1,0,10 solved", request(clients[2], ""));
+  ASSERT_EQ("update 1,0,11", request(clients[2], "ve 0,0,2,0"));
+
+  for (int i = 0; i < kSessions; i++) {
+    close(clients[i]);
+  }
+  // the closed sessions are gone once the loop answered a new one
+  int last = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, "thisIsATest.socket",
+   sizeof(address.sun_path) - 1);
+  ASSERT_EQ(0, connect(last, reinterpret_cast<struct sockaddr*>(&address),
+   sizeof(address)));
+  ASSERT_EQ("puzzles 1", request(last, "puzzles"));
+  server.stop();
+  loop.join();
+  ASSERT_EQ(1, server.sessions());
+  ASSERT_EQ(4, server.moves());
+  close(last);
+}
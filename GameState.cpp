@@ -0,0 +1,201 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <limits>
+#include <vector>
+#include "./GameState.h"
+
+// ____________________________________________________________________________
+GameState::GameState(const IsleGraph* graph) : _graph(graph) {
+  _counts.assign(_graph->slots().size(), 0);
+  _blocked.assign(_graph->slots().size(), 0);
+  _bridges.assign(_graph->isles().size(), 0);
+  _satisfied = 0;
+  _historyLimit = std::numeric_limits<size_t>::max();
+}
+
+// ____________________________________________________________________________
+GameState::GameState(const IsleGraph* graph,
+ const std::vector< std::vector<int> >& numbers) : GameState(graph) {
+  // a bridge crosses the cell next to its left / upper isle
+  const std::vector<BridgeSlot>& slots = _graph->slots();
+  const std::vector<Isle>& isles = _graph->isles();
+  for (unsigned int s = 0; s < slots.size(); s++) {
+    const Isle& a = isles[slots[s].a];
+    int x = slots[s].vertical ? a.x : a.x + 1;
+    int y = slots[s].vertical ? a.y + 1 : a.y;
+    if (y >= static_cast<int>(numbers.size())
+        || x >= static_cast<int>(numbers[y].size())) {
+      continue;
+    }
+    int value = numbers[y][x];
+    bool match = slots[s].vertical ? value == 12 || value == 13
+                                   : value == 10 || value == 11;
+    if (match && _blocked[s] == 0) {
+      set(s, value % 2 + 1);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void GameState::legalMoves(std::vector<Move>* moves) const {
+  moves->clear();
+  for (unsigned int s = 0; s < _counts.size(); s++) {
+    if (_blocked[s] > 0) {continue; }
+    for (int count = 0; count < 3; count++) {
+      if (count != _counts[s]) {
+        Move move = {static_cast<int>(s), count};
+        moves->push_back(move);
+      }
+    }
+  }
+}
+
+// ____________________________________________________________________________
+bool GameState::isLegal(const Move& move) const {
+  return move.slot >= 0 && move.slot < static_cast<int>(_counts.size())
+      && move.count >= 0 && move.count < 3 && _blocked[move.slot] == 0
+      && move.count != _counts[move.slot];
+}
+
+// ____________________________________________________________________________
+void GameState::apply(const Move& move) {
+  Undo undo = {move.slot, _counts[move.slot]};
+  if (_historyLimit > 0) {
+    if (_history.size() >= _historyLimit) {_history.pop_front(); }
+    _history.push_back(undo);
+  }
+  set(move.slot, move.count);
+}
+
+// ____________________________________________________________________________
+void GameState::setHistoryLimit(const size_t limit) {
+  _historyLimit = limit;
+  while (_history.size() > _historyLimit) {_history.pop_front(); }
+}
+
+// ____________________________________________________________________________
+bool GameState::undo() {
+  if (_history.empty()) {
+    return false;
+  }
+  Undo undo = _history.back();
+  _history.pop_back();
+  set(undo.slot, undo.count);
+  return true;
+}
+
+// ____________________________________________________________________________
+void GameState::set(const int slot, const int count) {
+  int old = _counts[slot];
+  if (old == count) {return; }
+  _counts[slot] = count;
+
+  // the isles of the slot
+  const BridgeSlot& s = _graph->slots()[slot];
+  const std::vector<Isle>& isles = _graph->isles();
+  int ends[2] = {s.a, s.b};
+  for (int i = 0; i < 2; i++) {
+    int isle = ends[i];
+    _satisfied -= _bridges[isle] == isles[isle].value;
+    _bridges[isle] += count - old;
+    _satisfied += _bridges[isle] == isles[isle].value;
+  }
+
+  // a used slot blocks the slots that cross it
+  if ((old == 0) != (count == 0)) {
+    const std::vector<int>& crossings = _graph->crossings(slot);
+    for (unsigned int c = 0; c < crossings.size(); c++) {
+      _blocked[crossings[c]] += count == 0 ? -1 : 1;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+bool GameState::isSolved() const {
+  int isles = _graph->isles().size();
+  if (_satisfied != isles) {
+    return false;
+  }
+  // all isles are reachable from the first one
+  std::vector<char> visited(isles, 0);
+  std::vector<int> stack;
+  if (isles > 0) {
+    stack.push_back(0);
+    visited[0] = 1;
+  }
+  int reached = stack.size();
+  while (!stack.empty()) {
+    int isle = stack.back();
+    stack.pop_back();
+    const std::vector<int>& slots = _graph->isleSlots(isle);
+    for (unsigned int j = 0; j < slots.size(); j++) {
+      const BridgeSlot& slot = _graph->slots()[slots[j]];
+      int other = slot.a == isle ? slot.b : slot.a;
+      if (_counts[slots[j]] > 0 && !visited[other]) {
+        visited[other] = 1;
+        reached++;
+        stack.push_back(other);
+      }
+    }
+  }
+  return reached == isles;
+}
+
+// ____________________________________________________________________________
+int GameState::cell(const int x, const int y) const {
+  int isle = _graph->isleAt(x, y);
+  if (isle >= 0) {
+    return _graph->isles()[isle].value;
+  }
+  // look for the next isle to the left and upwards
+  const std::vector<Isle>& isles = _graph->isles();
+  for (int left = x - 1; left >= 0; left--) {
+    int a = _graph->isleAt(left, y);
+    if (a < 0) {continue; }
+    for (int right = x + 1; right < _graph->width(); right++) {
+      int b = _graph->isleAt(right, y);
+      if (b < 0) {continue; }
+      int slot = _graph->slotBetween(isles[a].x, y, isles[b].x, y);
+      if (slot >= 0 && _counts[slot] > 0) {
+        return 9 + _counts[slot];
+      }
+      break;
+    }
+    break;
+  }
+  for (int up = y - 1; up >= 0; up--) {
+    int a = _graph->isleAt(x, up);
+    if (a < 0) {continue; }
+    for (int down = y + 1; down < _graph->height(); down++) {
+      int b = _graph->isleAt(x, down);
+      if (b < 0) {continue; }
+      int slot = _graph->slotBetween(x, isles[a].y, x, isles[b].y);
+      if (slot >= 0 && _counts[slot] > 0) {
+        return 11 + _counts[slot];
+      }
+      break;
+    }
+    break;
+  }
+  return 0;
+}
+
+// ____________________________________________________________________________
+std::vector<Bridge> GameState::toBridges() const {
+  std::vector<Bridge> bridges;
+  for (unsigned int s = 0; s < _counts.size(); s++) {
+    if (_counts[s] == 0) {continue; }
+    const Isle& a = _graph->isles()[_graph->slots()[s].a];
+    const Isle& b = _graph->isles()[_graph->slots()[s].b];
+    bridges.push_back(Bridge(a.x, a.y, b.x, b.y, _counts[s]));
+  }
+  return bridges;
+}
+
+// ____________________________________________________________________________
+Move GameState::moveBetween(const Bridge& bridge) const {
+  Move move = {_graph->slotBetween(bridge.x1, bridge.y1, bridge.x2,
+      bridge.y2), bridge.count};
+  return move;
+}
@@ -0,0 +1,127 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef GAMESTATE_H_
+#define GAMESTATE_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <deque>
+#include <vector>
+#include "./Bridge.h"
+#include "./IsleGraph.h"
+
+// A move: set the bridges of a slot of the IsleGraph to count (0 - 2).
+struct Move {
+  int slot;
+  int count;
+
+  bool operator==(const Move& other) const {
+    return slot == other.slot && count == other.count;
+  }
+};
+
+// Terminal independent game state for bots and simulated players: the
+// rules of Hashi::drawBridge() and Hashi::isBridgeValid() without ncurses.
+// A bridge may be built between two isles that see each other unless a
+// crossing bridge is in the way; an isle may get more bridges than its
+// value (like in the game). The puzzle is solved if every isle has the
+// right amount of bridges and all isles are connected (see
+// IsleGraph::verify()).
+//
+// The state only keeps one byte per slot and per isle plus the move
+// history (unbounded unless setHistoryLimit() caps it like the undo list
+// of the game), the IsleGraph is shared: copies are cheap, so a playout can
+// start from a copy of the root state. apply() and undo() update counters
+// instead of walking the cells of a bridge, the cost only depends on the
+// amount of crossing slots.
+class GameState {
+ public:
+  // Create the state of a puzzle without bridges. The graph is not copied,
+  // it has to outlive the state and all its copies.
+  explicit GameState(const IsleGraph* graph);
+
+  // Create the state of a _numbers matrix (see Hashi), the bridge cells
+  // (10 - 13) become the bridges of the state.
+  GameState(const IsleGraph* graph,
+   const std::vector< std::vector<int> >& numbers);
+  FRIEND_TEST(GameState, constructor);
+
+  // Get the legal moves: every count other than the current one of every
+  // slot that is not blocked by a crossing bridge.
+  // Arguments:
+  //   std::vector<Move>* moves - receives the moves (cleared first, the
+  //     capacity is reused)
+  void legalMoves(std::vector<Move>* moves) const;
+  FRIEND_TEST(GameState, legalMoves);
+
+  // Returns: bool - true if the move is legal (see legalMoves())
+  bool isLegal(const Move& move) const;
+
+  // Apply a legal move (illegal moves are not checked).
+  void apply(const Move& move);
+  FRIEND_TEST(GameState, applyAndUndo);
+
+  // Take back the last applied move.
+  // Returns: bool - false if there is no move to take back
+  bool undo();
+
+  // Only keep the last moves for undo(), older ones are forgotten.
+  // Arguments:
+  //   const size_t limit - the amount of moves that can be taken back
+  void setHistoryLimit(const size_t limit);
+  FRIEND_TEST(GameState, setHistoryLimit);
+
+  // Returns: int - the slot of the last applied move (-1 if there is none)
+  int lastSlot() const {
+    return _history.empty() ? -1 : _history.back().slot;
+  }
+
+  // Returns: bool - true if every isle has the right amount of bridges and
+  // all isles are connected
+  bool isSolved() const;
+  FRIEND_TEST(GameState, isSolved);
+
+  // Returns: int - the bridge count of a slot
+  int count(const int slot) const { return _counts[slot]; }
+
+  // Returns: int - the amount of bridges at an isle
+  int bridges(const int isle) const { return _bridges[isle]; }
+
+  // Returns: int - the value of the cell (x, y) in the encoding of the
+  // Hashi _numbers matrix (0 empty, 1 - 8 isle, 10 - 13 bridge)
+  int cell(const int x, const int y) const;
+
+  // Returns: std::vector<Bridge> - the drawn bridges (see Hashi::bridges())
+  std::vector<Bridge> toBridges() const;
+
+  // Returns: Move - the move that sets the bridges between two isles, the
+  // slot is -1 if they can't be connected
+  Move moveBetween(const Bridge& bridge) const;
+
+  const IsleGraph& graph() const { return *_graph; }
+
+ private:
+  // a move of the history and the count before it
+  struct Undo {
+    int slot;
+    int count;
+  };
+
+  const IsleGraph* _graph;
+  // the bridge count of every slot
+  std::vector<uint8_t> _counts;
+  // the amount of used crossing slots of every slot (0: the slot is free)
+  std::vector<uint16_t> _blocked;
+  // the amount of bridges of every isle
+  std::vector<uint8_t> _bridges;
+  // the amount of isles with the right amount of bridges
+  int _satisfied;
+  std::deque<Undo> _history;
+  size_t _historyLimit;
+
+  // Set the count of a slot and update the counters.
+  void set(const int slot, const int count);
+};
+
+#endif  // GAMESTATE_H_
@@ -0,0 +1,77 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <random>
+#include <vector>
+#include "./GameState.h"
+#include "./Generator.h"
+#include "./ThreadPool.h"
+
+// Random playouts on one generated puzzle with 1, 2, 4, ... threads. Every
+// thread plays from a copy of the root state: random legal moves (a random
+// slot and count, checked by isLegal()) until the puzzle is solved or the
+// playout is long enough, then all moves are taken back. Prints the move
+// applications (apply() and undo()) per second.
+int main(int argc, char** argv) {
+  if (argc < 5) {
+    fprintf(stderr, "Usage: ./GameStateBenchMain <size> <isles> <playouts> "
+     "<maxthreads> [seed]\n");
+    return 1;
+  }
+  int size = atoi(argv[1]);
+  int isles = atoi(argv[2]);
+  int playouts = atoi(argv[3]);
+  int maxThreads = atoi(argv[4]);
+  unsigned int seed = argc > 5 ? atoi(argv[5]) : 42;
+
+  std::vector< std::vector<int> > numbers;
+  Generator generator(size, size, seed);
+  generator.generate(isles, &numbers);
+  IsleGraph graph(numbers);
+  GameState root(&graph);
+  int length = 2 * graph.slots().size();
+  // without a slot there is no move to play (and to pick one from)
+  if (graph.slots().empty()) {
+    fprintf(stderr, "The puzzle has no bridge slots.\n");
+    return 1;
+  }
+
+  for (int threads = 1; threads <= maxThreads; threads *= 2) {
+    std::atomic<int64_t> moves(0);
+    std::atomic<int> solved(0);
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    ThreadPool pool(threads);
+    pool.run(threads, [&](int id) {
+      GameState state = root;
+      std::mt19937 random(seed + id);
+      int slots = graph.slots().size();
+      int64_t count = 0;
+      for (int p = id; p < playouts; p += threads) {
+        int depth = 0;
+        while (depth < length && !state.isSolved()) {
+          Move move = {static_cast<int>(random() % slots),
+                       static_cast<int>(random() % 3)};
+          if (!state.isLegal(move)) {continue; }
+          state.apply(move);
+          depth++;
+        }
+        solved += state.isSolved();
+        while (state.undo()) {}
+        count += 2 * depth;
+      }
+      moves += count;
+    });
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    printf("threads %3d: %10.2f ms  %12lld moves  %8.2f M moves/s  %d "
+     "solved\n", threads, 1000 * seconds,
+     static_cast<long long>(moves),  // NOLINT
+     seconds > 0 ? moves / seconds / 1e6 : 0, static_cast<int>(solved));
+  }
+  return 0;
+}
@@ -0,0 +1,128 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include "./GameState.h"
+
+// _____________________________________________________________________________
+TEST(GameState, constructor) {
+  IsleGraph graph({{4, 0, 0, 3, 0, 0},
+                   {0, 0, 0, 0, 0, 0},
+                   {2, 0, 0, 1, 0, 0}});
+  GameState test1(&graph);
+  ASSERT_EQ(0, test1.count(0));
+  ASSERT_EQ(4, test1.cell(0, 0));
+  ASSERT_EQ(0, test1.cell(1, 0));
+
+  // the bridge cells of a _numbers matrix
+  GameState test2(&graph, {{4, 11, 11, 3, 0, 0},
+                           {13, 0, 0, 12, 0, 0},
+                           {2, 0, 0, 1, 0, 0}});
+  ASSERT_EQ(2, test2.count(graph.slotBetween(0, 0, 3, 0)));
+  ASSERT_EQ(2, test2.count(graph.slotBetween(0, 0, 0, 2)));
+  ASSERT_EQ(1, test2.count(graph.slotBetween(3, 0, 3, 2)));
+  ASSERT_EQ(11, test2.cell(2, 0));
+  ASSERT_EQ(13, test2.cell(0, 1));
+  ASSERT_EQ(12, test2.cell(3, 1));
+  ASSERT_EQ(0, test2.cell(1, 2));
+  ASSERT_EQ(3, test2.toBridges().size());
+  ASSERT_TRUE(test2.isSolved());
+}
+
+// _____________________________________________________________________________
+TEST(GameState, legalMoves) {
+  IsleGraph graph({{0, 0, 2, 0, 0},
+                   {1, 0, 0, 0, 1},
+                   {0, 0, 2, 0, 0}});
+  GameState test3(&graph);
+  std::vector<Move> moves;
+  test3.legalMoves(&moves);
+  // two slots with two other counts each
+  ASSERT_EQ(4, moves.size());
+  Move horizontal = test3.moveBetween(Bridge(0, 1, 4, 1, 1));
+  ASSERT_TRUE(test3.isLegal(horizontal));
+  test3.apply(horizontal);
+  // the vertical slot is blocked
+  test3.legalMoves(&moves);
+  ASSERT_EQ(2, moves.size());
+  Move vertical = test3.moveBetween(Bridge(2, 0, 2, 2, 2));
+  ASSERT_FALSE(test3.isLegal(vertical));
+  ASSERT_EQ(moves.end(), std::find(moves.begin(), moves.end(), vertical));
+  ASSERT_FALSE(test3.isLegal(test3.moveBetween(Bridge(0, 1, 2, 0, 1))));
+}
+
+// _____________________________________________________________________________
+TEST(GameState, applyAndUndo) {
+  IsleGraph graph({{4, 0, 0, 3, 0, 0},
+                   {0, 0, 0, 0, 0, 0},
+                   {2, 0, 0, 1, 0, 0}});
+  GameState test4(&graph);
+  ASSERT_FALSE(test4.undo());
+  ASSERT_EQ(-1, test4.lastSlot());
+  test4.apply(test4.moveBetween(Bridge(0, 0, 3, 0, 1)));
+  ASSERT_EQ(graph.slotBetween(0, 0, 3, 0), test4.lastSlot());
+  test4.apply(test4.moveBetween(Bridge(0, 0, 3, 0, 2)));
+  ASSERT_EQ(2, test4.bridges(graph.isleAt(0, 0)));
+  ASSERT_EQ(2, test4.bridges(graph.isleAt(3, 0)));
+  // copies are independent
+  GameState copy = test4;
+  ASSERT_TRUE(test4.undo());
+  ASSERT_EQ(1, test4.bridges(graph.isleAt(0, 0)));
+  ASSERT_EQ(2, copy.bridges(graph.isleAt(0, 0)));
+  ASSERT_TRUE(test4.undo());
+  ASSERT_EQ(0, test4.bridges(graph.isleAt(3, 0)));
+  ASSERT_FALSE(test4.undo());
+}
+
+// _____________________________________________________________________________
+TEST(GameState, setHistoryLimit) {
+  IsleGraph graph({{4, 0, 0, 3, 0, 0},
+                   {0, 0, 0, 0, 0, 0},
+                   {2, 0, 0, 1, 0, 0}});
+  GameState test7(&graph);
+  test7.setHistoryLimit(2);
+  for (int i = 0; i < 100; i++) {
+    test7.apply(test7.moveBetween(Bridge(0, 0, 3, 0, (i + 1) % 3)));
+  }
+  ASSERT_EQ(2, test7._history.size());
+  // 100 moves: the bridge is single, the last two moves can be taken back
+  ASSERT_EQ(1, test7.bridges(graph.isleAt(0, 0)));
+  ASSERT_TRUE(test7.undo());
+  ASSERT_EQ(0, test7.bridges(graph.isleAt(0, 0)));
+  ASSERT_TRUE(test7.undo());
+  ASSERT_EQ(2, test7.bridges(graph.isleAt(0, 0)));
+  ASSERT_FALSE(test7.undo());
+  test7.apply(test7.moveBetween(Bridge(0, 0, 3, 0, 0)));
+  test7.apply(test7.moveBetween(Bridge(0, 0, 0, 2, 1)));
+  test7.setHistoryLimit(1);
+  ASSERT_EQ(1, test7._history.size());
+  test7.setHistoryLimit(0);
+  test7.apply(test7.moveBetween(Bridge(0, 0, 0, 2, 2)));
+  ASSERT_FALSE(test7.undo());
+}
+
+// _____________________________________________________________________________
+TEST(GameState, isSolved) {
+  IsleGraph graph({{4, 0, 0, 3, 0, 0},
+                   {0, 0, 0, 0, 0, 0},
+                   {2, 0, 0, 1, 0, 0}});
+  GameState test5(&graph);
+  test5.apply(test5.moveBetween(Bridge(0, 0, 3, 0, 2)));
+  test5.apply(test5.moveBetween(Bridge(0, 0, 0, 2, 2)));
+  ASSERT_FALSE(test5.isSolved());
+  test5.apply(test5.moveBetween(Bridge(3, 0, 3, 2, 1)));
+  ASSERT_TRUE(test5.isSolved());
+  test5.undo();
+  ASSERT_FALSE(test5.isSolved());
+
+  // the right amounts of bridges, but two islands
+  IsleGraph pairs({{1, 0, 1},
+                   {0, 0, 0},
+                   {1, 0, 1}});
+  GameState test6(&pairs);
+  test6.apply(test6.moveBetween(Bridge(0, 0, 2, 0, 1)));
+  test6.apply(test6.moveBetween(Bridge(0, 2, 2, 2, 1)));
+  ASSERT_FALSE(test6.isSolved());
+}
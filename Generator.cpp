@@ -0,0 +1,89 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <vector>
+#include "./Generator.h"
+
+namespace {
+// the four directions (right, down, left, up)
+const int kDx[4] = {1, 0, -1, 0};
+const int kDy[4] = {0, 1, 0, -1};
+// marks an isle cell on the board while its value is not known yet
+const int kIsle = -1;
+}  // namespace
+
+// ____________________________________________________________________________
+Generator::Generator(const int width, const int height,
+ const unsigned int seed) : _random(seed) {
+  _width = width;
+  _height = height;
+}
+
+// ____________________________________________________________________________
+bool Generator::isFree(const std::vector< std::vector<int> >& board,
+ const int x, const int y) const {
+  if (x < 0 || y < 0 || x >= _width || y >= _height || board[y][x] != 0) {
+    return false;
+  }
+  for (int d = 0; d < 4; d++) {
+    int nx = x + kDx[d];
+    int ny = y + kDy[d];
+    if (nx >= 0 && ny >= 0 && nx < _width && ny < _height
+        && board[ny][nx] == kIsle) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+void Generator::generate(const int isles,
+ std::vector< std::vector<int> >* numbers) {
+  // The board uses the bridge encoding of the Hashi _numbers matrix,
+  // so new bridges can't cross old ones.
+  std::vector< std::vector<int> > board(_height, std::vector<int>(_width));
+  std::vector< std::vector<int> > values(_height, std::vector<int>(_width));
+  std::vector<int> xs;
+  std::vector<int> ys;
+
+  xs.push_back(_random() % _width);
+  ys.push_back(_random() % _height);
+  board[ys[0]][xs[0]] = kIsle;
+
+  for (int tries = 0; static_cast<int>(xs.size()) < isles
+       && tries < 100 * isles; tries++) {
+    int i = _random() % xs.size();
+    int d = _random() % 4;
+    int bridges = _random() % 2 + 1;
+    if (values[ys[i]][xs[i]] + bridges > 8) {continue; }
+
+    // walk until an isle or a bridge blocks the way
+    int length = 2 + _random() % 5;
+    int x = xs[i];
+    int y = ys[i];
+    bool blocked = false;
+    for (int step = 1; step < length && !blocked; step++) {
+      int cx = x + step * kDx[d];
+      int cy = y + step * kDy[d];
+      blocked = cx < 0 || cy < 0 || cx >= _width || cy >= _height
+       || board[cy][cx] != 0;
+    }
+    int tx = x + length * kDx[d];
+    int ty = y + length * kDy[d];
+    if (blocked || !isFree(board, tx, ty)) {continue; }
+
+    for (int step = 1; step < length; step++) {
+      board[y + step * kDy[d]][x + step * kDx[d]] = kDx[d] != 0 ? 10 : 12;
+    }
+    board[ty][tx] = kIsle;
+    values[ty][tx] = bridges;
+    values[y][x] += bridges;
+    xs.push_back(tx);
+    ys.push_back(ty);
+  }
+
+  numbers->assign(_height, std::vector<int>(_width));
+  for (unsigned int i = 0; i < xs.size(); i++) {
+    (*numbers)[ys[i]][xs[i]] = values[ys[i]][xs[i]];
+  }
+}
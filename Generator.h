@@ -0,0 +1,42 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+// Creates random number fields that are guaranteed to be solvable, e.g.
+// for benchmarks on boards larger than the ones in instances/. The
+// solutions are not necessarily unique.
+class Generator {
+ public:
+  // Arguments:
+  //   const int width - the amount of columns of the number field
+  //   const int height - the amount of rows of the number field
+  //   const unsigned int seed - seed of the random number generator
+  Generator(const int width, const int height, const unsigned int seed);
+
+  // Grow a connected bridge network from a random isle.
+  // Arguments:
+  //   const int isles - the desired amount of isles (might not be reached
+  //                     on small fields)
+  //   std::vector< std::vector<int> >* numbers - receives the isles in the
+  //     format of the Hashi _numbers matrix (without bridges)
+  void generate(const int isles, std::vector< std::vector<int> >* numbers);
+  FRIEND_TEST(Generator, generate);
+
+ private:
+  int _width;
+  int _height;
+  std::mt19937 _random;
+
+  // Checks if an isle may be placed at (x,y): the cell and its direct
+  // neighbours have to be empty.
+  bool isFree(const std::vector< std::vector<int> >& board, const int x,
+   const int y) const;
+};
+
+#endif  // GENERATOR_H_
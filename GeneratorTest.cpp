@@ -0,0 +1,30 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "./Generator.h"
+
+// _____________________________________________________________________________
+TEST(Generator, generate) {
+  Generator generator(12, 10, 3);
+  std::vector< std::vector<int> > numbers;
+  generator.generate(20, &numbers);
+  ASSERT_EQ(10, numbers.size());
+  ASSERT_EQ(12, numbers[0].size());
+  int isles = 0;
+  for (int y = 0; y < 10; y++) {
+    for (int x = 0; x < 12; x++) {
+      ASSERT_LE(0, numbers[y][x]);
+      ASSERT_GE(8, numbers[y][x]);
+      if (numbers[y][x] > 0) {
+        isles++;
+        // isles are never direct neighbours
+        ASSERT_TRUE(x == 11 || numbers[y][x + 1] == 0);
+        ASSERT_TRUE(y == 9 || numbers[y + 1][x] == 0);
+      }
+    }
+  }
+  ASSERT_LT(1, isles);
+  ASSERT_GE(20, isles);
+}
@@ -2,27 +2,116 @@
 // Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
 
 #include <ncurses.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
 #include <vector>
+#include "./AutoSaver.h"
+#include "./ClauseSolver.h"
 #include "./Hashi.h"
+#include "./RegionSolver.h"
+#include "./SolutionCache.h"
+#include "./Zobrist.h"
+
+namespace {
+// time budgets (in seconds) of the background searches: the check whether
+// the current position is still solvable and the search of the solve mode
+const double kCheckBudget = 2;
+const double kSolveBudget = 600;
+
+// Returns: const char* - a line (0 to 2) of the 5 x 3 terminal cells of a
+// grid cell that is crossed by a bridge
+const char* bridgeLine(const bool vertical, const bool doubleBridge,
+ const int line) {
+  if (vertical) {
+    return doubleBridge ? "|   |" : "  |  ";
+  }
+  if (doubleBridge) {
+    return line == 1 ? "     " : "-----";
+  }
+  return line == 1 ? "-----" : "     ";
+}
+}  // namespace
 
 // ____________________________________________________________________________
 Hashi::Hashi() {
+  _screen = NULL;
   _max_x = 0;
   _max_y = 0;
   _lastClicked_x = -1;
   _lastClicked_y = -1;
+  _solutionFile = "";
+  _cacheFile = "";
+  _saveFile = "";
+  _threads = 1;
+  _clauseSolver = false;
+  _hash = 0;
+  _elapsed = 0;
+  _started = std::chrono::steady_clock::now();
+  _viewX = 0;
+  _viewY = 0;
+  _viewWidth = 0;
+  _viewHeight = 0;
+  _solved = false;
+  _boardStale = true;
+  _solving = false;
 }
 
 // ____________________________________________________________________________
 Hashi::~Hashi() {
   // Clean up window.
-  endwin();
+  if (_screen != NULL) {
+    endwin();
+    delscreen(_screen);
+  }
+}
+
+// ____________________________________________________________________________
+void Hashi::initializeGame() {
+  initializeTerminal();
+  drawFirstFrame();
+}
+
+// ____________________________________________________________________________
+bool Hashi::startGame(const FileInterpreter& files, PhaseTimer* timer,
+ std::string* error) {
+  // the puzzle doesn't need the terminal: it is loaded meanwhile
+  bool loaded = false;
+  std::thread loader([&]() {
+    int phase = timer->begin("load");
+    loaded = files.processFiles(this, error);
+    timer->end(phase);
+  });
+  int phase = timer->begin("terminal");
+  bool opened = initializeTerminal();
+  timer->end(phase);
+  loader.join();
+  if (!opened) {
+    *error = "Error opening the terminal";
+  }
+  if (!opened || !loaded) {
+    if (opened) {
+      endwin();
+      delscreen(_screen);
+      _screen = NULL;
+    }
+    return false;
+  }
+  phase = timer->begin("first frame");
+  drawFirstFrame();
+  timer->end(phase);
+  return true;
 }
 
 // ____________________________________________________________________________
-void Hashi::initializeGame() const {
+bool Hashi::initializeTerminal() {
   // prepare the terminal for drawing
-  initscr();
+  _screen = newterm(NULL, stdout, stdin);
+  if (_screen == NULL) {
+    return false;
+  }
   cbreak();
   noecho();
   curs_set(false);
@@ -38,42 +127,174 @@ void Hashi::initializeGame() const {
   init_pair(3, COLOR_BLACK, COLOR_RED);
   init_pair(4, COLOR_BLACK, COLOR_YELLOW);
   init_pair(5, COLOR_BLACK, COLOR_BLACK);
+  return true;
+}
+
+// ____________________________________________________________________________
+void Hashi::drawFirstFrame() {
+  updateViewport();
+  redraw();
+  // show it right away instead of with the first getch() of play()
+  refresh();
+}
 
+// ____________________________________________________________________________
+void Hashi::load(PreparedPuzzle* puzzle) {
+  _numbers.swap(puzzle->numbers);
+  _max_y = _numbers.size();
+  _max_x = _max_y > 0 ? _numbers[0].size() : 0;
+  _sol.swap(puzzle->solution);
+  _position = std::move(puzzle->position);
+  _checker = std::move(puzzle->checker);
+  _boardStale = true;
+  _hash = 0;
+  _solved = false;
+  _solving = false;
+  _lastClicked_x = -1;
+  _lastClicked_y = -1;
+  _viewX = 0;
+  _viewY = 0;
+  for (unsigned int i = 0; i < _undos.size(); i++) {
+    _undos[i] = Bridge(0, 0, 0, 0, 0);
+  }
+  _feedback.clear();
+  _elapsed = 0;
+  _started = std::chrono::steady_clock::now();
+}
+
+// ____________________________________________________________________________
+bool Hashi::nextPuzzle() {
+  PreparedPuzzle puzzle;
+  if (!_playlist || !_playlist->next(&puzzle)) {
+    return false;
+  }
+  load(&puzzle);
+  updateViewport();
+  redraw();
+  return true;
+}
+
+// ____________________________________________________________________________
+void Hashi::updateViewport() {
+  // 5 x 3 terminal cells per grid cell, the menu needs 9 more lines
+  _viewWidth = std::min(_max_x, std::max(1, (COLS - 3) / 5));
+  _viewHeight = std::min(_max_y, std::max(1, (LINES - 9) / 3));
+  moveViewport(0, 0);
+}
+
+// ____________________________________________________________________________
+bool Hashi::moveViewport(const int dx, const int dy) {
+  int viewX = std::max(0, std::min(_viewX + dx, _max_x - _viewWidth));
+  int viewY = std::max(0, std::min(_viewY + dy, _max_y - _viewHeight));
+  bool moved = viewX != _viewX || viewY != _viewY;
+  _viewX = viewX;
+  _viewY = viewY;
+  return moved;
+}
+
+// ____________________________________________________________________________
+bool Hashi::isVisible(const int x, const int y) const {
+  return x >= _viewX && y >= _viewY && x < _viewX + _viewWidth
+      && y < _viewY + _viewHeight;
+}
+
+// ____________________________________________________________________________
+void Hashi::redraw() const {
+  erase();
   // Draw menu
   mvprintw(0, 3, "Hashiwokakero %d X %d", _max_x, _max_y);
-  mvprintw((_max_y) * 3 + 4, 3, "**************************"
+  if (_playlist) {
+    mvprintw(1, 3, "puzzle %d / %d%s", _playlist->current(),
+     _playlist->size(), _playlist->hasNext() ? "  (n: next puzzle)" : "");
+  }
+  if (_viewWidth < _max_x || _viewHeight < _max_y) {
+    mvprintw(0, 30, "view %d,%d  (arrow keys / mouse wheel to scroll)",
+     _viewX, _viewY);
+  }
+  mvprintw(3 * _viewHeight + 4, 3, "**************************"
   "*******************************************************");
   attron(COLOR_PAIR(3));
-  mvprintw((_max_y) * 3 + 6, 3, " press ESC to exit ");
-  mvprintw((_max_y) * 3 + 6, 23, " press r to reset ");
-  mvprintw((_max_y) * 3 + 6, 42, " press u to undo ");
-  mvprintw((_max_y) * 3 + 6, 60, " press s for solve mode ");
+  mvprintw(3 * _viewHeight + 6, 3, " press ESC to exit ");
+  mvprintw(3 * _viewHeight + 6, 23, " press r to reset ");
+  mvprintw(3 * _viewHeight + 6, 42, " press u to undo ");
+  mvprintw(3 * _viewHeight + 6, 60, " press s for solve mode ");
   if (_sol.size() == 0) {
-    mvprintw((_max_y) * 3 + 8, 3, " NO VALID SOLUTION FILE ");
+    mvprintw(3 * _viewHeight + 8, 3, " NO VALID SOLUTION FILE ");
+  }
+  attroff(COLOR_PAIR(3));
+  mvprintw(3 * _viewHeight + 7, 3, "%s", _feedback.c_str());
+  if (_solved) {
+    solvedMessage(false);
   }
-  attron(COLOR_PAIR(3));
 
-  // draw the number field
-  attron(COLOR_PAIR(1));
-  for (int row = 0; row < _max_y; row++) {
-    for (int col = 0; col < _max_x; col++) {
-      if (_numbers[row][col] != 0) {
-        mvprintw(3*row+2, 5*col+3, "     ");
-        mvprintw(3*row+3, 5*col+3, "  %d  ", _numbers[row][col]);
-        mvprintw(3*row+4, 5*col+3, "     ");
+  // draw the visible part of the number field, including the bridges that
+  // start or end outside of it: the three terminal lines of a grid row are
+  // composed first (as paintCell() and markIsle() would print them)
+  int width = 5 * _viewWidth;
+  std::vector<chtype> lines(3 * width);
+  for (int row = _viewY; row < _viewY + _viewHeight; row++) {
+    std::fill(lines.begin(), lines.end(), ' ');
+    for (int col = _viewX; col < _viewX + _viewWidth; col++) {
+      int value = _numbers[row][col];
+      chtype* cell = &lines[5 * (col - _viewX)];
+      if (value > 9) {
+        for (int line = 0; line < 3; line++) {
+          const char* text = bridgeLine(value > 11, value % 2 == 1, line);
+          for (int i = 0; i < 5; i++) {
+            cell[line * width + i] = text[i];
+          }
+        }
+      } else if (value > 0) {
+        bool selected = col == _lastClicked_x && row == _lastClicked_y;
+        chtype color = COLOR_PAIR(selected ? 4 : markerColor(col, row));
+        for (int line = 0; line < 3; line++) {
+          for (int i = 0; i < 5; i++) {
+            cell[line * width + i] = ' ' | color;
+          }
+        }
+        cell[width + 2] = ('0' + value) | color;
       }
     }
+    for (int line = 0; line < 3; line++) {
+      mvaddchnstr(3 * (row - _viewY) + 2 + line, 3, &lines[line * width],
+       width);
+    }
   }
-  attroff(COLOR_PAIR(1));
 }
 
 // ____________________________________________________________________________
 void Hashi::play() {
+  std::unique_ptr<AutoSaver> saver;
+  if (_saveFile[0] != '\0') {
+    saver.reset(new AutoSaver(_saveFile));
+  }
+  // the solvability of the position is checked whenever the bridges
+  // change: right away by propagation, then by a search in the background
+  // (a puzzle of the playlist comes with both checks prepared)
+  std::vector<Bridge> drawn = bridges();
+  if (!_position) {
+    _position.reset(new PositionCheck(_numbers));
+    for (unsigned int i = 0; i < drawn.size(); i++) {
+      _position->update(drawn[i]);
+    }
+  }
+  if (!_checker) {
+    _checker.reset(new BackgroundSolver(_numbers, _threads));
+  }
+  _checker->check(_hash, drawn, kCheckBudget);
+  uint64_t checked = _hash;
   while (true) {
     int key = getch();
+    uint64_t hash = _hash;
     int input = processUserInput(key);
+    // the viewport moved or the terminal was resized
+    if (input == 4) {
+      redraw();
+    }
     // proceed according to user input
     if (input == -1) {
+      // keep the elapsed time (written before the saver is destroyed)
+      if (saver) {saver->schedule(snapshot()); }
       break;
     }
     switch (input) {
@@ -84,12 +305,78 @@ void Hashi::play() {
       case 2:
         solve();
         break;
+      case 5:
+        // the next puzzle starts without bridges
+        if (nextPuzzle()) {
+          _checker->check(_hash, bridges(), kCheckBudget);
+          checked = _hash;
+          if (saver) {saver->schedule(snapshot()); }
+        }
+        break;
     }
     if (input ==  3 && _undos.size() != 0) {
       undo();
     }
+    // every change of the bridges changes the hash
+    if (saver && hash != _hash) {
+      saver->schedule(snapshot());
+    }
+    // the solve mode keeps the background search for itself
+    if (!_solving && checked != _hash && _position->possible()) {
+      _checker->check(_hash, bridges(), kCheckBudget);
+      checked = _hash;
+    }
+    showFeedback();
     usleep(10);
   }
+  _checker.reset();
+  _position.reset();
+}
+
+// ____________________________________________________________________________
+void Hashi::showFeedback() {
+  // without a checker (outside play()) only the PositionCheck has a verdict
+  BackgroundSolver::Progress progress = {0, BackgroundSolver::kUnknown,
+      false, 0};
+  if (_checker) {
+    progress = _checker->progress();
+  } else {
+    _solving = false;
+  }
+  if (_checker && _solving && !progress.searching) {
+    _solving = false;
+    if (_checker->solution(&_sol)) {
+      // overwrite the search message
+      mvprintw(3 * _viewHeight + 8, 3, "                             ");
+      drawSolution();
+    } else if (progress.verdict == BackgroundSolver::kUnsolvable) {
+      mvprintw(3 * _viewHeight + 8, 3, " The puzzle has no solution! ");
+    } else {
+      mvprintw(3 * _viewHeight + 8, 3, " No solution found in time!  ");
+    }
+  }
+  // the verdict of an older position is not shown
+  std::string verdict = "unknown";
+  if (_solving) {
+    verdict = "unknown (solve mode)";
+  } else if (_position && !_position->possible()) {
+    verdict = "no (a bridge can't be part of a solution)";
+  } else if (_checker && progress.position == _hash) {
+    if (progress.verdict == BackgroundSolver::kSolvable) {
+      verdict = "yes";
+    } else if (progress.verdict == BackgroundSolver::kUnsolvable) {
+      verdict = "no";
+    } else if (progress.searching) {
+      verdict = "unknown (searching, " + std::to_string(progress.nodes)
+          + " nodes)";
+    }
+  }
+  std::string feedback = " solvable from current position: " + verdict;
+  feedback.resize(std::max<size_t>(feedback.size(), 72), ' ');
+  if (feedback != _feedback) {
+    _feedback = feedback;
+    mvprintw(3 * _viewHeight + 7, 3, "%s", _feedback.c_str());
+  }
 }
 
 // ____________________________________________________________________________
@@ -109,30 +396,55 @@ int Hashi::processUserInput(const int key) {
     case 'u':
       // undo
       return 3;
+    case 'n':
+      // next puzzle of the playlist
+      return 5;
+    case KEY_LEFT:
+      return moveViewport(-1, 0) ? 4 : 0;
+    case KEY_RIGHT:
+      return moveViewport(1, 0) ? 4 : 0;
+    case KEY_UP:
+      return moveViewport(0, -1) ? 4 : 0;
+    case KEY_DOWN:
+      return moveViewport(0, 1) ? 4 : 0;
+    case KEY_PPAGE:
+      return moveViewport(0, -_viewHeight) ? 4 : 0;
+    case KEY_NPAGE:
+      return moveViewport(0, _viewHeight) ? 4 : 0;
+    case KEY_RESIZE:
+      updateViewport();
+      return 4;
     case KEY_MOUSE:
       if (getmouse(&event) == OK) {
+        // the mouse wheel scrolls three rows
+        if (event.bstate & BUTTON4_PRESSED) {
+          return moveViewport(0, -3) ? 4 : 0;
+        }
+        if (event.bstate & BUTTON5_PRESSED) {
+          return moveViewport(0, 3) ? 4 : 0;
+        }
+        // grid cell under the mouse, taking the viewport into account
+        int x = (event.x-3)/5 + _viewX;
+        int y = (event.y-2)/3 + _viewY;
         if (event.bstate & BUTTON1_CLICKED) {
-          if ((event.x-3)/5 < _max_x && (event.y-2)/3 < _max_y
-               && event.x >= 0 && event.y >= 0) {
+          if (event.x >= 3 && event.y >= 2 && isVisible(x, y)) {
             if (_lastClicked_x < 0) {
               // mark the isle if it is the first click
-              _lastClicked_x = (event.x-3)/5;
-              _lastClicked_y = (event.y-2)/3;
+              _lastClicked_x = x;
+              _lastClicked_y = y;
               markIsle(_lastClicked_x, _lastClicked_y, 4);
             } else {
               // only add valid bridges to the undo list
-              if (isBridgeValid(_lastClicked_x, _lastClicked_y,
-               (event.x-3)/5, (event.y-2)/3) != 1) {
+              if (isBridgeValid(_lastClicked_x, _lastClicked_y, x, y) != 1) {
                // add bridge to the list of undo operaions
-                _undos.push_back({_lastClicked_x, _lastClicked_y,
-                (event.x-3)/5, (event.y-2)/3});
+                _undos.push_back(Bridge(_lastClicked_x, _lastClicked_y,
+                x, y, 1));
                 // delete first row of _undos
                 _undos.erase(_undos.begin());
               }
 
               // draw bridge
-              drawBridge(_lastClicked_x, _lastClicked_y,
-               (event.x-3)/5, (event.y-2)/3);
+              drawBridge(_lastClicked_x, _lastClicked_y, x, y);
               // prepare for next bridge
               _lastClicked_x = -1;
               // update all markers
@@ -168,40 +480,48 @@ void Hashi::drawBridge(int x1, int y1, int x2, int y2) {
   bool doubleBridge = (bridgeType == 10 || bridgeType == 12);
   bool del = (bridgeType == 11 || bridgeType == 13);
 
+  paintBridge(x1, y1, x2, y2, del, doubleBridge);
+
+  // add the bridge to the _numbers matrix and update
+  addBridge(x1, y1, x2, y2, del, doubleBridge);
+  if (_position) {
+    int count = del ? 0 : (doubleBridge ? 2 : 1);
+    _position->update(Bridge(x1, y1, x2, y2, count));
+  }
+  updateMarkers();
+}
+
+// ____________________________________________________________________________
+void Hashi::paintBridge(const int x1, const int y1, const int x2,
+ const int y2, const bool del, const bool doubleBridge) const {
+  // only the cells inside the viewport are printed
+  if (y1 == y2) {
+    int last = std::min(x2 - 1, _viewX + _viewWidth - 1);
+    for (int x = std::max(x1 + 1, _viewX); x <= last; x++) {
+      paintCell(x, y1, false, del, doubleBridge);
+    }
+  } else {
+    int last = std::min(y2 - 1, _viewY + _viewHeight - 1);
+    for (int y = std::max(y1 + 1, _viewY); y <= last; y++) {
+      paintCell(x1, y, true, del, doubleBridge);
+    }
+  }
+}
+
+// ____________________________________________________________________________
+void Hashi::paintCell(const int x, const int y, const bool vertical,
+ const bool del, const bool doubleBridge) const {
+  if (!isVisible(x, y)) {return; }
+  int row = 3 * (y - _viewY) + 2;
+  int col = 5 * (x - _viewX) + 3;
   if (del) {
     attron(COLOR_PAIR(5));
   } else {
     attron(A_NORMAL);
   }
 
-  // horizontal bridge
-  if (x1 != x2) {
-    for (int i = 5*x1+8; i < 5*x2+3; i++) {
-      if (doubleBridge) {
-        mvprintw(3*y1+2, i, "-");
-        mvprintw(3*y1+3, i, " ");
-        mvprintw(3*y1+4, i, "-");
-      } else {
-        mvprintw(3*y1+2, i, " ");
-        mvprintw(3*y1+3, i, "-");
-        mvprintw(3*y1+4, i, " ");
-      }
-    }
-  }
-
-  // vertical bridge
-  if (y1 != y2) {
-    for (int i = 3*y1+5; i < 3*y2+2; i++) {
-      if (doubleBridge) {
-        mvprintw(i, 5*x1+3, "|");
-        mvprintw(i, 5*x1+5, "   ");
-        mvprintw(i, 5*x1+7, "|");
-      } else {
-        mvprintw(i, 5*x1+3, "  ");
-        mvprintw(i, 5*x1+5, "|");
-        mvprintw(i, 5*x1+6, "  ");
-      }
-    }
+  for (int i = 0; i < 3; i++) {
+    mvprintw(row + i, col, "%s", bridgeLine(vertical, doubleBridge, i));
   }
 
   if (del) {
@@ -209,10 +529,6 @@ void Hashi::drawBridge(int x1, int y1, int x2, int y2) {
   } else {
     attroff(A_NORMAL);
   }
-
-  // add the bridge to the _numbers matrix and update
-  addBridge(x1, y1, x2, y2, del, doubleBridge);
-  updateMarkers();
 }
 
 // ____________________________________________________________________________
@@ -232,14 +548,33 @@ void Hashi::addBridge(int x1, int y1, int x2, int y2, const bool del,
     bridge = 12;
   }
 
-  // update the _numbers matrix
+  // update the hash: remove the old bridge and add the new one
+  int inner = 0;
+  if (x1 == x2 && y1 + 1 < y2) {
+    inner = _numbers[y1 + 1][x1];
+  } else if (y1 == y2 && x1 + 1 < x2) {
+    inner = _numbers[y1][x1 + 1];
+  }
+  int before = inner > 9 ? inner % 2 + 1 : 0;
+  int after = bridge > 9 ? bridge % 2 + 1 : 0;
+  if (before > 0) {
+    _hash ^= zobristKey(x1, y1, x1 == x2, before, before);
+  }
+  if (after > 0) {
+    _hash ^= zobristKey(x1, y1, x1 == x2, after, after);
+  }
+
+  // update the _numbers matrix (and the bit planes if they are in use)
+  bool planes = !_boardStale;
   if (x1 == x2) {
     for (int i = y1 + 1; i < y2; i++) {
       _numbers[i][x1] = bridge;
+      if (planes) {_board.set(x1, i, bridge); }
     }
   } else {
     for (int i = x1 + 1; i < x2; i++) {
       _numbers[y1][i] = bridge;
+      if (planes) {_board.set(i, y1, bridge); }
     }
   }
 }
@@ -261,35 +596,27 @@ int Hashi::isBridgeValid(int x1, int y1, int x2, int y2) const {
   }
 
   // check for coordinates that represent invalid bridges
-  if ((x1 == x2 && y1 == y2) || (x1 != x2 && y1 != y2) || x1 > _max_x
-  || x2 > _max_x || y1 > _max_y || y2 > _max_y || x1 < 0 || x2 < 0 || y1 < 0
+  if ((x1 == x2 && y1 == y2) || (x1 != x2 && y1 != y2) || x1 >= _max_x
+  || x2 >= _max_x || y1 >= _max_y || y2 >= _max_y || x1 < 0 || x2 < 0 || y1 < 0
   || y2 < 0 || _numbers[y1][x1] == 0 || _numbers[y2][x2] == 0
   || _numbers[y1][x1] > 8 || _numbers[y2][x2] > 8) {
     return 1;
   }
 
-  // determine and return the bridge type
-  if (x1 == x2) {
-    for (int i = y1 + 1; i < y2-1; i++) {
-      if (_numbers[i][x1] != _numbers[i+1][x1]) {
-        return 1;
-      }
-    }
-    if (_numbers[y1+1][x1] > 11 || _numbers[y1+1][x1] == 0) {
-      return _numbers[y1+1][x1];
-    }
-  }
-  if (y1 == y2) {
-    for (int i = x1 + 1; i < x2-1; i++) {
-      if (_numbers[y1][i] != _numbers[y1][i+1]) {
-        return 1;
-      }
-    }
-    if (_numbers[y1][x1+1] < 12 || _numbers[y1][x1+1] == 0) {
-      return _numbers[y1][x1+1];
-    }
+  // determine and return the bridge type: the bit planes answer whether
+  // the segment is free with a few word operations per row or column
+  return board().segment(x1, y1, x2, y2);
+}
+
+// ____________________________________________________________________________
+const BitBoard& Hashi::board() const {
+  int height = _numbers.size();
+  int width = height > 0 ? _numbers[0].size() : 0;
+  if (_boardStale || _board.width() != width || _board.height() != height) {
+    _board.load(_numbers);
+    _boardStale = false;
   }
-  return 1;
+  return _board;
 }
 
 // ____________________________________________________________________________
@@ -319,28 +646,36 @@ int Hashi::countBridges(const int x, const int y) const {
 
 // ____________________________________________________________________________
 void Hashi::updateMarkers() {
-  for (int col = 0; col < _max_y; col++) {
-    for (int row = 0; row < _max_x; row++) {
-      if (_numbers[col][row] == countBridges(row, col)) {
-        markIsle(row, col, 2);
-      } else if (_numbers[col][row] < countBridges(row, col)) {
-        markIsle(row, col, 3);
-      } else {
-        markIsle(row, col, 1);
-      }
+  // isles outside of the viewport get their marker in redraw()
+  for (int col = _viewY; col < _viewY + _viewHeight; col++) {
+    for (int row = _viewX; row < _viewX + _viewWidth; row++) {
+      markIsle(row, col, markerColor(row, col));
     }
   }
   isSolved();
 }
 
+// ____________________________________________________________________________
+int Hashi::markerColor(const int x, const int y) const {
+  int bridges = countBridges(x, y);
+  if (_numbers[y][x] == bridges) {
+    return 2;
+  } else if (_numbers[y][x] < bridges) {
+    return 3;
+  }
+  return 1;
+}
+
 // ____________________________________________________________________________
 void Hashi::markIsle(const int x, const int y, const int color) const {
   if (x >= 0 && y >= 0 && x < _max_x && y < _max_y && _numbers[y][x] < 10
-  && _numbers[y][x] > 0) {
+  && _numbers[y][x] > 0 && isVisible(x, y)) {
+    int row = 3 * (y - _viewY) + 2;
+    int col = 5 * (x - _viewX) + 3;
     attron(COLOR_PAIR(color));
-    mvprintw(3*y+2, 5*x+3, "     ");
-    mvprintw(3*y+3, 5*x+3, "  %d  ", _numbers[y][x]);
-    mvprintw(3*y+4, 5*x+3, "     ");
+    mvprintw(row, col, "     ");
+    mvprintw(row + 1, col, "  %d  ", _numbers[y][x]);
+    mvprintw(row + 2, col, "     ");
     attroff(COLOR_PAIR(color));
   }
 }
@@ -351,18 +686,23 @@ void Hashi::reset() {
   for (int row = 0; row < _max_y; row++) {
     for (int col = 0; col < _max_x; col++) {
       if (_numbers[row][col] > 9) {
-        mvprintw(3*row+2, 5*col+3, "     ");
-        mvprintw(3*row+3, 5*col+3, "     ", _numbers[row][col]);
-        mvprintw(3*row+4, 5*col+3, "     ");
+        if (isVisible(col, row)) {
+          int screenRow = 3 * (row - _viewY) + 2;
+          int screenCol = 5 * (col - _viewX) + 3;
+          mvprintw(screenRow, screenCol, "     ");
+          mvprintw(screenRow + 1, screenCol, "     ");
+          mvprintw(screenRow + 2, screenCol, "     ");
+        }
         _numbers[row][col] = 0;
       }
     }
   }
+  _boardStale = true;
+  if (_position) {_position->reset(); }
+  _hash = 0;
   // reset undo list
   for (unsigned int col = 0; col < _undos.size(); col++) {
-    for (int row = 0; row < 4; row++) {
-      _undos[col][row] = 0;
-    }
+    _undos[col] = Bridge(0, 0, 0, 0, 0);
   }
 }
 
@@ -371,11 +711,11 @@ void Hashi::undo() {
   int last_row = _undos.size() -1;
   // drawing a bridge two times equals an undo operation
   for (int i = 0; i < 2; i++) {
-    drawBridge(_undos[last_row][0], _undos[last_row][1],
-    _undos[last_row][2], _undos[last_row][3]);
+    drawBridge(_undos[last_row].x1, _undos[last_row].y1,
+    _undos[last_row].x2, _undos[last_row].y2);
   }
   // insert new empty row at the beginning and delete the last one
-  _undos.insert(_undos.begin(), {0, 0, 0, 0});
+  _undos.insert(_undos.begin(), Bridge(0, 0, 0, 0, 0));
   _undos.erase(_undos.end()-1);
 }
 
@@ -385,36 +725,167 @@ bool Hashi::isSolved() {
     for (int row = 0; row < _max_x; row++) {
       if (_numbers[col][row] != countBridges(row, col)
       && _numbers[col][row] < 10) {
+        _solved = false;
         solvedMessage(true);
         return false;
       }
     }
   }
+  _solved = true;
   solvedMessage(false);
   return true;
 }
 
 // ____________________________________________________________________________
 void Hashi::solve() {
-  if (_sol.size() > 0) {
-    reset();
-    for (unsigned int i = 0; i < _sol.size(); i++) {
-      drawBridge(_sol[i][0], _sol[i][1], _sol[i][2], _sol[i][3]);
+  if (_sol.size() == 0 && _checker) {
+    // a check of the game loop may already have found a solution
+    if (!_checker->solution(&_sol)) {
+      // showFeedback() draws the solution when the search is done
+      _solving = true;
+      _checker->setClauseSolver(_clauseSolver);
+      _checker->check(0, std::vector<Bridge>(), kSolveBudget);
+      mvprintw(3 * _viewHeight + 8, 3, " Searching a solution ...     ");
+      return;
+    }
+  } else if (_sol.size() == 0) {
+    bool solved;
+    if (_clauseSolver) {
+      ClauseSolver solver(_numbers);
+      solved = solver.solve(&_sol);
+    } else {
+      RegionSolver solver(_numbers);
+      solved = solver.solve(_threads, &_sol);
     }
-    if (isSolved() == false) {
-      mvprintw((_max_y) * 3 + 8, 2, " The solution file does not solve the "
-      "puzzle!");
+    if (solved) {
+      // overwrite the missing solution file message
+      mvprintw(3 * _viewHeight + 8, 3, "                        ");
+    } else {
+      mvprintw(3 * _viewHeight + 8, 3, " The puzzle has no solution! ");
     }
   }
+  if (_sol.size() > 0) {
+    mvprintw(3 * _viewHeight + 8, 3, "                        ");
+    drawSolution();
+  }
 }
 
 // ____________________________________________________________________________
-void Hashi::solvedMessage(const bool del) {
+void Hashi::drawSolution() {
+  reset();
+  for (unsigned int i = 0; i < _sol.size(); i++) {
+    for (int j = 0; j < _sol[i].count; j++) {
+      drawBridge(_sol[i].x1, _sol[i].y1, _sol[i].x2, _sol[i].y2);
+    }
+  }
+  if (isSolved() == false) {
+    mvprintw(3 * _viewHeight + 8, 2, " The solution file does not solve the "
+    "puzzle!");
+  } else if (_cacheFile[0] != '\0') {
+    SolutionCache cache(_cacheFile);
+    cache.insert(_numbers, _sol);
+  }
+}
+
+// ____________________________________________________________________________
+void Hashi::solvedMessage(const bool del) const {
   if (del) {
-    mvprintw((_max_y) * 3 + 5, 23,   "                                ");
+    mvprintw(3 * _viewHeight + 5, 23,   "                                ");
   } else {
     attron(COLOR_PAIR(2));
-    mvprintw((_max_y) * 3 + 5, 23,   " *SOLVED*  Press ESC to exit ...");
+    if (_playlist && _playlist->hasNext()) {
+      mvprintw(3 * _viewHeight + 5, 23, " *SOLVED*  Press n for the next!");
+    } else {
+      mvprintw(3 * _viewHeight + 5, 23, " *SOLVED*  Press ESC to exit ...");
+    }
     attroff(COLOR_PAIR(2));
   }
 }
+
+// ____________________________________________________________________________
+std::vector<Bridge> Hashi::bridges() const {
+  std::vector<Bridge> bridges;
+  // every bridge starts at its left / top isle
+  for (int row = 0; row < _max_y; row++) {
+    for (int col = 0; col < _max_x; col++) {
+      if (_numbers[row][col] == 0 || _numbers[row][col] > 9) {continue; }
+      int x2 = col + 1;
+      while (x2 < _max_x && _numbers[row][x2] > 9 && _numbers[row][x2] < 12) {
+        x2++;
+      }
+      if (x2 > col + 1 && x2 < _max_x) {
+        bridges.push_back(Bridge(col, row, x2, row,
+         _numbers[row][col + 1] % 2 + 1));
+      }
+      int y2 = row + 1;
+      while (y2 < _max_y && _numbers[y2][col] > 11) {
+        y2++;
+      }
+      if (y2 > row + 1 && y2 < _max_y) {
+        bridges.push_back(Bridge(col, row, col, y2,
+         _numbers[row + 1][col] % 2 + 1));
+      }
+    }
+  }
+  return bridges;
+}
+
+// ____________________________________________________________________________
+std::shared_ptr<const GameSnapshot> Hashi::snapshot() const {
+  std::shared_ptr<GameSnapshot> snapshot(new GameSnapshot);
+  snapshot->puzzle = SolutionCache::contentHash(_numbers);
+  snapshot->bridges = bridges();
+  snapshot->undos = _undos;
+  snapshot->elapsed = _elapsed + std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - _started).count();
+  return snapshot;
+}
+
+// ____________________________________________________________________________
+bool Hashi::restore(const GameSnapshot& snapshot) {
+  if (snapshot.puzzle != SolutionCache::contentHash(_numbers)) {
+    return false;
+  }
+  // remove the bridges without touching the screen
+  for (int row = 0; row < _max_y; row++) {
+    for (int col = 0; col < _max_x; col++) {
+      if (_numbers[row][col] > 9) {
+        _numbers[row][col] = 0;
+      }
+    }
+  }
+  _boardStale = true;
+  _hash = 0;
+  // rows of a damaged save file must not leave the number field
+  int maxX = _max_x;
+  int maxY = _max_y;
+  auto inside = [maxX, maxY](const Bridge& b) {
+    return b.x1 >= 0 && b.x2 >= 0 && b.x1 < maxX && b.x2 < maxX
+        && b.y1 >= 0 && b.y2 >= 0 && b.y1 < maxY && b.y2 < maxY;
+  };
+  // every count draws the bridge once more (like in solve())
+  for (unsigned int i = 0; i < snapshot.bridges.size(); i++) {
+    const Bridge& b = snapshot.bridges[i];
+    if (!inside(b)) {continue; }
+    for (int j = 0; j < b.count; j++) {
+      int type = isBridgeValid(b.x1, b.y1, b.x2, b.y2);
+      if (type == 1) {break; }
+      addBridge(std::min(b.x1, b.x2), std::min(b.y1, b.y2),
+       std::max(b.x1, b.x2), std::max(b.y1, b.y2), type == 11 || type == 13,
+       type == 10 || type == 12);
+    }
+  }
+  // keep the newest undo operations if the amount of undos changed
+  for (unsigned int i = 0; i < _undos.size(); i++) {
+    _undos[i] = Bridge(0, 0, 0, 0, 0);
+  }
+  int kept = std::min(_undos.size(), snapshot.undos.size());
+  for (int i = 1; i <= kept; i++) {
+    if (inside(snapshot.undos[snapshot.undos.size() - i])) {
+      _undos[_undos.size() - i] = snapshot.undos[snapshot.undos.size() - i];
+    }
+  }
+  _elapsed = snapshot.elapsed;
+  _started = std::chrono::steady_clock::now();
+  return true;
+}
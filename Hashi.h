@@ -5,8 +5,23 @@
 #define HASHI_H_
 
 #include <gtest/gtest.h>
+#include <stdint.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <memory>
+#include <string>
 #include <vector>
+#include "./BackgroundSolver.h"
+#include "./BitBoard.h"
+#include "./Bridge.h"
 #include "./FileInterpreter.h"
+#include "./PhaseTimer.h"
+#include "./Playlist.h"
+#include "./PositionCheck.h"
+#include "./SaveGame.h"
+
+class FileInterpreter;
+// the ncurses screen (SCREEN)
+struct screen;
 
 class Hashi {
   // Allow the FileInterpreter class to initialize the private array
@@ -20,16 +35,51 @@ class Hashi {
   // Destructor
   ~Hashi();
 
-  // Prepare the terminal for drawing with ncurses, draw the number
-  // field and the menu.
-  void initializeGame() const;
+  // Prepare the terminal for drawing with ncurses, fit the viewport to the
+  // terminal and draw the visible part of the number field and the menu.
+  void initializeGame();
+
+  // Load the puzzle of the command line arguments on another thread while
+  // the terminal is prepared, then show the first frame (see
+  // initializeGame()). The phases "load", "terminal" and "first frame" are
+  // recorded by the timer.
+  // Returns:
+  //   bool - false if the puzzle can't be loaded or the terminal can't be
+  //          opened (the terminal is restored and error is set then)
+  bool startGame(const FileInterpreter& files, PhaseTimer* timer,
+   std::string* error);
+  FRIEND_TEST(Hashi, startGame);
 
-  // plays the game in a while loop
+  // plays the game in a while loop. With a save file, every change is
+  // autosaved in the background.
   void play();
 
+  // Take a snapshot of the bridges, the undo list and the elapsed time.
+  std::shared_ptr<const GameSnapshot> snapshot() const;
+
+  // Continue a saved game: draws the saved bridges and takes over the undo
+  // list and the elapsed time.
+  // Returns:
+  //   bool - false if the snapshot belongs to another puzzle (nothing is
+  //          changed then)
+  bool restore(const GameSnapshot& snapshot);
+  FRIEND_TEST(Hashi, snapshotAndRestore);
+
  private:
   // name of the solution file
   const char* _solutionFile;
+  // name of the solution cache file ("" if there is none)
+  const char* _cacheFile;
+  // name of the save file ("" if there is none)
+  const char* _saveFile;
+
+  // the ncurses screen (NULL before initializeTerminal())
+  struct screen* _screen;
+
+  // seconds played before the current session
+  double _elapsed;
+  // start of the current session
+  std::chrono::steady_clock::time_point _started;
 
   // vector of vectors that store the field numbers
   std::vector< std::vector<int> > _numbers;
@@ -37,17 +87,58 @@ class Hashi {
   int _max_x;
   int _max_y;
 
+  // Bit-plane copy of _numbers for the obstruction checks of
+  // isBridgeValid(). It is a cache: addBridge() keeps it up to date, any
+  // other change of _numbers sets _boardStale and board() rebuilds it.
+  mutable BitBoard _board;
+  mutable bool _boardStale;
+
   // coordinates of the selected isle
   int _lastClicked_x;
   int _lastClicked_y;
 
-  // matrix that stores the solution coordinates
-  std::vector< std::vector<int> > _sol;
+  // The viewport: the visible part of the number field. Large boards don't
+  // fit the terminal, only the grid cells from (_viewX, _viewY) on are
+  // drawn.
+  int _viewX;
+  int _viewY;
+  int _viewWidth;
+  int _viewHeight;
+
+  // result of the last isSolved() call
+  bool _solved;
+
+  // the bridges of the solution
+  std::vector<Bridge> _sol;
+
+  // the last drawn valid bridges (the newest one at the end, empty entries
+  // have the count 0)
+  std::vector<Bridge> _undos;
 
-  // matrix that stores the coordinates of the last drawn valid bridges
-  std::vector< std::vector<int> > _undos;
+  // amount of worker threads for the Solver
+  int _threads;
+  // solve() searches with the ClauseSolver (see --solver)
+  bool _clauseSolver;
 
-  // Proccesses the user input (keyboard and mouse).
+  // Zobrist hash of the drawn bridges (see zobristKey()), identifies the
+  // position of a check of the BackgroundSolver
+  uint64_t _hash;
+
+  // Checks in the background whether the drawn bridges can still be
+  // completed to a solution (only while play() runs, NULL otherwise).
+  std::unique_ptr<BackgroundSolver> _checker;
+  // Updated by drawBridge() and reset(): reports right away if a bridge
+  // can't be part of a solution (only while play() runs, NULL otherwise).
+  std::unique_ptr<PositionCheck> _position;
+  // true while the solve mode waits for the background search
+  bool _solving;
+  // the feedback line below the menu (see showFeedback())
+  std::string _feedback;
+  // the puzzles played after the current one (NULL without a playlist)
+  std::unique_ptr<Playlist> _playlist;
+
+  // Proccesses the user input (keyboard and mouse). The arrow keys, page
+  // up / down and the mouse wheel scroll the viewport.
   // Arguments:
   //   const int key - the last pressed key
   // Returns: int - a specific feedback depending on the pressed key:
@@ -55,10 +146,51 @@ class Hashi {
   //   'r'  1
   //   's'  2
   //   'u'  3
+  //   viewport moved or resized  4
+  //   'n'  5
   //   (Returns 0 in any other case)
   int processUserInput(const int key);
   FRIEND_TEST(Hashi, processUserInput);
 
+  // Replace the number field by a puzzle of the playlist: takes over its
+  // isles, solution and prepared checks and starts without bridges, with
+  // an empty undo list and a new clock.
+  void load(PreparedPuzzle* puzzle);
+  FRIEND_TEST(Hashi, load);
+
+  // Prepare the terminal for drawing with ncurses.
+  // Returns:
+  //   bool - false if the terminal can't be opened
+  bool initializeTerminal();
+
+  // Fit the viewport to the terminal, draw the first frame and show it.
+  void drawFirstFrame();
+
+  // Load and draw the next puzzle of the _playlist.
+  // Returns:
+  //   bool - false if there is none (nothing is changed then)
+  bool nextPuzzle();
+
+  // Fit the viewport to the terminal size and keep it inside the number
+  // field.
+  void updateViewport();
+
+  // Move the viewport by the given amount of grid cells (it stays inside
+  // the number field).
+  // Returns:
+  //   bool - true if the viewport moved
+  bool moveViewport(const int dx, const int dy);
+  FRIEND_TEST(Hashi, moveViewport);
+
+  // Returns: bool - true if the grid cell (x, y) is inside the viewport
+  bool isVisible(const int x, const int y) const;
+
+  // Clear the screen and draw the menu and the visible grid cells. The
+  // cost depends on the terminal size, not on the size of the puzzle: the
+  // grid cells are composed off screen and written a line at a time.
+  void redraw() const;
+  FRIEND_TEST(Hashi, redraw);
+
   // Draw a bridge if possible (calls the isBridgeValid() function).
   // Automatically draws the correct bridge type by using the return value
   // of isBridgeValid()
@@ -69,7 +201,19 @@ class Hashi {
   //   int y2 - the y coordinate of the second isle
   void drawBridge(int x1, int y1, int x2, int y2);
 
-  // Adds a bridge to the _numbers matrix according
+  // Print the visible part of a bridge, the coordinates have to be ordered
+  // (x1 <= x2, y1 <= y2).
+  //   const bool del - overwrite the bridge
+  //   const bool doubleBridge - print a double bridge
+  void paintBridge(const int x1, const int y1, const int x2, const int y2,
+   const bool del, const bool doubleBridge) const;
+
+  // Print the part of a bridge that crosses the grid cell (x, y) if the
+  // cell is visible (see paintBridge() for del and doubleBridge).
+  void paintCell(const int x, const int y, const bool vertical,
+   const bool del, const bool doubleBridge) const;
+
+  // Adds a bridge to the _numbers matrix according and updates the _hash
   // Arguments:
   //   const bool del - if del is true, the bridge will be deleted in the
   //                    _numbers matrix
@@ -78,6 +222,7 @@ class Hashi {
   void addBridge(int x1, int y1, int x2, int y2, const bool del,
    const bool doubleBridge);
   FRIEND_TEST(Hashi, addBridge);
+  FRIEND_TEST(Hashi, hash);
 
   // Method that checks if a bridge with the given coordinates is valid.
   // Arguments:
@@ -93,6 +238,10 @@ class Hashi {
   int isBridgeValid(int x1, int y1, int x2, int y2) const;
   FRIEND_TEST(Hashi, isBridgeValid);
 
+  // Returns: const BitBoard& - the bit planes of the current _numbers
+  // matrix (rebuilt if they are stale or the matrix changed its size)
+  const BitBoard& board() const;
+
   // Count the bridges on a island at the position (x,y) on the number field.
   // Arguments:
   //   const int x - the x coordinate of the isle
@@ -103,10 +252,14 @@ class Hashi {
   int countBridges(const int x, const int y) const;
   FRIEND_TEST(Hashi, countBridges);
 
-  // Redraws all markers on the number field by using the countBridge()
+  // Redraws the markers of the visible isles by using the markerColor()
   // and the markIsle() method.
   void updateMarkers();
 
+  // Returns: int - the marker color of the isle at (x, y) according to its
+  //                bridges (see markIsle())
+  int markerColor(const int x, const int y) const;
+
   // Method that marks a isle at given coordinates.
   // Arguments:
   //   const int x - the x coordinate of the isle
@@ -115,6 +268,19 @@ class Hashi {
   //     available colors: white(1), green(2), red(3), yellow(4), black(5)
   void markIsle(const int x, const int y, const int color) const;
 
+  // Returns: std::vector<Bridge> - the drawn bridges, each starting at its
+  // left / top isle
+  std::vector<Bridge> bridges() const;
+
+  // Print whether the current position is still solvable according to
+  // the _position check (which says "no" right after the move) and the
+  // _checker ("yes", "no" or "unknown" while the search is running or
+  // ran out of time). Also finishes the solve mode when the background
+  // search of the solve mode is done. Without a _checker only the
+  // PositionCheck verdict is shown.
+  void showFeedback();
+  FRIEND_TEST(Hashi, showFeedback);
+
   // Delete all bridges and reset the undo list.
   void reset();
   FRIEND_TEST(Hashi, reset);
@@ -131,24 +297,39 @@ class Hashi {
   FRIEND_TEST(Hashi, isSolved);
 
   // If a valid solution file is given, reset() will be called and
-  // all valid bridges will be drawn. If the solution is valid but does not
-  // solve the puzzle, a message will be printed below the menu.
+  // all valid bridges will be drawn (see drawSolution()). Without a
+  // solution file, the solution is searched by the RegionSolver (using
+  // _threads worker threads) or the ClauseSolver (_clauseSolver) first:
+  // during play() in the background by the _checker, so the game stays
+  // responsive, otherwise right away.
   void solve();
+  FRIEND_TEST(Hashi, solve);
+
+  // Reset the bridges and draw the solution _sol. If the solution does not
+  // solve the puzzle, a message will be printed below the menu. Solutions
+  // that solve the puzzle are stored in the solution cache.
+  void drawSolution();
 
   // Prints a message on green background.
   // Arguments:
   //   const bool del - overwrite (delete) the message (e.g. if the player
   //                    decides to build new bridges after the puzzle is
   //                    already solved)
-  void solvedMessage(const bool del);
+  void solvedMessage(const bool del) const;
 
   // Allow tests to access private member variables
   FRIEND_TEST(FileInterpreter, processFiles);
+  FRIEND_TEST(FileInterpreter, processFilesCache);
+  FRIEND_TEST(FileInterpreter, processFilesPlaylist);
   FRIEND_TEST(FileInterpreter, setFieldxy);
   FRIEND_TEST(FileInterpreter, readInvalidFilexy);
   FRIEND_TEST(FileInterpreter, setFieldPlain);
   FRIEND_TEST(FileInterpreter, readInvalidFilePlain);
   FRIEND_TEST(FileInterpreter, setSolution);
+  FRIEND_TEST(FileInterpreter, processFilesBuiltin);
+  FRIEND_TEST(FileInterpreter, parseCommandLineArgumentsSolver);
+  FRIEND_TEST(Solver, solve);
+  FRIEND_TEST(Solver, solveParallel);
 };
 
 #endif  // HASHI_H_
@@ -1,17 +1,45 @@
 // Copyright 2018 Tim Samuel Winter
 // Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
 
+#include <iostream>
+#include <string>
 #include "./FileInterpreter.h"
 #include "./Hashi.h"
+#include "./PhaseTimer.h"
 
 int main(int argc, char** argv) {
-  Hashi game1;
+  // the phases of the startup (reported with --timing)
+  PhaseTimer timer;
+  int phase = timer.begin("arguments");
   FileInterpreter fi;
   fi.parseCommandLineArguments(argc, argv);
-  // Create new game object.
-  fi.processFiles(&game1);
-  // Initialize terminal and grid.
-  game1.initializeGame();
-  // Start the game.
-  game1.play();
+  timer.end(phase);
+  // Answer solve requests instead of playing.
+  if (fi.isServiceMode()) {
+    fi.runService();
+    return 0;
+  }
+  // Usage errors stop the program before the terminal is taken over.
+  fi.checkInputFormat();
+  std::string error;
+  bool started;
+  {
+    // Create new game object, load the puzzle while the terminal is
+    // prepared and start the game.
+    Hashi game1;
+    started = game1.startGame(fi, &timer, &error);
+    if (started) {
+      phase = timer.begin("play");
+      game1.play();
+      timer.end(phase);
+    }
+  }
+  if (!started) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+  if (fi.timing()) {
+    timer.report(&std::cerr);
+  }
+  return 0;
 }
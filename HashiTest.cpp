@@ -1,7 +1,16 @@
 // Copyright 2018 Tim Samuel Winter
 // Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
 
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <ncurses.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
 #include "./Hashi.h"
 
 // _____________________________________________________________________________
@@ -60,6 +69,7 @@ TEST(Hashi, isBridgeValid) {
   ASSERT_EQ(0, gameTest3.isBridgeValid(3, 0, 3, 2));
   ASSERT_EQ(0, gameTest3.isBridgeValid(3, 2, 3, 0));
   ASSERT_EQ(1, gameTest3.isBridgeValid(0, 0, 0, 0));
+  ASSERT_EQ(1, gameTest3.isBridgeValid(0, 0, 7, 0));
 
   gameTest3.addBridge(2, 3, 4, 3, false, false);
   ASSERT_EQ(10, gameTest3.isBridgeValid(2, 3, 4, 3));
@@ -69,6 +79,8 @@ TEST(Hashi, isBridgeValid) {
   ASSERT_EQ(12, gameTest3.isBridgeValid(3, 2, 3, 4));
   gameTest3.addBridge(3, 2, 3, 4, false, true);
   ASSERT_EQ(13, gameTest3.isBridgeValid(3, 2, 3, 4));
+  // the vertical bridge blocks the horizontal one
+  ASSERT_EQ(1, gameTest3.isBridgeValid(2, 3, 4, 3));
 }
 
 // _____________________________________________________________________________
@@ -100,8 +112,8 @@ TEST(Hashi, reset) {
   gameTest5._numbers = {{0, 0, 0, 3, 0, 0},
                         {0, 0, 0, 0, 0, 0},
                         {3, 0, 0, 5, 0, 0}};
-  gameTest5._undos  = {{3, 0, 3, 2},
-                       {0, 2, 3, 2}};
+  gameTest5._undos  = {{3, 0, 3, 2, 1},
+                       {0, 2, 3, 2, 1}};
   gameTest5.addBridge(3, 0, 3, 2, false, false);
   gameTest5.addBridge(0, 2, 3, 2, false, false);
   ASSERT_EQ(12, gameTest5._numbers[1][3]);
@@ -109,8 +121,9 @@ TEST(Hashi, reset) {
   gameTest5.reset();
   ASSERT_EQ(0, gameTest5._numbers[1][3]);
   ASSERT_EQ(0, gameTest5._numbers[2][2]);
-  ASSERT_EQ(0, gameTest5._undos[0][0]);
-  ASSERT_EQ(0, gameTest5._undos[1][2]);
+  ASSERT_EQ(0, gameTest5._undos[0].x1);
+  ASSERT_EQ(0, gameTest5._undos[1].x2);
+  ASSERT_EQ(0, gameTest5._undos[1].count);
 }
 
 // _____________________________________________________________________________
@@ -121,14 +134,14 @@ TEST(Hashi, undo) {
   gameTest6._numbers = {{0, 0, 0, 3, 0, 0},
                         {0, 0, 0, 0, 0, 0},
                         {3, 0, 0, 5, 0, 0}};
-  gameTest6._undos  = {{3, 0, 3, 2},
-                       {0, 2, 3, 2}};
+  gameTest6._undos  = {{3, 0, 3, 2, 1},
+                       {0, 2, 3, 2, 1}};
   gameTest6.addBridge(3, 0, 3, 2, false, false);
   gameTest6.addBridge(0, 2, 3, 2, false, false);
   gameTest6.undo();
-  ASSERT_EQ(0, gameTest6._undos[0][0]);
-  ASSERT_EQ(3, gameTest6._undos[1][0]);
-  ASSERT_EQ(2, gameTest6._undos[1][3]);
+  ASSERT_EQ(0, gameTest6._undos[0].x1);
+  ASSERT_EQ(3, gameTest6._undos[1].x1);
+  ASSERT_EQ(2, gameTest6._undos[1].y2);
 }
 
 // _____________________________________________________________________________
@@ -146,3 +159,316 @@ TEST(Hashi, isSolved) {
   gameTest7.addBridge(3, 0, 3, 2, false, false);
   ASSERT_TRUE(gameTest7.isSolved());
 }
+
+// _____________________________________________________________________________
+TEST(Hashi, hash) {
+  Hashi gameTest8;
+  gameTest8._max_x = 6;
+  gameTest8._max_y = 3;
+  gameTest8._numbers = {{4, 0, 0, 3, 0, 0},
+                        {0, 0, 0, 0, 0, 0},
+                        {2, 0, 0, 1, 0, 0}};
+  ASSERT_EQ(0, gameTest8._hash);
+  gameTest8.addBridge(0, 0, 3, 0, false, false);
+  uint64_t single = gameTest8._hash;
+  ASSERT_NE(0, single);
+  gameTest8.addBridge(0, 0, 0, 2, false, false);
+  gameTest8.addBridge(0, 0, 3, 0, false, true);
+  ASSERT_NE(single, gameTest8._hash);
+  // the order of the bridges does not matter
+  gameTest8.addBridge(0, 0, 3, 0, true, false);
+  gameTest8.addBridge(0, 0, 3, 0, false, false);
+  gameTest8.addBridge(0, 0, 0, 2, true, false);
+  ASSERT_EQ(single, gameTest8._hash);
+  gameTest8.reset();
+  ASSERT_EQ(0, gameTest8._hash);
+}
+
+// _____________________________________________________________________________
+TEST(Hashi, snapshotAndRestore) {
+  Hashi gameTest9;
+  gameTest9._max_x = 6;
+  gameTest9._max_y = 3;
+  gameTest9._numbers = {{4, 0, 0, 3, 0, 0},
+                        {0, 0, 0, 0, 0, 0},
+                        {2, 0, 0, 1, 0, 0}};
+  gameTest9._undos.resize(3);
+  gameTest9.addBridge(0, 0, 3, 0, false, true);
+  gameTest9.addBridge(0, 0, 0, 2, false, false);
+  gameTest9._undos[2] = Bridge(0, 0, 0, 2, 1);
+  std::shared_ptr<const GameSnapshot> snapshot = gameTest9.snapshot();
+  std::vector<Bridge> bridges = {{0, 0, 3, 0, 2}, {0, 0, 0, 2, 1}};
+  ASSERT_EQ(bridges, snapshot->bridges);
+  ASSERT_EQ(gameTest9._undos, snapshot->undos);
+
+  Hashi gameTest10;
+  gameTest10._max_x = 6;
+  gameTest10._max_y = 3;
+  gameTest10._numbers = {{4, 0, 0, 3, 0, 0},
+                         {0, 0, 0, 0, 0, 0},
+                         {2, 0, 0, 1, 0, 0}};
+  gameTest10._undos.resize(2);
+  ASSERT_TRUE(gameTest10.restore(*snapshot));
+  ASSERT_EQ(gameTest9._numbers, gameTest10._numbers);
+  ASSERT_EQ(gameTest9._hash, gameTest10._hash);
+  // only the newest undo operations fit
+  ASSERT_EQ(Bridge(0, 0, 0, 2, 1), gameTest10._undos[1]);
+  ASSERT_EQ(Bridge(0, 0, 0, 0, 0), gameTest10._undos[0]);
+  ASSERT_GE(gameTest10.snapshot()->elapsed, snapshot->elapsed);
+
+  // a snapshot of another puzzle is rejected
+  gameTest10._numbers[2][3] = 2;
+  ASSERT_FALSE(gameTest10.restore(*snapshot));
+}
+
+// _____________________________________________________________________________
+TEST(Hashi, moveViewport) {
+  Hashi gameTest11;
+  gameTest11._max_x = 40;
+  gameTest11._max_y = 30;
+  gameTest11._numbers.assign(30, std::vector<int>(40));
+  gameTest11._viewWidth = 10;
+  gameTest11._viewHeight = 5;
+  ASSERT_FALSE(gameTest11.moveViewport(-1, 0));
+  ASSERT_TRUE(gameTest11.moveViewport(3, 2));
+  ASSERT_EQ(3, gameTest11._viewX);
+  ASSERT_EQ(2, gameTest11._viewY);
+  ASSERT_TRUE(gameTest11.isVisible(3, 2));
+  ASSERT_TRUE(gameTest11.isVisible(12, 6));
+  ASSERT_FALSE(gameTest11.isVisible(13, 6));
+  ASSERT_FALSE(gameTest11.isVisible(2, 2));
+  // the viewport stays inside the number field
+  ASSERT_TRUE(gameTest11.moveViewport(100, 100));
+  ASSERT_EQ(30, gameTest11._viewX);
+  ASSERT_EQ(25, gameTest11._viewY);
+  ASSERT_FALSE(gameTest11.moveViewport(1, 1));
+  // the arrow keys scroll by one cell
+  ASSERT_EQ(4, gameTest11.processUserInput(KEY_LEFT));
+  ASSERT_EQ(29, gameTest11._viewX);
+  ASSERT_EQ(0, gameTest11.processUserInput(KEY_DOWN));
+  ASSERT_EQ(4, gameTest11.processUserInput(KEY_PPAGE));
+  ASSERT_EQ(20, gameTest11._viewY);
+}
+
+// _____________________________________________________________________________
+TEST(Hashi, showFeedback) {
+  Hashi gameTest12;
+  gameTest12._max_x = 6;
+  gameTest12._max_y = 3;
+  gameTest12._numbers = {{4, 0, 0, 3, 0, 0},
+                         {0, 0, 0, 0, 0, 0},
+                         {2, 0, 0, 1, 0, 0}};
+  gameTest12._undos.resize(3);
+  gameTest12._checker.reset(new BackgroundSolver(gameTest12._numbers, 1));
+  // a single bridge that has to become a double bridge
+  gameTest12.addBridge(0, 0, 3, 0, false, false);
+  gameTest12._checker->check(gameTest12._hash, gameTest12.bridges(), 60);
+  gameTest12._checker->wait();
+  gameTest12.showFeedback();
+  ASSERT_NE(std::string::npos, gameTest12._feedback.find(": yes"));
+  gameTest12.addBridge(3, 0, 3, 2, false, true);
+  gameTest12.showFeedback();
+  ASSERT_NE(std::string::npos, gameTest12._feedback.find(": unknown"));
+  gameTest12._checker->check(gameTest12._hash, gameTest12.bridges(), 60);
+  gameTest12._checker->wait();
+  gameTest12.showFeedback();
+  ASSERT_NE(std::string::npos, gameTest12._feedback.find(": no"));
+
+  // the first check found a solution already
+  gameTest12.solve();
+  ASSERT_FALSE(gameTest12._solving);
+  ASSERT_TRUE(gameTest12.isSolved());
+
+  // the solve mode does not wait for the search
+  gameTest12._sol.clear();
+  gameTest12.reset();
+  gameTest12._checker.reset(new BackgroundSolver(gameTest12._numbers, 1));
+  gameTest12.solve();
+  ASSERT_TRUE(gameTest12._solving);
+  gameTest12._checker->wait();
+  gameTest12.showFeedback();
+  ASSERT_FALSE(gameTest12._solving);
+  ASSERT_EQ(3, gameTest12._sol.size());
+  ASSERT_TRUE(gameTest12.isSolved());
+
+  // the same with the ClauseSolver, in the background and right away
+  gameTest12._clauseSolver = true;
+  gameTest12._sol.clear();
+  gameTest12.reset();
+  gameTest12._checker.reset(new BackgroundSolver(gameTest12._numbers, 1));
+  gameTest12.solve();
+  gameTest12._checker->wait();
+  gameTest12.showFeedback();
+  ASSERT_EQ(3, gameTest12._sol.size());
+  ASSERT_TRUE(gameTest12.isSolved());
+  gameTest12._sol.clear();
+  gameTest12.reset();
+  gameTest12._checker.reset();
+  gameTest12.solve();
+  ASSERT_EQ(3, gameTest12._sol.size());
+  ASSERT_TRUE(gameTest12.isSolved());
+  gameTest12._clauseSolver = false;
+  gameTest12._checker.reset(new BackgroundSolver(gameTest12._numbers, 1));
+
+  // a wrong bridge is reported without a search
+  gameTest12._position.reset(new PositionCheck(gameTest12._numbers));
+  gameTest12.reset();
+  gameTest12.drawBridge(0, 2, 3, 2);
+  gameTest12.showFeedback();
+  ASSERT_NE(std::string::npos, gameTest12._feedback.find(": no ("));
+  gameTest12.drawBridge(0, 2, 3, 2);
+  gameTest12.drawBridge(0, 2, 3, 2);
+  ASSERT_TRUE(gameTest12._position->possible());
+
+  // outside play() there may be no checker: only the PositionCheck speaks
+  gameTest12._checker.reset();
+  gameTest12.drawBridge(0, 2, 3, 2);
+  gameTest12.showFeedback();
+  ASSERT_NE(std::string::npos, gameTest12._feedback.find(": no ("));
+  gameTest12.reset();
+  gameTest12.showFeedback();
+  ASSERT_NE(std::string::npos, gameTest12._feedback.find(": unknown"));
+  gameTest12._position.reset();
+  gameTest12.showFeedback();
+  ASSERT_NE(std::string::npos, gameTest12._feedback.find(": unknown"));
+}
+
+// _____________________________________________________________________________
+TEST(Hashi, load) {
+  Hashi gameTest13;
+  gameTest13._max_x = 6;
+  gameTest13._max_y = 3;
+  gameTest13._numbers = {{4, 0, 0, 3, 0, 0},
+                         {0, 0, 0, 0, 0, 0},
+                         {2, 0, 0, 1, 0, 0}};
+  gameTest13._undos.resize(3);
+  gameTest13.addBridge(0, 0, 3, 0, false, false);
+  gameTest13._undos[2] = Bridge(0, 0, 3, 0, 1);
+  gameTest13._lastClicked_x = 3;
+  gameTest13._viewY = 1;
+  gameTest13._elapsed = 60;
+  gameTest13._solved = true;
+
+  PreparedPuzzle puzzle;
+  puzzle.numbers = {{1, 0, 1}};
+  puzzle.solution = {{0, 0, 2, 0, 1}};
+  puzzle.position.reset(new PositionCheck(puzzle.numbers));
+  puzzle.checker.reset(new BackgroundSolver(puzzle.numbers, 1));
+  PositionCheck* position = puzzle.position.get();
+  gameTest13.load(&puzzle);
+  ASSERT_EQ(3, gameTest13._max_x);
+  ASSERT_EQ(1, gameTest13._max_y);
+  ASSERT_EQ(std::vector<int>({1, 0, 1}), gameTest13._numbers[0]);
+  ASSERT_EQ(std::vector<Bridge>({{0, 0, 2, 0, 1}}), gameTest13._sol);
+  ASSERT_EQ(position, gameTest13._position.get());
+  ASSERT_TRUE(gameTest13._checker != NULL);
+  ASSERT_EQ(0u, gameTest13._hash);
+  ASSERT_FALSE(gameTest13._solved);
+  ASSERT_EQ(-1, gameTest13._lastClicked_x);
+  ASSERT_EQ(0, gameTest13._viewY);
+  ASSERT_EQ(0, gameTest13._elapsed);
+  ASSERT_EQ(3, gameTest13._undos.size());
+  ASSERT_EQ(0, gameTest13._undos[2].count);
+  // the new puzzle is played as usual
+  ASSERT_EQ(0, gameTest13.isBridgeValid(0, 0, 2, 0));
+  gameTest13.addBridge(0, 0, 2, 0, false, false);
+  ASSERT_TRUE(gameTest13.isSolved());
+  // without a playlist there is no next puzzle
+  ASSERT_EQ(5, gameTest13.processUserInput('n'));
+  ASSERT_FALSE(gameTest13.nextPuzzle());
+}
+
+// _____________________________________________________________________________
+TEST(Hashi, redraw) {
+  FILE* out = fopen("/dev/null", "w");
+  SCREEN* screen = newterm("xterm", out, stdin);
+  ASSERT_TRUE(screen != NULL);
+  Hashi gameTest14;
+  gameTest14._max_x = 4;
+  gameTest14._max_y = 3;
+  gameTest14._numbers = {{4, 0, 0, 3},
+                         {0, 0, 0, 0},
+                         {2, 0, 0, 1}};
+  gameTest14.addBridge(0, 0, 3, 0, false, false);
+  gameTest14.addBridge(0, 0, 0, 2, false, true);
+  gameTest14._lastClicked_x = 3;
+  gameTest14._lastClicked_y = 0;
+  gameTest14._viewWidth = 4;
+  gameTest14._viewHeight = 3;
+  gameTest14.redraw();
+  // the grid cell (x, y) starts at the terminal cell (5 * x + 3, 3 * y + 2)
+  ASSERT_EQ('4', mvinch(3, 5) & A_CHARTEXT);
+  ASSERT_EQ(1, PAIR_NUMBER(mvinch(3, 5) & A_COLOR));
+  ASSERT_EQ(' ', mvinch(2, 3) & A_CHARTEXT);
+  ASSERT_EQ(1, PAIR_NUMBER(mvinch(2, 3) & A_COLOR));
+  // the selected isle and one with the right amount of bridges
+  ASSERT_EQ('3', mvinch(3, 20) & A_CHARTEXT);
+  ASSERT_EQ(4, PAIR_NUMBER(mvinch(3, 20) & A_COLOR));
+  ASSERT_EQ(2, PAIR_NUMBER(mvinch(9, 5) & A_COLOR));
+  // a single horizontal and a double vertical bridge
+  char line[6];
+  ASSERT_EQ(5, mvinnstr(3, 8, line, 5));
+  ASSERT_STREQ("-----", line);
+  ASSERT_EQ(5, mvinnstr(2, 8, line, 5));
+  ASSERT_STREQ("     ", line);
+  ASSERT_EQ(5, mvinnstr(6, 3, line, 5));
+  ASSERT_STREQ("|   |", line);
+  ASSERT_EQ(0, PAIR_NUMBER(mvinch(6, 3) & A_COLOR));
+  endwin();
+  delscreen(screen);
+  fclose(out);
+}
+
+// _____________________________________________________________________________
+TEST(Hashi, startGame) {
+  FILE* input = fopen("thisIsATest.xy", "w");
+  fprintf(input, "0,0,4\n"
+                 "3,0,3\n"
+                 "0,2,2\n"
+                 "3,2,1\n");
+  fclose(input);
+  setenv("TERM", "xterm", 0);
+  // the terminal output goes to /dev/null
+  fflush(stdout);
+  int saved = dup(1);
+  int null = open("/dev/null", O_WRONLY);
+  dup2(null, 1);
+
+  FileInterpreter files;
+  char* argv[2] = {
+    const_cast<char*>(""),
+    const_cast<char*>("thisIsATest.xy")
+  };
+  files.parseCommandLineArguments(2, argv);
+  PhaseTimer timer;
+  std::string error;
+  bool started;
+  {
+    Hashi gameTest15;
+    started = gameTest15.startGame(files, &timer, &error);
+    ASSERT_TRUE(gameTest15._screen != NULL);
+    ASSERT_EQ(4, gameTest15._max_x);
+    ASSERT_EQ(3, gameTest15._viewHeight);
+    ASSERT_EQ('4', mvinch(3, 5) & A_CHARTEXT);
+  }
+  ASSERT_TRUE(started);
+  ASSERT_TRUE(error.empty());
+  ASSERT_LE(0, timer.endOf("load"));
+  ASSERT_LE(0, timer.endOf("terminal"));
+  ASSERT_LE(std::max(timer.endOf("load"), timer.endOf("terminal")),
+   timer.endOf("first frame"));
+
+  // a missing puzzle restores the terminal
+  unlink("thisIsATest.xy");
+  {
+    Hashi gameTest16;
+    started = gameTest16.startGame(files, &timer, &error);
+    ASSERT_TRUE(gameTest16._screen == NULL);
+  }
+  fflush(stdout);
+  dup2(saved, 1);
+  close(saved);
+  close(null);
+  ASSERT_FALSE(started);
+  ASSERT_EQ(0, error.find("Error opening input file"));
+}
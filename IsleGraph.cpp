@@ -0,0 +1,144 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <vector>
+#include "./IsleGraph.h"
+
+// ____________________________________________________________________________
+IsleGraph::IsleGraph(const std::vector< std::vector<int> >& numbers) {
+  _height = numbers.size();
+  _width = _height > 0 ? numbers[0].size() : 0;
+  _isleIndex.assign(_height, std::vector<int>(_width, -1));
+
+  // collect the isles row by row
+  for (int y = 0; y < _height; y++) {
+    for (int x = 0; x < _width; x++) {
+      if (numbers[y][x] > 0 && numbers[y][x] < 9) {
+        _isleIndex[y][x] = _isles.size();
+        _isles.push_back({x, y, numbers[y][x]});
+      }
+    }
+  }
+  _isleSlots.resize(_isles.size());
+
+  // Every isle looks to the right and downwards for the next isle. As in
+  // Hashi::isBridgeValid(), directly adjacent isles can't be connected.
+  for (unsigned int i = 0; i < _isles.size(); i++) {
+    const Isle& isle = _isles[i];
+    for (int x = isle.x + 1; x < _width; x++) {
+      if (_isleIndex[isle.y][x] >= 0) {
+        if (x > isle.x + 1) {
+          _slots.push_back({static_cast<int>(i), _isleIndex[isle.y][x],
+           false});
+        }
+        break;
+      }
+    }
+    for (int y = isle.y + 1; y < _height; y++) {
+      if (_isleIndex[y][isle.x] >= 0) {
+        if (y > isle.y + 1) {
+          _slots.push_back({static_cast<int>(i), _isleIndex[y][isle.x],
+           true});
+        }
+        break;
+      }
+    }
+  }
+  for (unsigned int s = 0; s < _slots.size(); s++) {
+    _isleSlots[_slots[s].a].push_back(s);
+    _isleSlots[_slots[s].b].push_back(s);
+  }
+
+  // a horizontal and a vertical slot cross if their inner cells intersect
+  _crossings.resize(_slots.size());
+  for (unsigned int h = 0; h < _slots.size(); h++) {
+    if (_slots[h].vertical) {continue; }
+    const Isle& left = _isles[_slots[h].a];
+    const Isle& right = _isles[_slots[h].b];
+    for (unsigned int v = 0; v < _slots.size(); v++) {
+      if (!_slots[v].vertical) {continue; }
+      const Isle& top = _isles[_slots[v].a];
+      const Isle& bottom = _isles[_slots[v].b];
+      if (top.x > left.x && top.x < right.x && left.y > top.y
+          && left.y < bottom.y) {
+        _crossings[h].push_back(v);
+        _crossings[v].push_back(h);
+      }
+    }
+  }
+}
+
+// ____________________________________________________________________________
+int IsleGraph::isleAt(const int x, const int y) const {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) {
+    return -1;
+  }
+  return _isleIndex[y][x];
+}
+
+// ____________________________________________________________________________
+int IsleGraph::slotBetween(int x1, int y1, int x2, int y2) const {
+  int a = isleAt(x1, y1);
+  int b = isleAt(x2, y2);
+  if (a < 0 || b < 0) {
+    return -1;
+  }
+  for (unsigned int i = 0; i < _isleSlots[a].size(); i++) {
+    const BridgeSlot& slot = _slots[_isleSlots[a][i]];
+    if ((slot.a == a && slot.b == b) || (slot.a == b && slot.b == a)) {
+      return _isleSlots[a][i];
+    }
+  }
+  return -1;
+}
+
+// ____________________________________________________________________________
+bool IsleGraph::verify(const std::vector<Bridge>& solution) const {
+  std::vector<int> bridges(_slots.size(), 0);
+  for (unsigned int i = 0; i < solution.size(); i++) {
+    const Bridge& b = solution[i];
+    int slot = slotBetween(b.x1, b.y1, b.x2, b.y2);
+    if (slot < 0 || b.count <= 0) {continue; }
+    bool blocked = false;
+    for (unsigned int c = 0; c < _crossings[slot].size(); c++) {
+      blocked = blocked || bridges[_crossings[slot][c]] > 0;
+    }
+    if (!blocked) {
+      bridges[slot] = (bridges[slot] + b.count) % 3;
+    }
+  }
+
+  // the amount of bridges of every isle
+  for (unsigned int i = 0; i < _isles.size(); i++) {
+    int count = 0;
+    for (unsigned int j = 0; j < _isleSlots[i].size(); j++) {
+      count += bridges[_isleSlots[i][j]];
+    }
+    if (count != _isles[i].value) {
+      return false;
+    }
+  }
+
+  // all isles are reachable from the first one
+  std::vector<char> visited(_isles.size(), 0);
+  std::vector<int> stack;
+  if (!_isles.empty()) {
+    stack.push_back(0);
+    visited[0] = 1;
+  }
+  unsigned int reached = stack.size();
+  while (!stack.empty()) {
+    int isle = stack.back();
+    stack.pop_back();
+    for (unsigned int j = 0; j < _isleSlots[isle].size(); j++) {
+      const BridgeSlot& slot = _slots[_isleSlots[isle][j]];
+      int other = slot.a == isle ? slot.b : slot.a;
+      if (bridges[_isleSlots[isle][j]] > 0 && !visited[other]) {
+        visited[other] = 1;
+        reached++;
+        stack.push_back(other);
+      }
+    }
+  }
+  return reached == _isles.size();
+}
@@ -0,0 +1,86 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef ISLEGRAPH_H_
+#define ISLEGRAPH_H_
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "./Bridge.h"
+
+// An isle of the number field.
+struct Isle {
+  int x;
+  int y;
+  // the required amount of bridges
+  int value;
+};
+
+// A possible bridge between two isles that can see each other.
+struct BridgeSlot {
+  // index of the left (or upper) isle
+  int a;
+  // index of the right (or lower) isle
+  int b;
+  bool vertical;
+};
+
+// Terminal independent view of a number field: the isles, every possible
+// bridge between them and the bridges that would cross each other. The
+// graph only depends on the isle cells (values 1 - 8) of the _numbers
+// encoding, bridge cells are ignored.
+class IsleGraph {
+ public:
+  // Build the graph from a _numbers matrix (see Hashi).
+  explicit IsleGraph(const std::vector< std::vector<int> >& numbers);
+  FRIEND_TEST(IsleGraph, constructor);
+
+  // proportions of the number field
+  int width() const { return _width; }
+  int height() const { return _height; }
+
+  const std::vector<Isle>& isles() const { return _isles; }
+  const std::vector<BridgeSlot>& slots() const { return _slots; }
+
+  // The slots touching the given isle.
+  const std::vector<int>& isleSlots(const int isle) const {
+    return _isleSlots[isle];
+  }
+
+  // The slots that cross the given slot.
+  const std::vector<int>& crossings(const int slot) const {
+    return _crossings[slot];
+  }
+
+  // Returns the index of the isle at (x,y) or -1 if there is none.
+  int isleAt(const int x, const int y) const;
+
+  // Returns the index of the slot between the isles at (x1,y1) and (x2,y2)
+  // (in any order) or -1 if the two cells can't be connected.
+  int slotBetween(int x1, int y1, int x2, int y2) const;
+  FRIEND_TEST(IsleGraph, slotBetween);
+
+  // Checks a solution without drawing it. The rows are replayed like
+  // Hashi::solve() does: every drawn bridge adds a bridge, the third one
+  // removes both again, and bridges that are blocked by a crossing bridge
+  // are skipped.
+  // Arguments:
+  //   const std::vector<Bridge>& solution - the bridges (see Bridge.h)
+  // Returns:
+  //   bool - true if every isle has the right amount of bridges and all
+  //          isles are connected
+  bool verify(const std::vector<Bridge>& solution) const;
+  FRIEND_TEST(IsleGraph, verify);
+
+ private:
+  int _width;
+  int _height;
+  std::vector<Isle> _isles;
+  std::vector<BridgeSlot> _slots;
+  std::vector< std::vector<int> > _isleSlots;
+  std::vector< std::vector<int> > _crossings;
+  // index of the isle in each cell (-1 for empty cells)
+  std::vector< std::vector<int> > _isleIndex;
+};
+
+#endif  // ISLEGRAPH_H_
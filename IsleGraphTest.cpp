@@ -0,0 +1,63 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include "./IsleGraph.h"
+
+// _____________________________________________________________________________
+TEST(IsleGraph, constructor) {
+  IsleGraph graph({{2, 0, 0, 3, 0, 0},
+                   {0, 0, 0, 0, 0, 0},
+                   {3, 0, 0, 5, 0, 4},
+                   {0, 0, 0, 0, 0, 0},
+                   {0, 1, 0, 2, 0, 0}});
+  ASSERT_EQ(7, graph.isles().size());
+  ASSERT_EQ(7, graph.slots().size());
+  ASSERT_EQ(5, graph.isles()[3].value);
+  ASSERT_EQ(4, graph.isleSlots(3).size());
+  ASSERT_EQ(0, graph.crossings(0).size());
+}
+
+// _____________________________________________________________________________
+TEST(IsleGraph, slotBetween) {
+  IsleGraph graph({{2, 0, 3},
+                   {0, 0, 0},
+                   {1, 0, 1},
+                   {0, 3, 0}});
+  ASSERT_EQ(graph.slotBetween(0, 0, 2, 0), graph.slotBetween(2, 0, 0, 0));
+  ASSERT_LE(0, graph.slotBetween(0, 0, 0, 2));
+  ASSERT_EQ(-1, graph.slotBetween(0, 0, 2, 2));
+  ASSERT_EQ(-1, graph.slotBetween(1, 1, 2, 2));
+}
+
+// _____________________________________________________________________________
+TEST(IsleGraph, crossings) {
+  IsleGraph graph({{0, 0, 1, 0, 0},
+                   {0, 0, 0, 0, 0},
+                   {1, 0, 0, 0, 1},
+                   {0, 0, 0, 0, 0},
+                   {0, 0, 1, 0, 0}});
+  ASSERT_EQ(2, graph.slots().size());
+  ASSERT_EQ(1, graph.crossings(0).size());
+  ASSERT_EQ(1, graph.crossings(1).size());
+}
+
+// _____________________________________________________________________________
+TEST(IsleGraph, verify) {
+  IsleGraph graph({{4, 0, 0, 3, 0, 0},
+                   {0, 0, 0, 0, 0, 0},
+                   {2, 0, 0, 1, 0, 0}});
+  ASSERT_TRUE(graph.verify({{0, 0, 3, 0, 1}, {3, 0, 0, 0, 1},
+                            {0, 0, 0, 2, 1}, {0, 2, 0, 0, 1},
+                            {3, 0, 3, 2, 1}}));
+  ASSERT_TRUE(graph.verify({{0, 0, 3, 0, 2}, {0, 0, 0, 2, 2},
+                            {3, 0, 3, 2, 1}}));
+  // missing bridge
+  ASSERT_FALSE(graph.verify({{0, 0, 3, 0, 1}, {3, 0, 0, 0, 1},
+                             {0, 0, 0, 2, 1}, {0, 2, 0, 0, 1}}));
+  // drawing a bridge three times removes it
+  ASSERT_FALSE(graph.verify({{0, 0, 3, 0, 2}, {0, 0, 0, 2, 2},
+                             {3, 0, 3, 2, 1}, {3, 0, 3, 2, 2}}));
+  ASSERT_FALSE(graph.verify({{0, 0, 3, 0, 2}, {0, 0, 0, 2, 2},
+                             {3, 0, 3, 2, 3}}));
+}
@@ -0,0 +1,62 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <stdio.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "./FileInterpreter.h"
+
+// Returns: std::string - an input of at least the given size in bytes: isle
+// lines of the .xy format, rows of the .plain format or comment lines
+std::string makeInput(const int kind, const int bytes, std::mt19937* random) {
+  std::string text;
+  while (static_cast<int>(text.size()) < bytes) {
+    if (kind == 0) {
+      text += std::to_string((*random)() % 1000) + ","
+          + std::to_string((*random)() % 1000) + ","
+          + std::to_string(1 + (*random)() % 8) + "\n";
+    } else if (kind == 1) {
+      for (int x = 0; x < 1000; x++) {
+        text += (*random)() % 4 ? ' ' : '1' + (*random)() % 8;
+      }
+      text += '\n';
+    } else {
+      text += "# " + std::string((*random)() % 1000, '-') + "\n";
+    }
+  }
+  return text;
+}
+
+// Reads inputs of growing size in both formats and shows that the load time
+// grows linearly and the field stays within the limits (inputs beyond the
+// limits are rejected after reading at most maxBytes).
+int main(int argc, char** argv) {
+  const char* kKinds[3] = {"xy", "plain", "comments"};
+  std::mt19937 random(42);
+  LoadLimits limits;
+  printf("%-8s %10s %8s %9s %10s  %s\n", "input", "bytes", "ms", "ns/byte",
+   "cells", "result");
+  for (int kind = 0; kind < 3; kind++) {
+    for (int bytes = 1 << 10; bytes <= (1 << 24); bytes <<= 2) {
+      std::string text = makeInput(kind, bytes, &random);
+      std::istringstream in(text);
+      std::vector< std::vector<int> > numbers;
+      std::string error;
+      std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      bool valid = kind == 1
+          ? FileInterpreter::readFieldPlain(&in, &numbers, &error, limits)
+          : FileInterpreter::readFieldxy(&in, &numbers, &error, limits);
+      double seconds = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count();
+      size_t cells = numbers.empty() ? 0 : numbers.size() * numbers[0].size();
+      printf("%-8s %10zu %8.2f %9.1f %10zu  %s\n", kKinds[kind], text.size(),
+       seconds * 1e3, seconds * 1e9 / text.size(), cells,
+       valid ? "valid" : error.c_str());
+    }
+  }
+  return 0;
+}
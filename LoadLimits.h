@@ -0,0 +1,24 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef LOADLIMITS_H_
+#define LOADLIMITS_H_
+
+#include <stdint.h>
+
+// Limits for reading puzzle, solution and save files from untrusted
+// sources. They are checked while reading, before the field is allocated,
+// so a file can't make the reader use more memory than the limits allow.
+struct LoadLimits {
+  LoadLimits() : maxWidth(1024), maxHeight(1024), maxIsles(1 << 18),
+    maxBytes(1 << 24) {}
+  // the size of the field
+  int maxWidth;
+  int maxHeight;
+  // the amount of isles
+  int maxIsles;
+  // the size of the input (comments included)
+  int64_t maxBytes;
+};
+
+#endif  // LOADLIMITS_H_
@@ -0,0 +1,72 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "./PhaseTimer.h"
+
+// ____________________________________________________________________________
+PhaseTimer::PhaseTimer() {
+  _created = std::chrono::steady_clock::now();
+}
+
+// ____________________________________________________________________________
+double PhaseTimer::now() const {
+  return std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - _created).count();
+}
+
+// ____________________________________________________________________________
+int PhaseTimer::begin(const std::string& name) {
+  double start = now();
+  std::lock_guard<std::mutex> lock(_mutex);
+  _phases.push_back({name, start, -1});
+  return _phases.size() - 1;
+}
+
+// ____________________________________________________________________________
+void PhaseTimer::end(const int phase) {
+  double end = now();
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (phase >= 0 && phase < static_cast<int>(_phases.size())) {
+    _phases[phase].end = end;
+  }
+}
+
+// ____________________________________________________________________________
+std::vector<PhaseTimer::Phase> PhaseTimer::phases() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _phases;
+}
+
+// ____________________________________________________________________________
+double PhaseTimer::endOf(const std::string& name) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  for (int i = _phases.size() - 1; i >= 0; i--) {
+    if (_phases[i].name == name) {
+      return _phases[i].end;
+    }
+  }
+  return -1;
+}
+
+// ____________________________________________________________________________
+void PhaseTimer::report(std::ostream* out) const {
+  std::vector<Phase> phases = this->phases();
+  char line[128];
+  snprintf(line, sizeof(line), "%-16s %9s %9s %9s\n", "phase", "start",
+   "duration", "end");
+  *out << line;
+  for (unsigned int i = 0; i < phases.size(); i++) {
+    const Phase& phase = phases[i];
+    if (phase.end < 0) {
+      snprintf(line, sizeof(line), "%-16s %9.3f %9s %9s\n",
+       phase.name.c_str(), phase.start, "-", "-");
+    } else {
+      snprintf(line, sizeof(line), "%-16s %9.3f %9.3f %9.3f\n",
+       phase.name.c_str(), phase.start, phase.end - phase.start, phase.end);
+    }
+    *out << line;
+  }
+}
@@ -0,0 +1,59 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef PHASETIMER_H_
+#define PHASETIMER_H_
+
+#include <gtest/gtest.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <mutex>  // NOLINT(build/c++11)
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Measures the phases of a process (e.g. the startup of the game) relative
+// to the creation of the timer. Phases may overlap and run on different
+// threads.
+class PhaseTimer {
+ public:
+  // a measured phase, the times in milliseconds since the creation of the
+  // timer (end is -1 while the phase is running)
+  struct Phase {
+    std::string name;
+    double start;
+    double end;
+  };
+
+  // Start the clock.
+  PhaseTimer();
+
+  // Start a phase.
+  // Returns: int - the id of the phase for end()
+  int begin(const std::string& name);
+  FRIEND_TEST(PhaseTimer, beginAndEnd);
+
+  // End the phase with the given id.
+  void end(const int phase);
+
+  // Returns: std::vector<Phase> - the phases in the order they began
+  std::vector<Phase> phases() const;
+
+  // Returns: double - the end of the last phase with the given name (-1 if
+  // there is none or it is still running)
+  double endOf(const std::string& name) const;
+
+  // Write a line per phase: its name, start, duration and end in
+  // milliseconds.
+  void report(std::ostream* out) const;
+  FRIEND_TEST(PhaseTimer, report);
+
+ private:
+  std::chrono::steady_clock::time_point _created;
+  mutable std::mutex _mutex;
+  std::vector<Phase> _phases;
+
+  // Returns: double - the milliseconds since the creation of the timer
+  double now() const;
+};
+
+#endif  // PHASETIMER_H_
@@ -0,0 +1,59 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+#include "./PhaseTimer.h"
+
+// _____________________________________________________________________________
+TEST(PhaseTimer, beginAndEnd) {
+  PhaseTimer timer;
+  ASSERT_TRUE(timer.phases().empty());
+  int load = timer.begin("load");
+  // an overlapping phase on another thread
+  std::thread terminal([&timer] {
+    int phase = timer.begin("terminal");
+    usleep(2000);
+    timer.end(phase);
+  });
+  usleep(4000);
+  timer.end(load);
+  terminal.join();
+  int frame = timer.begin("first frame");
+  ASSERT_EQ(2, frame);
+
+  std::vector<PhaseTimer::Phase> phases = timer.phases();
+  ASSERT_EQ(3, phases.size());
+  ASSERT_EQ("load", phases[0].name);
+  ASSERT_EQ("terminal", phases[1].name);
+  ASSERT_LE(phases[0].start, phases[1].start);
+  ASSERT_LE(phases[1].end, phases[0].end);
+  ASSERT_LE(4, phases[0].end - phases[0].start);
+  ASSERT_LE(2, phases[1].end - phases[1].start);
+  // the running phase has no end yet
+  ASSERT_EQ(-1, phases[2].end);
+  ASSERT_EQ(-1, timer.endOf("first frame"));
+  ASSERT_EQ(phases[0].end, timer.endOf("load"));
+  ASSERT_EQ(-1, timer.endOf("missing"));
+  timer.end(frame);
+  ASSERT_LE(phases[0].end, timer.endOf("first frame"));
+}
+
+// _____________________________________________________________________________
+TEST(PhaseTimer, report) {
+  PhaseTimer timer;
+  timer.end(timer.begin("load"));
+  timer.begin("play");
+  std::ostringstream out;
+  timer.report(&out);
+  std::string text = out.str();
+  ASSERT_EQ(0, text.find("phase"));
+  ASSERT_NE(std::string::npos, text.find("\nload "));
+  ASSERT_NE(std::string::npos, text.find("\nplay "));
+  ASSERT_EQ(3, std::count(text.begin(), text.end(), '\n'));
+}
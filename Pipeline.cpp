@@ -0,0 +1,217 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+#include "./ClauseSolver.h"
+#include "./FileInterpreter.h"
+#include "./Pipeline.h"
+#include "./RegionSolver.h"
+
+namespace {
+// capacity of the queues between the stages
+const size_t kQueueSize = 1024;
+}  // namespace
+
+// ____________________________________________________________________________
+Pipeline::Pipeline(const int threads)
+  : _parsed(kQueueSize), _solved(kQueueSize) {
+  _threads = threads > 0 ? threads : 1;
+  _clauses = false;
+  _window = kWindow;
+  _written = 0;
+  _peakWaiting = 0;
+}
+
+// ____________________________________________________________________________
+void Pipeline::run(const int in, const int out) {
+  std::vector<std::thread> stages;
+  stages.push_back(std::thread(&Pipeline::read, this, in));
+  for (int i = 0; i < _threads; i++) {
+    stages.push_back(std::thread(&Pipeline::solve, this));
+  }
+  write(out);
+  for (unsigned int i = 0; i < stages.size(); i++) {
+    stages[i].join();
+  }
+}
+
+// ____________________________________________________________________________
+void Pipeline::emit(const std::string& text, const bool plain,
+ const bool tooLarge, int64_t* sequence) {
+  Job job;
+  job.sequence = (*sequence)++;
+  job.end = false;
+  std::istringstream in(text);
+  bool valid = !tooLarge && (plain
+      ? FileInterpreter::readFieldPlain(&in, &job.numbers, &job.error,
+        _limits)
+      : FileInterpreter::readFieldxy(&in, &job.numbers, &job.error,
+        _limits));
+  if (tooLarge) {
+    job.error = "The input file is too large.";
+  } else if (valid) {
+    job.error.clear();
+  } else if (job.error.empty()) {
+    job.error = "invalid puzzle";
+  }
+  {
+    std::unique_lock<std::mutex> lock(_windowMutex);
+    while (job.sequence >= _written + _window) {_windowMoved.wait(lock); }
+  }
+  _parsed.push(&job);
+}
+
+// ____________________________________________________________________________
+void Pipeline::read(const int in) {
+  // a puzzle may take up the byte budget of a puzzle file, the rest of a
+  // larger one is dropped and the puzzle is answered with an error
+  const size_t maxBytes = _limits.maxBytes;
+  int64_t sequence = 0;
+  std::string buffer;
+  std::string text;
+  bool plain = false;
+  bool content = false;
+  bool tooLarge = false;
+  // drop the buffer up to the next line break (the rest of a long line)
+  bool skipping = false;
+  // the buffer up to here holds no line break
+  size_t searched = 0;
+  char chunk[1 << 16];
+  ssize_t bytes = 1;
+  while (bytes > 0) {
+    bytes = ::read(in, chunk, sizeof(chunk));
+    if (bytes > 0) {
+      buffer.append(chunk, bytes);
+    } else if (!buffer.empty() && buffer[buffer.size() - 1] != '\n') {
+      buffer += '\n';
+    }
+    size_t start = 0;
+    size_t end;
+    while ((end = buffer.find('\n', std::max(start, searched)))
+           != std::string::npos) {
+      std::string line = buffer.substr(start, end - start);
+      start = end + 1;
+      if (skipping) {
+        skipping = false;
+        continue;
+      }
+      bool xyHeader = line.find("(xy)") != std::string::npos;
+      bool plainHeader = line.find("(plain)") != std::string::npos;
+      if (line.length() > 0 && line[0] == '#' && (xyHeader || plainHeader)) {
+        // a header starts the next puzzle
+        if (content || tooLarge) {emit(text, plain, tooLarge, &sequence); }
+        text.clear();
+        content = false;
+        tooLarge = false;
+        plain = plainHeader;
+        continue;
+      }
+      if (tooLarge || text.size() + line.size() + 1 > maxBytes) {
+        text.clear();
+        tooLarge = true;
+        continue;
+      }
+      text += line;
+      text += '\n';
+      content = content || (line.length() > 0 && line[0] != '#');
+    }
+    buffer.erase(0, start);
+    if (!skipping && buffer.size() >= maxBytes) {
+      skipping = true;
+      text.clear();
+      tooLarge = true;
+    }
+    if (skipping) {buffer.clear(); }
+    searched = buffer.size();
+  }
+  if (content || tooLarge) {emit(text, plain, tooLarge, &sequence); }
+
+  // one end marker per solve thread
+  for (int i = 0; i < _threads; i++) {
+    Job job;
+    job.sequence = sequence;
+    job.end = true;
+    _parsed.push(&job);
+  }
+}
+
+// ____________________________________________________________________________
+void Pipeline::solve() {
+  Job job;
+  while (true) {
+    _parsed.pop(&job);
+    Result result;
+    result.sequence = job.sequence;
+    result.end = job.end;
+    result.solved = false;
+    result.error = job.error;
+    if (!job.end && job.error.empty() && _clauses) {
+      ClauseSolver solver(job.numbers);
+      result.solved = solver.solve(&result.solution);
+    } else if (!job.end && job.error.empty()) {
+      RegionSolver solver(job.numbers);
+      result.solved = solver.solve(1, &result.solution);
+    }
+    _solved.push(&result);
+    if (job.end) {break; }
+  }
+}
+
+// ____________________________________________________________________________
+std::string Pipeline::format(const Result& result) {
+  std::ostringstream out;
+  int64_t number = result.sequence + 1;
+  if (!result.error.empty()) {
+    out << "# error " << number << ": " << result.error << "\n";
+  } else if (!result.solved) {
+    out << "# unsolvable " << number << "\n";
+  } else {
+    out << "# solution " << number << "\n";
+    FileInterpreter::writeSolution(&out, result.solution);
+  }
+  return out.str();
+}
+
+// ____________________________________________________________________________
+void Pipeline::write(const int out) {
+  // results that arrived before their predecessors
+  std::map<int64_t, Result> waiting;
+  int64_t next = 0;
+  int ends = 0;
+  Result result;
+  while (ends < _threads) {
+    _solved.pop(&result);
+    if (result.end) {
+      ends++;
+      continue;
+    }
+    waiting[result.sequence] = std::move(result);
+    _peakWaiting = std::max(_peakWaiting, waiting.size());
+
+    std::string output;
+    std::map<int64_t, Result>::iterator it;
+    while ((it = waiting.find(next)) != waiting.end()) {
+      output += format(it->second);
+      waiting.erase(it);
+      next++;
+    }
+    if (!output.empty()) {
+      std::lock_guard<std::mutex> lock(_windowMutex);
+      _written = next;
+      _windowMoved.notify_one();
+    }
+    for (size_t written = 0; written < output.size();) {
+      ssize_t bytes = ::write(out, output.data() + written,
+       output.size() - written);
+      if (bytes <= 0) {break; }
+      written += bytes;
+    }
+  }
+}
@@ -0,0 +1,109 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <vector>
+#include "./BoundedQueue.h"
+#include "./Bridge.h"
+#include "./LoadLimits.h"
+
+// Streaming solver for a concatenation of puzzle files. A puzzle starts at
+// its header line ("# 7:7 (xy)" or "# 7:7 (plain)", input without a header
+// is read as .xy). Three stages run concurrently and are joined by
+// BoundedQueues:
+//   1. read and parse the puzzles (one thread)
+//   2. solve (one or more threads)
+//   3. format and write the solutions (one thread)
+// Every puzzle gets a sequence number, so the writer restores the input
+// order although solve times vary. The reader stays less than a window of
+// puzzles ahead of the writer, so one slow puzzle does not pile up the
+// results behind it. A puzzle larger than LoadLimits::maxBytes is dropped
+// while it is read and answered with an error. Output per puzzle:
+//   # solution <n>      followed by the lines of a .xy.solution file
+//   # unsolvable <n>
+//   # error <n>: <message>
+class Pipeline {
+ public:
+  // Arguments:
+  //   const int threads - the amount of solve threads
+  explicit Pipeline(const int threads);
+
+  // Process the input stream until it ends.
+  // Arguments:
+  //   const int in - file descriptor of the puzzles
+  //   const int out - file descriptor of the solutions
+  void run(const int in, const int out);
+  FRIEND_TEST(Pipeline, run);
+
+  // Solve with the ClauseSolver instead of the RegionSolver (before run()).
+  void setClauseSolver(const bool clauses) { _clauses = clauses; }
+  FRIEND_TEST(Pipeline, setClauseSolver);
+
+ private:
+  FRIEND_TEST(Pipeline, format);
+  FRIEND_TEST(Pipeline, window);
+  FRIEND_TEST(Pipeline, limits);
+
+  // default amount of puzzles between the writer and the reader
+  static const int64_t kWindow = 1024;
+
+  // a parsed puzzle
+  struct Job {
+    int64_t sequence;
+    // marks the end of the input
+    bool end;
+    std::vector< std::vector<int> > numbers;
+    std::string error;
+  };
+
+  // a solved puzzle
+  struct Result {
+    int64_t sequence;
+    bool end;
+    bool solved;
+    std::vector<Bridge> solution;
+    std::string error;
+  };
+
+  int _threads;
+  bool _clauses;
+  // a puzzle of the input may take up _limits.maxBytes
+  LoadLimits _limits;
+  BoundedQueue<Job> _parsed;
+  BoundedQueue<Result> _solved;
+
+  // the reader waits until the writer is less than _window puzzles behind
+  int64_t _window;
+  // the sequence of the next result to write
+  int64_t _written;
+  std::mutex _windowMutex;
+  std::condition_variable _windowMoved;
+  // the most results the writer held back at once
+  size_t _peakWaiting;
+
+  // Stage 1: split the input into puzzles and parse them.
+  void read(const int in);
+
+  // Stage 2: solve the parsed puzzles.
+  void solve();
+
+  // Stage 3: write the results in input order.
+  void write(const int out);
+
+  // Parse the lines of one puzzle file and queue the Job (an error if the
+  // puzzle was too large to buffer).
+  void emit(const std::string& text, const bool plain, const bool tooLarge,
+   int64_t* sequence);
+
+  // Returns the output lines of a result.
+  static std::string format(const Result& result);
+};
+
+#endif  // PIPELINE_H_
@@ -0,0 +1,209 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>  // NOLINT(build/c++11)
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+#include "./BoundedQueue.h"
+#include "./Pipeline.h"
+
+// _____________________________________________________________________________
+TEST(BoundedQueue, pushAndPop) {
+  BoundedQueue<int> queue(3);
+  int item = 1;
+  ASSERT_TRUE(queue.tryPush(&item));
+  item = 2;
+  ASSERT_TRUE(queue.tryPush(&item));
+  item = 3;
+  ASSERT_TRUE(queue.tryPush(&item));
+  item = 4;
+  ASSERT_TRUE(queue.tryPush(&item));
+  // the capacity is rounded up to 4
+  ASSERT_FALSE(queue.tryPush(&item));
+  ASSERT_TRUE(queue.tryPop(&item));
+  ASSERT_EQ(1, item);
+  ASSERT_TRUE(queue.tryPop(&item));
+  ASSERT_EQ(2, item);
+
+  // two producers, one consumer
+  BoundedQueue<int> shared(8);
+  std::vector<std::thread> producers;
+  for (int p = 0; p < 2; p++) {
+    producers.push_back(std::thread([&shared] {
+      for (int i = 1; i <= 1000; i++) {
+        int value = i;
+        shared.push(&value);
+      }
+    }));
+  }
+  int sum = 0;
+  for (int i = 0; i < 2000; i++) {
+    shared.pop(&item);
+    sum += item;
+  }
+  for (unsigned int p = 0; p < producers.size(); p++) {
+    producers[p].join();
+  }
+  ASSERT_EQ(2 * 500500, sum);
+  ASSERT_FALSE(shared.tryPop(&item));
+
+  // pop() sleeps until the late push() wakes it
+  std::thread late([&shared] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    int value = 7;
+    shared.push(&value);
+  });
+  shared.pop(&item);
+  late.join();
+  ASSERT_EQ(7, item);
+}
+
+// _____________________________________________________________________________
+TEST(Pipeline, format) {
+  Pipeline::Result result;
+  result.sequence = 4;
+  result.solved = true;
+  result.solution = {{0, 0, 3, 0, 2}};
+  ASSERT_EQ("# solution 5\n0,0,3,0\n0,0,3,0\n", Pipeline::format(result));
+  result.solved = false;
+  ASSERT_EQ("# unsolvable 5\n", Pipeline::format(result));
+  result.error = "bad";
+  ASSERT_EQ("# error 5: bad\n", Pipeline::format(result));
+}
+
+// _____________________________________________________________________________
+TEST(Pipeline, run) {
+  int requests[2];
+  int replies[2];
+  ASSERT_EQ(0, pipe(requests));
+  ASSERT_EQ(0, pipe(replies));
+  const char* input = "# 4:3 (xy)\n"
+                      "0,0,4\n3,0,3\n0,2,2\n3,2,1\n"
+                      "# 3:3 (xy)\n"
+                      "0,0,1\n2,2,1\n"
+                      "# 4:3 (plain)\n"
+                      "4  3\n    \n2  1\n"
+                      "# 2:2 (xy)\n"
+                      "0,x,1\n"
+                      "# 4:3 (plain)\n"
+                      "4  3\n    \n2  1";
+  ASSERT_EQ(strlen(input), write(requests[1], input, strlen(input)));
+  close(requests[1]);
+  Pipeline pipeline(3);
+  pipeline.run(requests[0], replies[1]);
+  close(replies[1]);
+  std::string output;
+  char chunk[256];
+  ssize_t bytes;
+  while ((bytes = read(replies[0], chunk, sizeof(chunk))) > 0) {
+    output.append(chunk, bytes);
+  }
+  const char* solution = "0,0,3,0\n0,0,3,0\n0,0,0,2\n0,0,0,2\n3,0,3,2\n";
+  ASSERT_EQ(std::string("# solution 1\n") + solution
+            + "# unsolvable 2\n"
+            + "# solution 3\n" + solution
+            + "# error 4: Error reading the input file. Does it have the "
+              "correct format? \n"
+            + "# solution 5\n" + solution, output);
+  close(requests[0]);
+  close(replies[0]);
+}
+
+// _____________________________________________________________________________
+TEST(Pipeline, window) {
+  int requests[2];
+  int replies[2];
+  ASSERT_EQ(0, pipe(requests));
+  ASSERT_EQ(0, pipe(replies));
+  std::string input;
+  for (int i = 0; i < 200; i++) {
+    input += i % 2 ? "# 4:3 (xy)\n0,0,4\n3,0,3\n0,2,2\n3,2,1\n"
+                   : "# 3:3 (xy)\n0,0,1\n2,2,1\n";
+  }
+  ASSERT_EQ(input.size(), write(requests[1], input.data(), input.size()));
+  close(requests[1]);
+  Pipeline pipeline(3);
+  pipeline._window = 4;
+  pipeline.run(requests[0], replies[1]);
+  close(replies[1]);
+  std::string output;
+  char chunk[256];
+  ssize_t bytes;
+  while ((bytes = read(replies[0], chunk, sizeof(chunk))) > 0) {
+    output.append(chunk, bytes);
+  }
+  ASSERT_LE(pipeline._peakWaiting, 4u);
+  ASSERT_EQ(0u, output.find("# unsolvable 1\n# solution 2\n"));
+  ASSERT_NE(std::string::npos, output.find("# solution 200\n"));
+  ASSERT_EQ(std::string::npos, output.find("# error"));
+  close(requests[0]);
+  close(replies[0]);
+}
+
+// _____________________________________________________________________________
+TEST(Pipeline, setClauseSolver) {
+  int requests[2];
+  int replies[2];
+  ASSERT_EQ(0, pipe(requests));
+  ASSERT_EQ(0, pipe(replies));
+  const char* input = "# 4:3 (xy)\n"
+                      "0,0,4\n3,0,3\n0,2,2\n3,2,1\n"
+                      "# 3:3 (xy)\n"
+                      "0,0,1\n2,2,1\n";
+  ASSERT_EQ(strlen(input), write(requests[1], input, strlen(input)));
+  close(requests[1]);
+  Pipeline pipeline(2);
+  pipeline.setClauseSolver(true);
+  pipeline.run(requests[0], replies[1]);
+  close(replies[1]);
+  std::string output;
+  char chunk[256];
+  ssize_t bytes;
+  while ((bytes = read(replies[0], chunk, sizeof(chunk))) > 0) {
+    output.append(chunk, bytes);
+  }
+  // the same bridges, maybe in another order
+  ASSERT_EQ(0, output.find("# solution 1\n"));
+  ASSERT_NE(std::string::npos, output.find("0,0,3,0\n0,0,3,0\n"));
+  ASSERT_NE(std::string::npos, output.find("0,0,0,2\n0,0,0,2\n"));
+  ASSERT_NE(std::string::npos, output.find("3,0,3,2\n"));
+  ASSERT_NE(std::string::npos, output.find("# unsolvable 2\n"));
+  close(requests[0]);
+  close(replies[0]);
+}
+
+// _____________________________________________________________________________
+TEST(Pipeline, limits) {
+  int requests[2];
+  int replies[2];
+  ASSERT_EQ(0, pipe(requests));
+  ASSERT_EQ(0, pipe(replies));
+  // a long comment, a small puzzle and a long line without line break
+  std::string input = "# 4:3 (xy)\n0,0,4\n3,0,3\n0,2,2\n3,2,1\n"
+      "# 3:1 (xy)\n#" + std::string(100, 'x') + "\n0,0,1\n2,0,1\n"
+      "# 3:1 (xy)\n0,0,1\n2,0,1\n"
+      "# 3:1 (xy)\n" + std::string(100, '0');
+  ASSERT_EQ(input.size(), write(requests[1], input.data(), input.size()));
+  close(requests[1]);
+  Pipeline pipeline(1);
+  pipeline._limits.maxBytes = 64;
+  pipeline.run(requests[0], replies[1]);
+  close(replies[1]);
+  std::string output;
+  char chunk[256];
+  ssize_t bytes;
+  while ((bytes = read(replies[0], chunk, sizeof(chunk))) > 0) {
+    output.append(chunk, bytes);
+  }
+  ASSERT_EQ(std::string("# solution 1\n0,0,3,0\n0,0,3,0\n0,0,0,2\n0,0,0,2\n"
+            "3,0,3,2\n")
+            + "# error 2: The input file is too large.\n"
+            + "# solution 3\n0,0,2,0\n"
+            + "# error 4: The input file is too large.\n", output);
+  close(requests[0]);
+  close(replies[0]);
+}
@@ -0,0 +1,249 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <dirent.h>
+#include <glob.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./FileInterpreter.h"
+#include "./Playlist.h"
+#include "./SolutionCache.h"
+
+// ____________________________________________________________________________
+Playlist::Playlist(const int threads, const char* cacheFile)
+  : _cacheFile(cacheFile) {
+  _threads = threads > 0 ? threads : 1;
+  _next = 0;
+  _current = 0;
+  _preloading = false;
+  _preloadedValid = false;
+}
+
+// ____________________________________________________________________________
+Playlist::~Playlist() {
+  if (_loader.joinable()) {
+    _loader.join();
+  }
+}
+
+// ____________________________________________________________________________
+bool Playlist::isPlaylist(const std::string& source) {
+  struct stat info;
+  if (stat(source.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+    return true;
+  }
+  return source.find_first_of("*?[") != std::string::npos
+      || (source.size() > 5
+          && source.compare(source.size() - 5, 5, ".pack") == 0);
+}
+
+// ____________________________________________________________________________
+bool Playlist::isPuzzleFile(const std::string& file) {
+  return (file.size() > 3 && file.compare(file.size() - 3, 3, ".xy") == 0)
+      || (file.size() > 6 && file.compare(file.size() - 6, 6, ".plain") == 0);
+}
+
+// ____________________________________________________________________________
+bool Playlist::add(const std::string& source, std::string* error) {
+  // the loader must not see the entries move
+  if (_loader.joinable()) {
+    _loader.join();
+  }
+  unsigned int before = _entries.size();
+  std::vector<std::string> files;
+  struct stat info;
+  if (source.find_first_of("*?[") != std::string::npos) {
+    glob_t matches;
+    if (glob(source.c_str(), 0, NULL, &matches) == 0) {
+      for (size_t i = 0; i < matches.gl_pathc; i++) {
+        files.push_back(matches.gl_pathv[i]);
+      }
+    }
+    globfree(&matches);
+  } else if (stat(source.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+    DIR* directory = opendir(source.c_str());
+    if (directory == NULL) {
+      *error = "Error reading the directory: " + source;
+      return false;
+    }
+    struct dirent* file;
+    while ((file = readdir(directory)) != NULL) {
+      files.push_back(source + "/" + file->d_name);
+    }
+    closedir(directory);
+    std::sort(files.begin(), files.end());
+  } else if (source.size() > 5
+             && source.compare(source.size() - 5, 5, ".pack") == 0) {
+    return addPack(source, error);
+  } else {
+    files.push_back(source);
+  }
+
+  for (unsigned int i = 0; i < files.size(); i++) {
+    if (!isPuzzleFile(files[i])) {continue; }
+    Entry entry;
+    entry.file = files[i];
+    entry.offset = 0;
+    entry.length = -1;
+    entry.number = 0;
+    entry.plain = files[i].compare(files[i].size() - 6, 6, ".plain") == 0;
+    _entries.push_back(entry);
+  }
+  if (_entries.size() == before) {
+    *error = "No .xy or .plain puzzles found: " + source;
+    return false;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Playlist::addPack(const std::string& file, std::string* error) {
+  std::ifstream in(file.c_str());
+  if (!in.is_open()) {
+    *error = "Error reading the pack file: " + file;
+    return false;
+  }
+  // split at the header lines like Pipeline::read(), but only remember
+  // where the puzzles are: they are read when they are prepared
+  Entry entry;
+  entry.file = file;
+  entry.offset = 0;
+  entry.number = 0;
+  entry.plain = false;
+  bool content = false;
+  int count = 0;
+  std::string line;
+  while (in.peek() != EOF) {
+    int64_t position = in.tellg();
+    int64_t budget = _limits.maxBytes;
+    if (FileInterpreter::readLine(&in, &line, &budget) < 0) {
+      // an overlong line is no header, load() rejects its puzzle
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      content = true;
+      continue;
+    }
+    bool xyHeader = line.find("(xy)") != std::string::npos;
+    bool plainHeader = line.find("(plain)") != std::string::npos;
+    if (line.length() > 0 && line[0] == '#' && (xyHeader || plainHeader)) {
+      // a header starts the next puzzle
+      if (content) {
+        entry.length = position - entry.offset;
+        entry.number = ++count;
+        _entries.push_back(entry);
+      }
+      entry.offset = position;
+      entry.plain = plainHeader;
+      content = false;
+    } else {
+      content = content || (line.length() > 0 && line[0] != '#');
+    }
+  }
+  if (content) {
+    // the last line may end without a newline
+    in.clear();
+    in.seekg(0, std::ios::end);
+    entry.length = static_cast<int64_t>(in.tellg()) - entry.offset;
+    entry.number = ++count;
+    _entries.push_back(entry);
+  }
+  if (count == 0) {
+    *error = "No puzzles found in the pack file: " + file;
+    return false;
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Playlist::load(const Entry& entry, PreparedPuzzle* puzzle) const {
+  puzzle->name = entry.file;
+  if (entry.number > 0) {
+    puzzle->name += "#" + std::to_string(entry.number);
+  }
+  puzzle->numbers.clear();
+  puzzle->solution.clear();
+  puzzle->position.reset();
+  puzzle->checker.reset();
+
+  std::ifstream file(entry.file.c_str());
+  if (!file.is_open()) {
+    return false;
+  }
+  // a puzzle file is read within the byte budget of the readers, a pack
+  // entry is checked before it is buffered
+  std::istringstream packed;
+  std::istream* in = &file;
+  if (entry.length >= 0) {
+    if (entry.length > _limits.maxBytes) {
+      return false;
+    }
+    std::string text(entry.length, '\0');
+    file.seekg(entry.offset);
+    file.read(&text[0], entry.length);
+    packed.str(text);
+    in = &packed;
+  }
+  std::string error;
+  bool valid = entry.plain
+      ? FileInterpreter::readFieldPlain(in, &puzzle->numbers, &error,
+        _limits)
+      : FileInterpreter::readFieldxy(in, &puzzle->numbers, &error, _limits);
+  if (!valid || puzzle->numbers.empty()) {
+    return false;
+  }
+
+  // the solution file next to a puzzle file, otherwise the cache
+  if (entry.length < 0) {
+    std::ifstream solution((entry.file + ".solution").c_str());
+    if (solution.is_open() && !FileInterpreter::readSolution(&solution,
+        &puzzle->solution, _limits)) {
+      puzzle->solution.clear();
+    }
+  }
+  if (puzzle->solution.empty() && !_cacheFile.empty()) {
+    SolutionCache cache(_cacheFile.c_str());
+    cache.lookup(puzzle->numbers, &puzzle->solution);
+  }
+  puzzle->position.reset(new PositionCheck(puzzle->numbers));
+  puzzle->checker.reset(new BackgroundSolver(puzzle->numbers, _threads));
+  return true;
+}
+
+// ____________________________________________________________________________
+bool Playlist::next(PreparedPuzzle* puzzle) {
+  while (_preloading || hasNext()) {
+    bool valid;
+    if (_preloading) {
+      // add() may have waited for the loader already
+      if (_loader.joinable()) {_loader.join(); }
+      _preloading = false;
+      *puzzle = std::move(_preloaded);
+      valid = _preloadedValid;
+    } else {
+      valid = load(_entries[_next], puzzle);
+    }
+    _next++;
+    if (valid) {
+      _current = _next;
+      preload();
+      return true;
+    }
+  }
+  return false;
+}
+
+// ____________________________________________________________________________
+void Playlist::preload() {
+  if (!hasNext()) {
+    return;
+  }
+  _preloading = true;
+  _loader = std::thread([this]() {
+    _preloadedValid = load(_entries[_next], &_preloaded);
+  });
+}
@@ -0,0 +1,126 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef PLAYLIST_H_
+#define PLAYLIST_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+#include "./BackgroundSolver.h"
+#include "./Bridge.h"
+#include "./LoadLimits.h"
+#include "./PositionCheck.h"
+
+// A puzzle of a Playlist, read and prepared for Hashi::load().
+struct PreparedPuzzle {
+  // the file name (the entries of a pack: "<pack>#<number>")
+  std::string name;
+  // the isles in the format of the Hashi _numbers matrix
+  std::vector< std::vector<int> > numbers;
+  // the solution of "<file>.solution" or of the solution cache (empty if
+  // there is none)
+  std::vector<Bridge> solution;
+  // the solvability checks of Hashi::play(), built for the puzzle
+  std::unique_ptr<PositionCheck> position;
+  std::unique_ptr<BackgroundSolver> checker;
+};
+
+// A list of puzzles that are played one after the other. While the player
+// works on the current puzzle, a loader thread reads and prepares the next
+// one (parsing, the IsleGraph of the solvability checks, the solution), so
+// switching to it only takes a redraw.
+class Playlist {
+ public:
+  // Arguments:
+  //   const int threads - the worker threads of the prepared checkers
+  //   const char* cacheFile - solution cache for puzzles without solution
+  //                           file ("" for none)
+  Playlist(const int threads, const char* cacheFile);
+
+  // Waits for the loader thread.
+  ~Playlist();
+
+  // Returns: bool - true if the source is a list of puzzles: a directory,
+  // a glob pattern or a pack file (.pack)
+  static bool isPlaylist(const std::string& source);
+  FRIEND_TEST(Playlist, isPlaylist);
+
+  // Append the puzzles of a source: the .xy and .plain files of a
+  // directory or of a glob pattern (in name order), the puzzles of a pack
+  // file (concatenated puzzle files, each starting with its header line
+  // like the input of the Pipeline) or a single puzzle file.
+  // Arguments:
+  //   const std::string& source - the directory, pattern or file
+  //   std::string* error - receives the error message
+  // Returns:
+  //   bool - false if the source can't be read or has no puzzles
+  bool add(const std::string& source, std::string* error);
+  FRIEND_TEST(Playlist, add);
+
+  // Returns: int - the amount of puzzles
+  int size() const { return _entries.size(); }
+
+  // Returns: int - the number of the current puzzle (counted from 1, 0
+  // before the first call of next())
+  int current() const { return _current; }
+
+  // Returns: bool - true if there is a puzzle after the current one
+  bool hasNext() const { return _next < static_cast<int>(_entries.size()); }
+
+  // Take the next puzzle and start preparing the one after it. A puzzle
+  // that was prepared in the background is returned right away; invalid
+  // puzzles are skipped.
+  // Returns:
+  //   bool - false if there is no more valid puzzle
+  bool next(PreparedPuzzle* puzzle);
+  FRIEND_TEST(Playlist, next);
+
+ private:
+  // a puzzle file or a part of a pack file
+  struct Entry {
+    std::string file;
+    // the part of a pack file (length -1: the whole file)
+    int64_t offset;
+    int64_t length;
+    // number of the puzzle in a pack (0 for puzzle files)
+    int number;
+    bool plain;
+  };
+
+  int _threads;
+  std::string _cacheFile;
+  // the files are untrusted: a pack line or a puzzle may take up
+  // _limits.maxBytes
+  LoadLimits _limits;
+  std::vector<Entry> _entries;
+  // the entry of the next puzzle and the number of the current one
+  int _next;
+  int _current;
+
+  // prepares the entry _next in the background (if _preloading)
+  std::thread _loader;
+  bool _preloading;
+  PreparedPuzzle _preloaded;
+  bool _preloadedValid;
+
+  // Returns: bool - true if the file name ends with .xy or .plain
+  static bool isPuzzleFile(const std::string& file);
+
+  // Append the puzzles of a pack file.
+  bool addPack(const std::string& file, std::string* error);
+
+  // Read and prepare the puzzle of an entry.
+  // Returns:
+  //   bool - false if the puzzle can't be read or is invalid
+  bool load(const Entry& entry, PreparedPuzzle* puzzle) const;
+  FRIEND_TEST(Playlist, load);
+
+  // Start preparing the entry _next in the background.
+  void preload();
+};
+
+#endif  // PLAYLIST_H_
@@ -0,0 +1,184 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "./Playlist.h"
+#include "./SolutionCache.h"
+
+namespace {
+// the two puzzles of the tests
+const char* kFirst = "# 3:1 (xy)\n0,0,1\n2,0,1\n";
+const char* kSecond = "# 4:3 (xy)\n0,0,4\n3,0,3\n0,2,2\n3,2,1\n";
+
+// Write a text file.
+void writeFile(const std::string& file, const char* text) {
+  FILE* out = fopen(file.c_str(), "w");
+  fprintf(out, "%s", text);
+  fclose(out);
+}
+
+// A directory with two puzzles, a solution and a file that is no puzzle.
+void writeDirectory() {
+  mkdir("thisIsATest.dir", 0755);
+  writeFile("thisIsATest.dir/b.xy", kSecond);
+  writeFile("thisIsATest.dir/a.xy", kFirst);
+  writeFile("thisIsATest.dir/a.xy.solution", "0,0,2,0\n");
+  writeFile("thisIsATest.dir/notes.txt", "no puzzle\n");
+}
+
+// Remove the directory of writeDirectory().
+void removeDirectory() {
+  unlink("thisIsATest.dir/a.xy");
+  unlink("thisIsATest.dir/b.xy");
+  unlink("thisIsATest.dir/a.xy.solution");
+  unlink("thisIsATest.dir/notes.txt");
+  rmdir("thisIsATest.dir");
+}
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(Playlist, isPlaylist) {
+  mkdir("thisIsATest.dir", 0755);
+  ASSERT_TRUE(Playlist::isPlaylist("thisIsATest.dir"));
+  ASSERT_TRUE(Playlist::isPlaylist("instances/*.xy"));
+  ASSERT_TRUE(Playlist::isPlaylist("puzzles.pack"));
+  ASSERT_FALSE(Playlist::isPlaylist("instances/i001-n002-s03x01.xy"));
+  ASSERT_FALSE(Playlist::isPlaylist(".pack"));
+  rmdir("thisIsATest.dir");
+}
+
+// _____________________________________________________________________________
+TEST(Playlist, add) {
+  writeDirectory();
+  Playlist playlist(1, "");
+  std::string error;
+  // only the puzzle files, in name order
+  ASSERT_TRUE(playlist.add("thisIsATest.dir", &error));
+  ASSERT_EQ(2, playlist.size());
+  ASSERT_EQ("thisIsATest.dir/a.xy", playlist._entries[0].file);
+  ASSERT_EQ("thisIsATest.dir/b.xy", playlist._entries[1].file);
+  ASSERT_TRUE(playlist.add("thisIsATest.dir/*.xy", &error));
+  ASSERT_EQ(4, playlist.size());
+  ASSERT_FALSE(playlist.add("thisIsATest.dir/*.plain", &error));
+  ASSERT_FALSE(playlist.add("thisIsATest.dir/notes.txt", &error));
+  ASSERT_EQ(4, playlist.size());
+  ASSERT_EQ(0, playlist.current());
+  removeDirectory();
+
+  // a pack without trailing newline, a comment and an empty part
+  std::string pack = std::string(kFirst) + "# a comment\n"
+      + "# 1:1 (xy)\n" + kSecond;
+  pack.resize(pack.size() - 1);
+  writeFile("thisIsATest.pack", pack.c_str());
+  ASSERT_TRUE(playlist.add("thisIsATest.pack", &error));
+  ASSERT_EQ(6, playlist.size());
+  ASSERT_EQ(0, playlist._entries[4].offset);
+  ASSERT_EQ(1, playlist._entries[4].number);
+  ASSERT_EQ(strlen(kFirst) + strlen("# a comment\n"),
+            playlist._entries[4].length);
+  ASSERT_EQ(pack.size() - strlen(kSecond) + 1, playlist._entries[5].offset);
+  ASSERT_EQ(strlen(kSecond) - 1, playlist._entries[5].length);
+  ASSERT_EQ(2, playlist._entries[5].number);
+  // a line longer than the byte budget is skipped
+  Playlist limited(1, "");
+  limited._limits.maxBytes = 20;
+  pack = std::string(kFirst) + "#" + std::string(100, 'x') + "\n" + kSecond;
+  writeFile("thisIsATest.pack", pack.c_str());
+  ASSERT_TRUE(limited.add("thisIsATest.pack", &error));
+  ASSERT_EQ(2, limited.size());
+  ASSERT_EQ(pack.size() - strlen(kSecond), limited._entries[1].offset);
+  writeFile("thisIsATest.pack", "# only comments\n");
+  ASSERT_FALSE(playlist.add("thisIsATest.pack", &error));
+  unlink("thisIsATest.pack");
+  ASSERT_FALSE(playlist.add("thisIsATest.pack", &error));
+  ASSERT_EQ(6, playlist.size());
+}
+
+// _____________________________________________________________________________
+TEST(Playlist, load) {
+  writeDirectory();
+  std::string pack = std::string(kFirst) + kSecond;
+  writeFile("thisIsATest.pack", pack.c_str());
+  unlink("thisIsATest.cache");
+  std::vector<Bridge> cached = {{0, 0, 3, 0, 2}, {0, 0, 0, 2, 2},
+                                 {3, 0, 3, 2, 1}};
+  {
+    SolutionCache cache("thisIsATest.cache");
+    cache.insert({{4, 0, 0, 3},
+                  {0, 0, 0, 0},
+                  {2, 0, 0, 1}}, cached);
+  }
+  Playlist playlist(1, "thisIsATest.cache");
+  std::string error;
+  ASSERT_TRUE(playlist.add("thisIsATest.dir", &error));
+  ASSERT_TRUE(playlist.add("thisIsATest.pack", &error));
+
+  // a puzzle file with its solution file
+  PreparedPuzzle puzzle;
+  ASSERT_TRUE(playlist.load(playlist._entries[0], &puzzle));
+  ASSERT_EQ("thisIsATest.dir/a.xy", puzzle.name);
+  std::vector< std::vector<int> > first = {{1, 0, 1}};
+  ASSERT_EQ(first, puzzle.numbers);
+  ASSERT_EQ(std::vector<Bridge>({{0, 0, 2, 0, 1}}), puzzle.solution);
+  ASSERT_TRUE(puzzle.position != NULL);
+  ASSERT_TRUE(puzzle.checker != NULL);
+  // the second puzzle of the pack, solved by the cache
+  ASSERT_TRUE(playlist.load(playlist._entries[3], &puzzle));
+  ASSERT_EQ("thisIsATest.pack#2", puzzle.name);
+  ASSERT_EQ(3, puzzle.numbers.size());
+  ASSERT_EQ(cached, puzzle.solution);
+
+  // puzzles larger than the byte budget
+  playlist._limits.maxBytes = 20;
+  ASSERT_FALSE(playlist.load(playlist._entries[0], &puzzle));
+  ASSERT_FALSE(playlist.load(playlist._entries[3], &puzzle));
+  playlist._limits = LoadLimits();
+
+  // a file that became invalid
+  writeFile("thisIsATest.dir/b.xy", "# 2:2 (xy)\n1,x,1\n");
+  ASSERT_FALSE(playlist.load(playlist._entries[1], &puzzle));
+  removeDirectory();
+  ASSERT_FALSE(playlist.load(playlist._entries[1], &puzzle));
+  unlink("thisIsATest.pack");
+  unlink("thisIsATest.cache");
+}
+
+// _____________________________________________________________________________
+TEST(Playlist, next) {
+  std::string pack = std::string(kFirst) + "# 2:2 (xy)\n1,x,1\n" + kSecond;
+  writeFile("thisIsATest.pack", pack.c_str());
+  Playlist playlist(1, "");
+  std::string error;
+  ASSERT_TRUE(playlist.add("thisIsATest.pack", &error));
+  ASSERT_EQ(3, playlist.size());
+
+  PreparedPuzzle puzzle;
+  ASSERT_TRUE(playlist.next(&puzzle));
+  ASSERT_EQ(1, playlist.current());
+  ASSERT_EQ("thisIsATest.pack#1", puzzle.name);
+  // the second puzzle is being prepared, adding waits for it
+  ASSERT_TRUE(playlist._preloading);
+  ASSERT_TRUE(playlist.add("thisIsATest.pack", &error));
+  ASSERT_EQ(6, playlist.size());
+  // the invalid puzzle is skipped
+  ASSERT_TRUE(playlist.next(&puzzle));
+  ASSERT_EQ(3, playlist.current());
+  ASSERT_EQ("thisIsATest.pack#3", puzzle.name);
+  ASSERT_EQ(3, puzzle.numbers.size());
+  ASSERT_TRUE(puzzle.checker != NULL);
+  ASSERT_TRUE(playlist.next(&puzzle));
+  ASSERT_EQ("thisIsATest.pack#1", puzzle.name);
+  ASSERT_TRUE(playlist.next(&puzzle));
+  ASSERT_EQ("thisIsATest.pack#3", puzzle.name);
+  ASSERT_FALSE(playlist.hasNext());
+  ASSERT_FALSE(playlist._preloading);
+  ASSERT_FALSE(playlist.next(&puzzle));
+  ASSERT_EQ(6, playlist.current());
+  unlink("thisIsATest.pack");
+}
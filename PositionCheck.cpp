@@ -0,0 +1,228 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "./PositionCheck.h"
+
+// ____________________________________________________________________________
+PositionCheck::PositionCheck(const std::vector< std::vector<int> >& numbers)
+  : _graph(numbers) {
+  int slots = _graph.slots().size();
+  int isles = _graph.isles().size();
+  _lo.assign(slots, 0);
+  _hi.assign(slots, 2);
+  // every change narrows a domain of three values, so each slot changes at
+  // most twice
+  _trail.resize(2 * slots + 1);
+  _trailSize = 0;
+  _queue.resize(isles + 1);
+  _queueSize = 0;
+  _queued.assign(isles + 1, 0);
+  _stack.resize(isles + 1);
+  _visited.resize(isles + 1);
+  _moves.reserve(2 * slots);
+  _replay.reserve(2 * slots);
+  _drawn.assign(slots, 0);
+  _dead = -1;
+
+  for (int i = 0; i < isles; i++) {
+    _queue[_queueSize++] = i;
+    _queued[i] = 1;
+  }
+  _baseDead = !propagate() || !isConnected();
+  _baseSize = _trailSize;
+}
+
+// ____________________________________________________________________________
+bool PositionCheck::update(const Bridge& bridge) {
+  int slot = _graph.slotBetween(bridge.x1, bridge.y1, bridge.x2, bridge.y2);
+  if (slot < 0) {
+    return possible();
+  }
+  int count = std::max(0, std::min<int>(bridge.count, 2));
+  if (count > _drawn[slot]) {
+    push(slot, count, true);
+    return possible();
+  }
+  if (count == _drawn[slot]) {
+    return possible();
+  }
+
+  // take back everything from the first move of the slot on
+  unsigned int first = 0;
+  while (_moves[first].slot != slot) {
+    first++;
+  }
+  _replay.assign(_moves.begin() + first + 1, _moves.end());
+  int mark = _moves[first].trailSize;
+  _drawn[slot] = 0;
+  // The domains only get narrower, so the isles are connected after every
+  // replayed move if they are connected after the last one. Only if they
+  // aren't, the moves are replayed again to find the culprit.
+  for (int connectivity = 0; connectivity < 2; connectivity++) {
+    undo(mark);
+    _moves.resize(first);
+    if (_dead >= static_cast<int>(first)) {
+      _dead = -1;
+    }
+    // the later moves of the slot are replaced by the new count
+    for (unsigned int i = 0; i < _replay.size(); i++) {
+      if (_replay[i].slot != slot) {
+        push(_replay[i].slot, _replay[i].count, connectivity);
+      }
+    }
+    if (count > 0) {
+      push(slot, count, connectivity);
+    }
+    if (!possible() || isConnected()) {break; }
+  }
+  return possible();
+}
+
+// ____________________________________________________________________________
+void PositionCheck::reset() {
+  undo(_baseSize);
+  _moves.clear();
+  std::fill(_drawn.begin(), _drawn.end(), 0);
+  _dead = -1;
+}
+
+// ____________________________________________________________________________
+void PositionCheck::push(const int slot, const int count,
+ const bool connectivity) {
+  _drawn[slot] = count;
+  Move move;
+  move.slot = slot;
+  move.count = count;
+  move.trailSize = _trailSize;
+  _moves.push_back(move);
+  if (!possible()) {
+    return;
+  }
+  bool consistent = assign(slot, count, 2);
+  if (!consistent) {
+    clear();
+  }
+  if (!consistent || !propagate() || (connectivity && !isConnected())) {
+    _dead = _moves.size() - 1;
+  }
+}
+
+// ____________________________________________________________________________
+bool PositionCheck::assign(const int slot, const int lo, const int hi) {
+  int oldLo = _lo[slot];
+  int oldHi = _hi[slot];
+  int newLo = std::max(oldLo, lo);
+  int newHi = std::min(oldHi, hi);
+  if (newLo > newHi) {
+    return false;
+  }
+  if (newLo == oldLo && newHi == oldHi) {
+    return true;
+  }
+  Change& change = _trail[_trailSize++];
+  change.slot = slot;
+  change.lo = oldLo;
+  change.hi = oldHi;
+  _lo[slot] = newLo;
+  _hi[slot] = newHi;
+
+  // check both isles again
+  const BridgeSlot& s = _graph.slots()[slot];
+  if (!_queued[s.a]) {
+    _queued[s.a] = 1;
+    _queue[_queueSize++] = s.a;
+  }
+  if (!_queued[s.b]) {
+    _queued[s.b] = 1;
+    _queue[_queueSize++] = s.b;
+  }
+
+  if (oldLo == 0 && newLo > 0) {
+    const std::vector<int>& crossings = _graph.crossings(slot);
+    for (unsigned int c = 0; c < crossings.size(); c++) {
+      if (!assign(crossings[c], 0, 0)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+void PositionCheck::undo(const int trailSize) {
+  while (_trailSize > trailSize) {
+    const Change& change = _trail[--_trailSize];
+    _lo[change.slot] = change.lo;
+    _hi[change.slot] = change.hi;
+  }
+}
+
+// ____________________________________________________________________________
+bool PositionCheck::propagate() {
+  while (_queueSize > 0) {
+    int isle = _queue[--_queueSize];
+    _queued[isle] = 0;
+
+    const std::vector<int>& slots = _graph.isleSlots(isle);
+    int value = _graph.isles()[isle].value;
+    int sumLo = 0;
+    int sumHi = 0;
+    for (unsigned int i = 0; i < slots.size(); i++) {
+      sumLo += _lo[slots[i]];
+      sumHi += _hi[slots[i]];
+    }
+    if (sumLo > value || sumHi < value) {
+      clear();
+      return false;
+    }
+    // every slot has to take what the others can't give and must leave
+    // room for what the others already have
+    for (unsigned int i = 0; i < slots.size(); i++) {
+      int s = slots[i];
+      if (!assign(s, value - (sumHi - _hi[s]), value - (sumLo - _lo[s]))) {
+        clear();
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+void PositionCheck::clear() {
+  for (int i = 0; i < _queueSize; i++) {
+    _queued[_queue[i]] = 0;
+  }
+  _queueSize = 0;
+}
+
+// ____________________________________________________________________________
+bool PositionCheck::isConnected() {
+  int isles = _graph.isles().size();
+  if (isles == 0) {
+    return true;
+  }
+  memset(_visited.data(), 0, isles);
+  int top = 0;
+  _stack[top++] = 0;
+  _visited[0] = 1;
+  int count = 1;
+  while (top > 0) {
+    int isle = _stack[--top];
+    const std::vector<int>& slots = _graph.isleSlots(isle);
+    for (unsigned int i = 0; i < slots.size(); i++) {
+      if (_hi[slots[i]] == 0) {continue; }
+      const BridgeSlot& s = _graph.slots()[slots[i]];
+      int other = s.a == isle ? s.b : s.a;
+      if (!_visited[other]) {
+        _visited[other] = 1;
+        count++;
+        _stack[top++] = other;
+      }
+    }
+  }
+  return count == isles;
+}
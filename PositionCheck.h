@@ -0,0 +1,120 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef POSITIONCHECK_H_
+#define POSITIONCHECK_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <vector>
+#include "./Bridge.h"
+#include "./IsleGraph.h"
+
+// Fast check after every move whether the bridges drawn by the player can
+// still lead to a solution. The drawn bridges fix the lower bounds of their
+// slots (a single bridge may still become a double bridge), the isle
+// values and the crossings are propagated like in the Solver and the isles
+// have to stay connected. There is no search, so a position that passes
+// may still be a dead end (see BackgroundSolver for the full answer).
+//
+// The check is incremental: the narrowed domains of all moves are kept on
+// one trail. A new bridge only propagates its own consequences, a removed
+// bridge takes back the moves from its first one on and replays the later
+// ones. The arrays are sized for the worst case once, so a move does not
+// allocate memory.
+class PositionCheck {
+ public:
+  // Propagate the isle values of the empty number field (see Hashi).
+  explicit PositionCheck(const std::vector< std::vector<int> >& numbers);
+
+  // Set the amount of drawn bridges between two isles.
+  // Arguments:
+  //   const Bridge& bridge - the isles (in any order) and the new count, 0
+  //     removes the bridge
+  // Returns:
+  //   bool - see possible()
+  bool update(const Bridge& bridge);
+  FRIEND_TEST(PositionCheck, update);
+
+  // Remove all bridges.
+  void reset();
+
+  // Returns: bool - false if the drawn bridges can't be part of a solution
+  bool possible() const { return !_baseDead && _dead < 0; }
+
+  // Returns: int - the smallest and the largest bridge count that is still
+  // possible for a slot of the graph (only meaningful if possible())
+  int lo(const int slot) const { return _lo[slot]; }
+  int hi(const int slot) const { return _hi[slot]; }
+
+  const IsleGraph& graph() const { return _graph; }
+
+ private:
+  // The domain of a slot before a change.
+  struct Change {
+    int slot;
+    uint8_t lo;
+    uint8_t hi;
+  };
+
+  // A drawn bridge and the trail size before it was applied.
+  struct Move {
+    int slot;
+    int count;
+    int trailSize;
+  };
+
+  IsleGraph _graph;
+  // bridge domains of all slots
+  std::vector<uint8_t> _lo;
+  std::vector<uint8_t> _hi;
+  // the old domains, newest last
+  std::vector<Change> _trail;
+  int _trailSize;
+  // isles whose slots changed and have to be checked again
+  std::vector<int> _queue;
+  int _queueSize;
+  std::vector<char> _queued;
+  // scratch space of isConnected()
+  std::vector<int> _stack;
+  std::vector<char> _visited;
+
+  // the moves in the order they were made, the drawn count of every slot
+  // and the moves to replay after a removal
+  std::vector<Move> _moves;
+  std::vector<int> _drawn;
+  std::vector<Move> _replay;
+  // trail size of the propagated empty number field
+  int _baseSize;
+  // true if the puzzle has no solution at all
+  bool _baseDead;
+  // index of the move that made the position impossible (-1 if there is
+  // none), later moves are only recorded
+  int _dead;
+
+  // Record a move and apply it unless the position is impossible already.
+  // The connectivity of the isles is only checked if connectivity is true.
+  void push(const int slot, const int count, const bool connectivity);
+
+  // Narrow the domain of a slot to [lo, hi]. Using a slot removes all
+  // crossing slots. The old domains are pushed to the trail.
+  // Returns:
+  //   bool - false if the domain becomes empty
+  bool assign(const int slot, const int lo, const int hi);
+
+  // Restore the domains of the trail down to the given size.
+  void undo(const int trailSize);
+
+  // Narrow the domains around the queued isles until nothing changes.
+  // Returns:
+  //   bool - false if an isle can't get the right amount of bridges
+  bool propagate();
+
+  // Empty the queue after a contradiction.
+  void clear();
+
+  // Checks if all isles can still be connected by the possible bridges.
+  bool isConnected();
+};
+
+#endif  // POSITIONCHECK_H_
@@ -0,0 +1,51 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "./PositionCheck.h"
+
+// _____________________________________________________________________________
+TEST(PositionCheck, update) {
+  PositionCheck test1({{3, 0, 3},
+                       {0, 0, 0},
+                       {3, 0, 3}});
+  ASSERT_TRUE(test1.possible());
+  ASSERT_TRUE(test1.update(Bridge(0, 0, 2, 0, 1)));
+  ASSERT_TRUE(test1.update(Bridge(0, 0, 0, 2, 2)));
+  // the upper left isle would get four bridges
+  ASSERT_FALSE(test1.update(Bridge(2, 0, 0, 0, 2)));
+  // later moves are only recorded
+  ASSERT_FALSE(test1.update(Bridge(2, 0, 2, 2, 1)));
+  // removing an earlier move replays the later ones
+  ASSERT_TRUE(test1.update(Bridge(0, 0, 0, 2, 0)));
+  ASSERT_EQ(3, test1._moves.size());
+  ASSERT_EQ(2, test1._lo[test1._graph.slotBetween(0, 0, 2, 0)]);
+  ASSERT_EQ(1, test1._hi[test1._graph.slotBetween(0, 0, 0, 2)]);
+  ASSERT_TRUE(test1.update(Bridge(0, 0, 2, 0, 0)));
+  ASSERT_EQ(1, test1._moves.size());
+  // bridges between isles that can't be connected are ignored
+  ASSERT_TRUE(test1.update(Bridge(0, 0, 2, 2, 1)));
+  test1.reset();
+  ASSERT_EQ(0, test1._moves.size());
+  ASSERT_EQ(test1._baseSize, test1._trailSize);
+
+  // the 1-isles would be cut off from the others
+  PositionCheck test2({{1, 0, 1},
+                       {0, 0, 0},
+                       {2, 0, 2}});
+  ASSERT_FALSE(test2.update(Bridge(0, 0, 2, 0, 1)));
+  ASSERT_TRUE(test2.update(Bridge(0, 0, 2, 0, 0)));
+  ASSERT_TRUE(test2.update(Bridge(0, 2, 2, 2, 1)));
+  ASSERT_FALSE(test2.update(Bridge(0, 0, 2, 0, 1)));
+  // the replay finds the move that cuts off the isles
+  ASSERT_FALSE(test2.update(Bridge(0, 2, 2, 2, 0)));
+  ASSERT_EQ(0, test2._dead);
+  ASSERT_TRUE(test2.update(Bridge(0, 0, 2, 0, 0)));
+
+  // a puzzle without any solution
+  PositionCheck test3({{1, 0, 0},
+                       {0, 0, 0},
+                       {0, 0, 1}});
+  ASSERT_FALSE(test3.possible());
+}
@@ -0,0 +1,112 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "./FileInterpreter.h"
+#include "./Rater.h"
+#include "./RatingIndex.h"
+#include "./ThreadPool.h"
+
+// Print the usage and exit.
+void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./RateMain [--threads <int>] [--index <file>] "
+   "<puzzlefiles>\n");
+  fprintf(stderr, "       ./RateMain --query <indexfile> <minscore> "
+   "<maxscore>\n");
+  fprintf(stderr, "Rates .xy / .plain puzzles and writes the sidecar index "
+   "(default: ratings.index),\nor prints the solvable puzzles of an index "
+   "within a score range.\n");
+  exit(1);
+}
+
+// Rates a corpus of puzzles in parallel and writes the sidecar index, or
+// queries an index.
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"threads", 1, NULL, 't'},
+    {"index", 1, NULL, 'i'},
+    {"query", 1, NULL, 'q'},
+    {NULL, 0, NULL, 0}
+  };
+  int threads = 4;
+  const char* indexFile = "ratings.index";
+  const char* queryFile = NULL;
+  while (true) {
+    int c = getopt_long(argc, argv, "t:i:q:", options, NULL);
+    if (c == -1) {break; }
+    switch (c) {
+      case 't':
+        threads = std::max(1, atoi(optarg));
+        break;
+      case 'i':
+        indexFile = optarg;
+        break;
+      case 'q':
+        queryFile = optarg;
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+
+  if (queryFile) {
+    if (optind + 2 != argc) {printUsageAndExit(); }
+    std::ifstream in(queryFile);
+    std::vector<RatedPuzzle> puzzles;
+    if (!in.is_open() || !RatingIndex::read(&in, &puzzles)) {
+      fprintf(stderr, "Error reading the index: %s\n", queryFile);
+      return 1;
+    }
+    std::vector<RatedPuzzle> result = RatingIndex::query(puzzles,
+     atoi(argv[optind]), atoi(argv[optind + 1]));
+    for (unsigned int i = 0; i < result.size(); i++) {
+      printf("%6d  %-12s  %s\n", result[i].rating.score,
+       Rater::ruleName(result[i].rating.hardest), result[i].file.c_str());
+    }
+    return 0;
+  }
+
+  if (optind == argc) {printUsageAndExit(); }
+  std::vector<RatedPuzzle> puzzles(argc - optind);
+  std::vector<char> valid(puzzles.size(), 0);
+  std::chrono::steady_clock::time_point start =
+   std::chrono::steady_clock::now();
+  ThreadPool pool(threads);
+  pool.run(puzzles.size(), [&](int i) {
+    puzzles[i].file = argv[optind + i];
+    std::vector< std::vector<int> > numbers;
+    if (FileInterpreter::readPuzzle(puzzles[i].file, &numbers)) {
+      Rater rater(numbers);
+      puzzles[i].rating = rater.rate();
+      valid[i] = 1;
+    }
+  });
+  double ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - start).count();
+
+  std::vector<RatedPuzzle> rated;
+  for (unsigned int i = 0; i < puzzles.size(); i++) {
+    if (valid[i]) {
+      rated.push_back(puzzles[i]);
+    } else {
+      fprintf(stderr, "Skipping invalid puzzle: %s\n", puzzles[i].file.c_str());
+    }
+  }
+  std::ofstream out(indexFile);
+  if (!out.is_open()) {
+    fprintf(stderr, "Error writing the index: %s\n", indexFile);
+    return 1;
+  }
+  RatingIndex::write(&out, rated);
+  printf("rated %zu puzzles with %d threads in %.1f ms, index: %s\n",
+   rated.size(), threads, ms, indexFile);
+  return 0;
+}
@@ -0,0 +1,320 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <algorithm>
+#include <vector>
+#include "./Rater.h"
+
+const int Rater::kRuleScore[Rater::kGuess] = {0, 1, 2, 5, 8, 20};
+
+// ____________________________________________________________________________
+Rater::Rater(const std::vector< std::vector<int> >& numbers)
+  : _graph(numbers) {
+  _rating.solved = false;
+  _rating.hardest = kNone;
+  _rating.steps = 0;
+  _rating.guesses = 0;
+  _rating.score = 0;
+  _tracking = false;
+  _queued.assign(_graph.isles().size(), 0);
+}
+
+// ____________________________________________________________________________
+Rating Rater::rate() {
+  _rating.solved = false;
+  _rating.hardest = kNone;
+  _rating.steps = 0;
+  _rating.guesses = 0;
+  _rating.score = 0;
+  State state;
+  state.lo.assign(_graph.slots().size(), 0);
+  state.hi.assign(_graph.slots().size(), 2);
+  _rating.solved = search(&state);
+  return _rating;
+}
+
+// ____________________________________________________________________________
+const char* Rater::ruleName(const int rule) {
+  switch (rule) {
+    case kFullIsle: return "full-isle";
+    case kBounds: return "bounds";
+    case kIsolation: return "isolation";
+    case kConnectivity: return "connectivity";
+    case kLookahead: return "lookahead";
+    case kGuess: return "guess";
+  }
+  return "none";
+}
+
+// ____________________________________________________________________________
+bool Rater::narrow(State* state, const int slot, const int lo, const int hi,
+ int* changes) {
+  int oldLo = state->lo[slot];
+  int newLo = std::max(oldLo, lo);
+  int newHi = std::min<int>(state->hi[slot], hi);
+  if (newLo > newHi) {
+    return false;
+  }
+  if (newLo == oldLo && newHi == state->hi[slot]) {
+    return true;
+  }
+  state->lo[slot] = newLo;
+  state->hi[slot] = newHi;
+  (*changes)++;
+  if (_tracking) {
+    const BridgeSlot& s = _graph.slots()[slot];
+    if (!_queued[s.a]) {
+      _queued[s.a] = 1;
+      _queue.push_back(s.a);
+    }
+    if (!_queued[s.b]) {
+      _queued[s.b] = 1;
+      _queue.push_back(s.b);
+    }
+  }
+  // a bridge blocks the slots that cross it
+  if (oldLo == 0 && newLo > 0) {
+    const std::vector<int>& crossings = _graph.crossings(slot);
+    for (unsigned int c = 0; c < crossings.size(); c++) {
+      if (!narrow(state, crossings[c], 0, 0, changes)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+int Rater::apply(const int rule, State* state) {
+  int changes = 0;
+  const std::vector<Isle>& isles = _graph.isles();
+  if (rule == kConnectivity) {
+    std::vector<int> cuts;
+    if (!connected(*state, &cuts)) {
+      return -1;
+    }
+    for (unsigned int i = 0; i < cuts.size(); i++) {
+      if (!narrow(state, cuts[i], 1, 2, &changes)) {return -1; }
+    }
+    return changes;
+  }
+  if (rule == kIsolation) {
+    for (unsigned int s = 0; s < _graph.slots().size() && isles.size() > 2;
+         s++) {
+      const BridgeSlot& slot = _graph.slots()[s];
+      int value = isles[slot.a].value;
+      if (value == isles[slot.b].value && value == state->hi[s]
+          && !narrow(state, s, 0, value - 1, &changes)) {
+        return -1;
+      }
+    }
+    return changes;
+  }
+
+  // kFullIsle and kBounds compare the value of an isle with its slots
+  for (unsigned int i = 0; i < isles.size(); i++) {
+    const std::vector<int>& slots = _graph.isleSlots(i);
+    for (unsigned int j = 0; j < slots.size(); j++) {
+      int sumLo = 0;
+      int sumHi = 0;
+      for (unsigned int k = 0; k < slots.size(); k++) {
+        sumLo += state->lo[slots[k]];
+        sumHi += state->hi[slots[k]];
+      }
+      int value = isles[i].value;
+      if (sumLo > value || sumHi < value) {
+        return -1;
+      }
+      int s = slots[j];
+      int lo = state->lo[s];
+      int hi = state->hi[s];
+      bool consistent = true;
+      if (rule == kFullIsle && sumHi == value) {
+        consistent = narrow(state, s, hi, hi, &changes);
+      } else if (rule == kFullIsle && sumLo == value) {
+        consistent = narrow(state, s, lo, lo, &changes);
+      } else if (rule == kBounds) {
+        consistent = narrow(state, s, value - (sumHi - hi),
+         value - (sumLo - lo), &changes);
+      }
+      if (!consistent) {
+        return -1;
+      }
+    }
+  }
+  return changes;
+}
+
+// ____________________________________________________________________________
+int Rater::deduce(State* state, const int maxRule) {
+  // every progress starts the ladder again, so each step is made with the
+  // easiest rule
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (int rule = kFullIsle; rule <= maxRule && !progress; rule++) {
+      int changes = 0;
+      if (rule == kLookahead) {
+        // remove the values that lead to a contradiction
+        for (unsigned int s = 0; s < state->lo.size(); s++) {
+          if (state->lo[s] == state->hi[s]) {continue; }
+          int lo = state->lo[s];
+          int hi = state->hi[s];
+          if (refutes(*state, s, lo)) {
+            if (!narrow(state, s, lo + 1, hi, &changes)) {return -1; }
+          } else if (refutes(*state, s, hi)) {
+            if (!narrow(state, s, lo, hi - 1, &changes)) {return -1; }
+          }
+        }
+      } else {
+        changes = apply(rule, state);
+      }
+      if (changes < 0) {
+        return -1;
+      }
+      if (changes > 0) {
+        progress = true;
+        _rating.steps += changes;
+        _rating.score += kRuleScore[rule] * changes;
+        _rating.hardest = std::max(_rating.hardest, rule);
+      }
+    }
+  }
+  for (unsigned int s = 0; s < state->lo.size(); s++) {
+    if (state->lo[s] != state->hi[s]) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// ____________________________________________________________________________
+bool Rater::refutes(const State& state, const int slot, const int value) {
+  _trial = state;
+  int changes = 0;
+  // only the isles touched by a change are checked again
+  _tracking = true;
+  bool refuted = !narrow(&_trial, slot, value, value, &changes);
+  while (!refuted) {
+    while (!_queue.empty() && !refuted) {
+      int isle = _queue.back();
+      _queue.pop_back();
+      _queued[isle] = 0;
+      refuted = bound(&_trial, isle, &changes) < 0;
+    }
+    if (refuted) {break; }
+    // the rules that look at the whole puzzle
+    changes = apply(kIsolation, &_trial);
+    if (changes >= 0) {
+      int more = apply(kConnectivity, &_trial);
+      changes = more < 0 ? -1 : changes + more;
+    }
+    refuted = changes < 0;
+    if (changes == 0 && _queue.empty()) {break; }
+  }
+  _tracking = false;
+  for (unsigned int i = 0; i < _queue.size(); i++) {
+    _queued[_queue[i]] = 0;
+  }
+  _queue.clear();
+  return refuted;
+}
+
+// ____________________________________________________________________________
+int Rater::bound(State* state, const int isle, int* changes) {
+  // kBounds implies kFullIsle
+  const std::vector<int>& slots = _graph.isleSlots(isle);
+  int value = _graph.isles()[isle].value;
+  for (unsigned int j = 0; j < slots.size(); j++) {
+    int sumLo = 0;
+    int sumHi = 0;
+    for (unsigned int k = 0; k < slots.size(); k++) {
+      sumLo += state->lo[slots[k]];
+      sumHi += state->hi[slots[k]];
+    }
+    if (sumLo > value || sumHi < value) {
+      return -1;
+    }
+    int s = slots[j];
+    if (!narrow(state, s, value - (sumHi - state->hi[s]),
+         value - (sumLo - state->lo[s]), changes)) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+// ____________________________________________________________________________
+bool Rater::search(State* state) {
+  int result = deduce(state, kLookahead);
+  if (result != 0) {
+    return result > 0;
+  }
+  // no rule helps: guess the first open slot, the larger value first
+  unsigned int slot = 0;
+  while (state->lo[slot] == state->hi[slot]) {
+    slot++;
+  }
+  for (int value = state->hi[slot]; value >= state->lo[slot]; value--) {
+    if (_rating.guesses >= kMaxGuesses) {
+      return false;
+    }
+    _rating.guesses++;
+    _rating.score += kGuessScore;
+    _rating.hardest = kGuess;
+    State trial = *state;
+    int changes = 0;
+    if (narrow(&trial, slot, value, value, &changes) && search(&trial)) {
+      *state = trial;
+      return true;
+    }
+  }
+  return false;
+}
+
+// ____________________________________________________________________________
+bool Rater::connected(const State& state, std::vector<int>* cuts) const {
+  int isles = _graph.isles().size();
+  if (isles == 0) {
+    return true;
+  }
+  // depth first search that finds the cut edges by their low links
+  struct Frame {
+    int isle;
+    int parentSlot;
+    unsigned int next;
+  };
+  std::vector<int> order(isles, -1);
+  std::vector<int> low(isles, 0);
+  std::vector<Frame> stack;
+  int counter = 0;
+  order[0] = low[0] = counter++;
+  stack.push_back({0, -1, 0});
+  while (!stack.empty()) {
+    int isle = stack.back().isle;
+    const std::vector<int>& slots = _graph.isleSlots(isle);
+    if (stack.back().next < slots.size()) {
+      int s = slots[stack.back().next++];
+      if (s == stack.back().parentSlot || state.hi[s] == 0) {continue; }
+      const BridgeSlot& slot = _graph.slots()[s];
+      int other = slot.a == isle ? slot.b : slot.a;
+      if (order[other] < 0) {
+        order[other] = low[other] = counter++;
+        stack.push_back({other, s, 0});
+      } else {
+        low[isle] = std::min(low[isle], order[other]);
+      }
+      continue;
+    }
+    Frame done = stack.back();
+    stack.pop_back();
+    if (!stack.empty()) {
+      int parent = stack.back().isle;
+      low[parent] = std::min(low[parent], low[done.isle]);
+      if (low[done.isle] > order[parent] && cuts) {
+        cuts->push_back(done.parentSlot);
+      }
+    }
+  }
+  return counter == isles;
+}
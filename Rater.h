@@ -0,0 +1,119 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef RATER_H_
+#define RATER_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <vector>
+#include "./IsleGraph.h"
+
+// The difficulty of a puzzle.
+struct Rating {
+  // false if the puzzle has no solution (or the guess limit was reached)
+  bool solved;
+  // the hardest rule that was needed (see Rater::Rule)
+  int hardest;
+  // the amount of deductions
+  int steps;
+  // the amount of guesses, every guess raises the score a lot
+  int guesses;
+  // the weighted sum of the deductions and guesses
+  int score;
+};
+
+// Rates a puzzle by solving it like a human: the easiest rule of a fixed
+// ladder that makes progress is applied, then the ladder starts over. Only
+// if no rule helps, the rater guesses.
+class Rater {
+ public:
+  // The rule ladder, from easy to hard.
+  enum Rule {
+    kNone = 0,
+    // an isle needs every bridge it can still get (or none of the open
+    // ones)
+    kFullIsle = 1,
+    // an isle needs some bridges on a slot because the other slots can't
+    // give enough
+    kBounds = 2,
+    // two 1s (or two 2s with a double bridge) must not close an island
+    kIsolation = 3,
+    // a slot that is the only connection of a part of the puzzle must
+    // have a bridge
+    kConnectivity = 4,
+    // trying a value with the rules above leads to a contradiction
+    kLookahead = 5,
+    kGuess = 6
+  };
+
+  // Prepare the rating of the isles of a _numbers matrix (see Hashi).
+  explicit Rater(const std::vector< std::vector<int> >& numbers);
+
+  // Rate the puzzle.
+  Rating rate();
+  FRIEND_TEST(Rater, rate);
+
+  // Returns: const char* - the name of a rule (e.g. for the index)
+  static const char* ruleName(const int rule);
+
+  // The score of a deduction of each rule (by index), a guess counts
+  // kGuessScore.
+  static const int kRuleScore[kGuess];
+  static const int kGuessScore = 100;
+  // the rating gives up after this amount of guesses
+  static const int kMaxGuesses = 2000;
+
+ private:
+  IsleGraph _graph;
+  Rating _rating;
+
+  // the bridge domains [lo, hi] of every slot
+  struct State {
+    std::vector<uint8_t> lo;
+    std::vector<uint8_t> hi;
+  };
+
+  // Narrow the domain of a slot and remove the crossing slots once it has
+  // a bridge.
+  // Returns: bool - false if the domain got empty
+  bool narrow(State* state, const int slot, const int lo, const int hi,
+   int* changes);
+
+  // Apply one rule to every isle (slot).
+  // Returns: int - the amount of narrowed domains or -1 on a contradiction
+  int apply(const int rule, State* state);
+
+  // Apply kBounds to one isle.
+  // Returns: int - -1 on a contradiction, else 0
+  int bound(State* state, const int isle, int* changes);
+  FRIEND_TEST(Rater, apply);
+
+  // Apply the rules up to maxRule until none makes progress and count the
+  // deductions.
+  // Returns: int - -1 on a contradiction, 1 if every slot is fixed, else 0
+  int deduce(State* state, const int maxRule);
+
+  // Try one value of a slot with the rules up to kConnectivity (the
+  // deductions of the trial are not counted).
+  // Returns: bool - true if that leads to a contradiction
+  bool refutes(const State& state, const int slot, const int value);
+
+  // Deduce and guess until the puzzle is solved.
+  // Returns: bool - true if a solution was found
+  bool search(State* state);
+
+  // Checks if the slots with hi > 0 connect all isles. The cut edges of
+  // that graph are stored in cuts (if not NULL).
+  // Returns: bool - false if the bridges can't connect all isles
+  bool connected(const State& state, std::vector<int>* cuts) const;
+
+  // the state of the current trial (kept to reuse its memory)
+  State _trial;
+  // while tracking, narrow() queues the isles of every changed slot
+  bool _tracking;
+  std::vector<int> _queue;
+  std::vector<char> _queued;
+};
+
+#endif  // RATER_H_
@@ -0,0 +1,95 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <vector>
+#include "./Rater.h"
+#include "./RatingIndex.h"
+
+// _____________________________________________________________________________
+TEST(Rater, rate) {
+  // every isle is full or bounded by its neighbours
+  Rater easy({{4, 0, 0, 3, 0, 0},
+              {0, 0, 0, 0, 0, 0},
+              {2, 0, 0, 1, 0, 0}});
+  Rating rating = easy.rate();
+  ASSERT_TRUE(rating.solved);
+  ASSERT_EQ(0, rating.guesses);
+  ASSERT_LE(rating.hardest, Rater::kBounds);
+  ASSERT_LT(0, rating.steps);
+
+  // two solutions: only a guess helps
+  Rater ring3({{3, 0, 3},
+               {0, 0, 0},
+               {3, 0, 3}});
+  Rating guessed = ring3.rate();
+  ASSERT_TRUE(guessed.solved);
+  ASSERT_EQ(Rater::kGuess, guessed.hardest);
+  ASSERT_LT(0, guessed.guesses);
+  ASSERT_GT(guessed.score, rating.score + Rater::kGuessScore - 1);
+
+  // two isles that can't be connected
+  Rater unsolvable({{1, 0, 0},
+                    {0, 0, 0},
+                    {0, 0, 1}});
+  ASSERT_FALSE(unsolvable.rate().solved);
+}
+
+// _____________________________________________________________________________
+TEST(Rater, apply) {
+  // the two 1s must not be connected to each other
+  Rater rater({{1, 0, 1},
+               {0, 0, 0},
+               {2, 0, 2}});
+  Rater::State state;
+  state.lo.assign(rater._graph.slots().size(), 0);
+  state.hi.assign(rater._graph.slots().size(), 1);
+  int slot = rater._graph.slotBetween(0, 0, 2, 0);
+  ASSERT_LE(0, slot);
+  ASSERT_EQ(1, rater.apply(Rater::kIsolation, &state));
+  ASSERT_EQ(0, state.hi[slot]);
+  // now every other slot is needed to connect the isles
+  ASSERT_EQ(3, rater.apply(Rater::kConnectivity, &state));
+  ASSERT_EQ(1, state.lo[rater._graph.slotBetween(0, 2, 2, 2)]);
+  ASSERT_STREQ("connectivity", Rater::ruleName(Rater::kConnectivity));
+}
+
+// _____________________________________________________________________________
+TEST(RatingIndex, writeAndRead) {
+  std::vector<RatedPuzzle> puzzles(2);
+  puzzles[0].file = "hard.xy";
+  puzzles[0].rating = {true, Rater::kGuess, 30, 2, 250};
+  puzzles[1].file = "easy.xy";
+  puzzles[1].rating = {true, Rater::kBounds, 10, 0, 15};
+  std::stringstream index;
+  RatingIndex::write(&index, puzzles);
+  std::vector<RatedPuzzle> read;
+  ASSERT_TRUE(RatingIndex::read(&index, &read));
+  ASSERT_EQ(2, read.size());
+  // the easiest puzzle comes first
+  ASSERT_EQ("easy.xy", read[0].file);
+  ASSERT_EQ(15, read[0].rating.score);
+  ASSERT_EQ(Rater::kGuess, read[1].rating.hardest);
+  ASSERT_EQ(30, read[1].rating.steps);
+  ASSERT_EQ(2, read[1].rating.guesses);
+  ASSERT_TRUE(read[1].rating.solved);
+  std::stringstream invalid("file.xy\tnot a number\n");
+  ASSERT_FALSE(RatingIndex::read(&invalid, &read));
+}
+
+// _____________________________________________________________________________
+TEST(RatingIndex, query) {
+  std::vector<RatedPuzzle> puzzles(3);
+  puzzles[0].file = "b.xy";
+  puzzles[0].rating = {true, Rater::kBounds, 10, 0, 40};
+  puzzles[1].file = "a.xy";
+  puzzles[1].rating = {true, Rater::kFullIsle, 10, 0, 10};
+  puzzles[2].file = "c.xy";
+  puzzles[2].rating = {false, Rater::kNone, 0, 0, 20};
+  std::vector<RatedPuzzle> result = RatingIndex::query(puzzles, 0, 50);
+  ASSERT_EQ(2, result.size());
+  ASSERT_EQ("a.xy", result[0].file);
+  ASSERT_EQ("b.xy", result[1].file);
+  ASSERT_EQ(0, RatingIndex::query(puzzles, 11, 39).size());
+}
@@ -0,0 +1,74 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "./RatingIndex.h"
+
+namespace {
+// Returns: bool - true if a is easier than b (ties by the file name)
+bool easier(const RatedPuzzle& a, const RatedPuzzle& b) {
+  if (a.rating.score != b.rating.score) {
+    return a.rating.score < b.rating.score;
+  }
+  return a.file < b.file;
+}
+}  // namespace
+
+// ____________________________________________________________________________
+void RatingIndex::write(std::ostream* out, std::vector<RatedPuzzle> puzzles) {
+  std::sort(puzzles.begin(), puzzles.end(), easier);
+  *out << "# file\tscore\thardest\tsteps\tguesses\tsolved\n";
+  for (unsigned int i = 0; i < puzzles.size(); i++) {
+    const Rating& rating = puzzles[i].rating;
+    *out << puzzles[i].file << "\t" << rating.score << "\t"
+     << Rater::ruleName(rating.hardest) << "\t" << rating.steps << "\t"
+     << rating.guesses << "\t" << (rating.solved ? "solved" : "unsolved")
+     << "\n";
+  }
+}
+
+// ____________________________________________________________________________
+bool RatingIndex::read(std::istream* in, std::vector<RatedPuzzle>* puzzles) {
+  puzzles->clear();
+  std::string line;
+  while (getline(*in, line)) {
+    if (line.length() == 0 || line[0] == '#') {continue; }
+    std::stringstream ss(line);
+    RatedPuzzle puzzle;
+    std::string hardest;
+    std::string solved;
+    if (!getline(ss, puzzle.file, '\t')
+        || !(ss >> puzzle.rating.score >> hardest >> puzzle.rating.steps
+             >> puzzle.rating.guesses >> solved)) {
+      return false;
+    }
+    puzzle.rating.hardest = Rater::kNone;
+    for (int rule = Rater::kNone; rule <= Rater::kGuess; rule++) {
+      if (hardest == Rater::ruleName(rule)) {
+        puzzle.rating.hardest = rule;
+      }
+    }
+    puzzle.rating.solved = solved == "solved";
+    puzzles->push_back(puzzle);
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+std::vector<RatedPuzzle> RatingIndex::query(
+    const std::vector<RatedPuzzle>& puzzles, const int minScore,
+    const int maxScore) {
+  std::vector<RatedPuzzle> result;
+  for (unsigned int i = 0; i < puzzles.size(); i++) {
+    const Rating& rating = puzzles[i].rating;
+    if (rating.solved && rating.score >= minScore
+        && rating.score <= maxScore) {
+      result.push_back(puzzles[i]);
+    }
+  }
+  std::sort(result.begin(), result.end(), easier);
+  return result;
+}
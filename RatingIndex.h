@@ -0,0 +1,42 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef RATINGINDEX_H_
+#define RATINGINDEX_H_
+
+#include <gtest/gtest.h>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "./Rater.h"
+
+// A rated puzzle file.
+struct RatedPuzzle {
+  std::string file;
+  Rating rating;
+};
+
+// The sidecar index of a puzzle corpus: one line per puzzle, sorted by the
+// score (easiest first), with tab separated columns
+//   <file> <score> <hardest rule> <steps> <guesses> solved|unsolved
+class RatingIndex {
+ public:
+  // Sort the puzzles by their score and write them.
+  static void write(std::ostream* out, std::vector<RatedPuzzle> puzzles);
+
+  // Read an index.
+  // Returns:
+  //   bool - false if a line is invalid
+  static bool read(std::istream* in, std::vector<RatedPuzzle>* puzzles);
+  FRIEND_TEST(RatingIndex, writeAndRead);
+
+  // The solvable puzzles with a score in [minScore, maxScore], easiest
+  // first.
+  static std::vector<RatedPuzzle> query(
+      const std::vector<RatedPuzzle>& puzzles, const int minScore,
+      const int maxScore);
+  FRIEND_TEST(RatingIndex, query);
+};
+
+#endif  // RATINGINDEX_H_
@@ -0,0 +1,106 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <string>
+#include <vector>
+#include "./FileInterpreter.h"
+#include "./IsleGraph.h"
+#include "./RegionSolver.h"
+#include "./Solver.h"
+
+// Print the usage and exit.
+void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./RegionBenchMain [--budget <ms>] [--threads <n>] "
+   "<puzzlefiles>\n");
+  fprintf(stderr, "Solves every puzzle with one Solver for the whole field "
+   "and with the\nRegionSolver, each within the budget (default 10000 ms) "
+   "and with the given\namount of threads (default 1), e.g. the puzzles in "
+   "benchmarks/.\n");
+  exit(1);
+}
+
+// Returns: const char* - the verdict of a search
+const char* verdict(const bool found, const bool stopped) {
+  return stopped ? "timeout" : (found ? "solved" : "unsolvable");
+}
+
+// Compares the search of the whole field with the search of its independent
+// regions on a set of puzzle files.
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"budget", 1, NULL, 'b'},
+    {"threads", 1, NULL, 't'},
+    {NULL, 0, NULL, 0}
+  };
+  int budget = 10000;
+  int threads = 1;
+  while (true) {
+    int c = getopt_long(argc, argv, "b:t:", options, NULL);
+    if (c == -1) {break; }
+    switch (c) {
+      case 'b':
+        budget = std::max(1, atoi(optarg));
+        break;
+      case 't':
+        threads = std::max(1, atoi(optarg));
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+  if (optind >= argc) {printUsageAndExit(); }
+
+  bool valid = true;
+  for (int i = optind; i < argc; i++) {
+    std::vector< std::vector<int> > numbers;
+    if (!FileInterpreter::readPuzzle(argv[i], &numbers)) {
+      fprintf(stderr, "Skipping invalid puzzle: %s\n", argv[i]);
+      continue;
+    }
+    IsleGraph graph(numbers);
+    std::vector<Bridge> solution;
+
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    Solver solver(numbers);
+    solver.setDeadline(start + std::chrono::milliseconds(budget));
+    bool found = solver.solve(threads, &solution);
+    valid &= !found || graph.verify(solution);
+    std::chrono::steady_clock::time_point middle =
+        std::chrono::steady_clock::now();
+    RegionSolver regions(numbers);
+    regions.setDeadline(middle + std::chrono::milliseconds(budget));
+    bool split = regions.solve(threads, &solution);
+    valid &= !split || graph.verify(solution);
+    std::chrono::steady_clock::time_point end =
+        std::chrono::steady_clock::now();
+
+    double whole = std::chrono::duration<double, std::milli>(
+        middle - start).count();
+    double parts = std::chrono::duration<double, std::milli>(
+        end - middle).count();
+    printf("%s\n  whole field: %10.1f ms %-10s %10lld nodes\n"
+     "  regions:     %10.1f ms %-10s %10lld nodes %8d regions  "
+     "speedup %s%.1f\n", argv[i], whole,
+     verdict(found, solver.stopped()),
+     static_cast<long long>(solver.nodes()),  // NOLINT
+     parts, verdict(split, regions.stopped()),
+     static_cast<long long>(regions.nodes()),  // NOLINT
+     regions.regions(), solver.stopped() ? ">" : "",
+     parts > 0 ? whole / parts : 0);
+    if (!solver.stopped() && !regions.stopped() && found != split) {
+      fprintf(stderr, "The searches disagree on %s\n", argv[i]);
+      valid = false;
+    }
+  }
+  if (!valid) {
+    fprintf(stderr, "Invalid result\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,236 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <algorithm>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+#include "./RegionSolver.h"
+#include "./Solver.h"
+
+namespace {
+// Returns: int - the representative of the set of x (with path halving)
+int findSet(std::vector<int>* sets, int x) {
+  while ((*sets)[x] != x) {
+    (*sets)[x] = (*sets)[(*sets)[x]];
+    x = (*sets)[x];
+  }
+  return x;
+}
+
+// Join the sets of a and b.
+void joinSets(std::vector<int>* sets, const int a, const int b) {
+  (*sets)[findSet(sets, a)] = findSet(sets, b);
+}
+}  // namespace
+
+// ____________________________________________________________________________
+RegionSolver::RegionSolver(const std::vector< std::vector<int> >& numbers)
+  : _numbers(numbers), _root(numbers) {
+  _stop = NULL;
+  _deadline = std::chrono::steady_clock::time_point::max();
+  _stopped = false;
+  _nodes = 0;
+  decompose();
+}
+
+// ____________________________________________________________________________
+void RegionSolver::decompose() {
+  const IsleGraph& graph = _root.graph();
+  int isles = graph.isles().size();
+  _regionOf.assign(isles, -1);
+  if (!_root.possible()) {return; }
+
+  // parts: isles joined by undecided slots and crossings of undecided
+  // slots; clusters: isles joined by sure bridges
+  std::vector<int> parts(isles);
+  std::vector<int> clusters(isles);
+  for (int i = 0; i < isles; i++) {
+    parts[i] = clusters[i] = i;
+  }
+  std::vector<char> open(isles, 0);
+  for (unsigned int s = 0; s < graph.slots().size(); s++) {
+    const BridgeSlot& slot = graph.slots()[s];
+    if (_root.lo(s) > 0) {joinSets(&clusters, slot.a, slot.b); }
+    if (_root.lo(s) == _root.hi(s)) {continue; }
+    open[slot.a] = open[slot.b] = 1;
+    joinSets(&parts, slot.a, slot.b);
+    const std::vector<int>& crossings = graph.crossings(s);
+    for (unsigned int c = 0; c < crossings.size(); c++) {
+      if (_root.lo(crossings[c]) != _root.hi(crossings[c])) {
+        joinSets(&parts, slot.a, graph.slots()[crossings[c]].a);
+      }
+    }
+  }
+
+  // the bipartite graph of the parts (nodes 0 .. isles - 1, by their
+  // representative isle) and the clusters (nodes isles .. 2 * isles - 1)
+  std::vector< std::vector<int> > edges(2 * isles);
+  for (int i = 0; i < isles; i++) {
+    if (!open[i]) {continue; }
+    int part = findSet(&parts, i);
+    int cluster = isles + findSet(&clusters, i);
+    edges[part].push_back(cluster);
+    edges[cluster].push_back(part);
+  }
+  for (unsigned int n = 0; n < edges.size(); n++) {
+    std::sort(edges[n].begin(), edges[n].end());
+    edges[n].erase(std::unique(edges[n].begin(), edges[n].end()),
+     edges[n].end());
+  }
+
+  // depth first search that joins the parts of every biconnected block
+  // (the nodes above a child with low[child] >= order[parent] on the
+  // node stack belong to the block of parent)
+  struct Frame {
+    int node;
+    int parent;
+    unsigned int next;
+  };
+  std::vector<int> order(2 * isles, -1);
+  std::vector<int> low(2 * isles, 0);
+  std::vector<Frame> stack;
+  std::vector<int> nodes;
+  int counter = 0;
+  for (int start = 0; start < 2 * isles; start++) {
+    if (order[start] >= 0 || edges[start].empty()) {continue; }
+    order[start] = low[start] = counter++;
+    stack.push_back({start, -1, 0});
+    nodes.push_back(start);
+    while (!stack.empty()) {
+      int node = stack.back().node;
+      if (stack.back().next < edges[node].size()) {
+        int other = edges[node][stack.back().next++];
+        if (other == stack.back().parent) {continue; }
+        if (order[other] < 0) {
+          order[other] = low[other] = counter++;
+          stack.push_back({other, node, 0});
+          nodes.push_back(other);
+        } else {
+          low[node] = std::min(low[node], order[other]);
+        }
+        continue;
+      }
+      Frame done = stack.back();
+      stack.pop_back();
+      if (stack.empty()) {continue; }
+      int parent = stack.back().node;
+      low[parent] = std::min(low[parent], low[done.node]);
+      if (low[done.node] < order[parent]) {continue; }
+      // the block of parent and done: join its parts (one side of every
+      // edge is a part)
+      int part = parent < isles ? parent : done.node;
+      while (true) {
+        int member = nodes.back();
+        nodes.pop_back();
+        if (member < isles) {joinSets(&parts, part, member); }
+        if (member == done.node) {break; }
+      }
+    }
+    nodes.clear();
+  }
+
+  // a region per group of joined parts, the largest first
+  std::vector<int> index(isles, -1);
+  for (int i = 0; i < isles; i++) {
+    if (!open[i]) {continue; }
+    int part = findSet(&parts, i);
+    if (index[part] < 0) {
+      index[part] = _regions.size();
+      _regions.push_back(std::vector<int>());
+    }
+    _regions[index[part]].push_back(i);
+  }
+  std::stable_sort(_regions.begin(), _regions.end(),
+   [](const std::vector<int>& a, const std::vector<int>& b) {
+    return a.size() > b.size();
+  });
+  for (unsigned int r = 0; r < _regions.size(); r++) {
+    for (unsigned int i = 0; i < _regions[r].size(); i++) {
+      _regionOf[_regions[r][i]] = r;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+bool RegionSolver::solve(const int threads, std::vector<Bridge>* solution) {
+  _stopped = false;
+  _nodes = 0;
+  if (!_root.possible()) {return false; }
+  if (_regions.size() <= 1) {return solveWhole(threads, solution); }
+
+  // every worker owns a Solver and takes the next region (the largest ones
+  // first); extra threads help the Solvers
+  int regions = _regions.size();
+  int workers = std::max(1, std::min(threads, regions));
+  int helpers = std::max(1, threads / workers);
+  std::vector< std::vector<Bridge> > results(regions);
+  std::atomic<int> next(0);
+  std::atomic<bool> failed(false);
+  std::atomic<bool> interrupted(false);
+  auto work = [&]() {
+    Solver solver(_numbers);
+    solver.setStop(_stop);
+    solver.setDeadline(_deadline);
+    int r;
+    while (!failed && (r = next++) < regions) {
+      solver.setRegion(_regions[r]);
+      bool found = solver.solve(helpers, &results[r]);
+      _nodes += solver.nodes();
+      if (solver.stopped()) {
+        interrupted = true;
+        failed = true;
+      } else if (!found) {
+        failed = true;
+      }
+    }
+  };
+  std::vector<std::thread> pool;
+  for (int i = 1; i < workers; i++) {
+    pool.push_back(std::thread(work));
+  }
+  work();
+  for (unsigned int i = 0; i < pool.size(); i++) {
+    pool[i].join();
+  }
+  _stopped = interrupted;
+  if (failed) {return false; }
+
+  // the decided slots keep their root count, the others are taken from the
+  // region of their isles
+  const IsleGraph& graph = _root.graph();
+  std::vector<int> counts(graph.slots().size());
+  for (unsigned int s = 0; s < counts.size(); s++) {
+    counts[s] = _root.lo(s) == _root.hi(s) ? _root.lo(s) : 0;
+  }
+  for (int r = 0; r < regions; r++) {
+    for (unsigned int i = 0; i < results[r].size(); i++) {
+      const Bridge& bridge = results[r][i];
+      int s = graph.slotBetween(bridge.x1, bridge.y1, bridge.x2, bridge.y2);
+      if (s >= 0 && _regionOf[graph.slots()[s].a] == r) {
+        counts[s] = bridge.count;
+      }
+    }
+  }
+  solution->clear();
+  for (unsigned int s = 0; s < counts.size(); s++) {
+    if (counts[s] == 0) {continue; }
+    const Isle& a = graph.isles()[graph.slots()[s].a];
+    const Isle& b = graph.isles()[graph.slots()[s].b];
+    solution->push_back(Bridge(a.x, a.y, b.x, b.y, counts[s]));
+  }
+  // the merged bridges are a solution by construction, the check is cheap
+  if (graph.verify(*solution)) {return true; }
+  return solveWhole(threads, solution);
+}
+
+// ____________________________________________________________________________
+bool RegionSolver::solveWhole(const int threads,
+ std::vector<Bridge>* solution) {
+  Solver solver(_numbers);
+  solver.setStop(_stop);
+  solver.setDeadline(_deadline);
+  bool found = solver.solve(threads, solution);
+  _nodes += solver.nodes();
+  _stopped = solver.stopped();
+  return found;
+}
@@ -0,0 +1,83 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef REGIONSOLVER_H_
+#define REGIONSOLVER_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <vector>
+#include "./Bridge.h"
+#include "./PositionCheck.h"
+
+// Splits a puzzle into regions that can be solved independently and solves
+// them in parallel. The isle values and the crossings of the empty field
+// are propagated first (see PositionCheck). The undecided slots, joined by
+// their isles and by crossings, form parts that don't influence each
+// other's bridge counts. Only the connectivity of the isles links them: the
+// sure bridges join the isles to clusters and a part connects the clusters
+// it touches. Parts on a cycle of this part-cluster graph are merged into
+// one region (the biconnected blocks of the graph), the rest are joined at
+// articulation clusters only. Then a region connects the puzzle iff it
+// connects its own clusters, so every region is searched on its own by a
+// Solver restricted to its isles (see Solver::setRegion()) and the results
+// are merged into one solution.
+class RegionSolver {
+ public:
+  // Propagate the empty field and split it into regions.
+  explicit RegionSolver(const std::vector< std::vector<int> >& numbers);
+  FRIEND_TEST(RegionSolver, constructor);
+
+  // Search a solution.
+  // Arguments:
+  //   const int threads - the amount of worker threads, the regions are
+  //     spread over them (a single region uses them all)
+  //   std::vector<Bridge>* solution - receives the bridges, a double
+  //     bridge has the count 2
+  // Returns:
+  //   bool - true if a solution was found, false if there is none
+  bool solve(const int threads, std::vector<Bridge>* solution);
+  FRIEND_TEST(RegionSolver, solve);
+
+  // The amount of regions that are searched (0 if the propagation already
+  // decided every slot or showed that there is no solution).
+  int regions() const { return _regions.size(); }
+
+  // See Solver::setStop() and Solver::setDeadline().
+  void setStop(const std::atomic<bool>* stop) { _stop = stop; }
+  void setDeadline(const std::chrono::steady_clock::time_point deadline) {
+    _deadline = deadline;
+  }
+  FRIEND_TEST(RegionSolver, stop);
+
+  // Returns: bool - true if the last search was interrupted (the result of
+  // solve() says nothing then)
+  bool stopped() const { return _stopped; }
+
+  // The amount of search nodes of the last search (all regions).
+  int64_t nodes() const { return _nodes; }
+
+ private:
+  std::vector< std::vector<int> > _numbers;
+  // the domains of the empty field
+  PositionCheck _root;
+  // the isles of every region, largest first
+  std::vector< std::vector<int> > _regions;
+  // the region of every isle (-1: all its slots are decided)
+  std::vector<int> _regionOf;
+
+  const std::atomic<bool>* _stop;
+  std::chrono::steady_clock::time_point _deadline;
+  bool _stopped;
+  std::atomic<int64_t> _nodes;
+
+  // Compute _regions and _regionOf from the root domains.
+  void decompose();
+
+  // Solve the puzzle with one Solver for the whole field.
+  bool solveWhole(const int threads, std::vector<Bridge>* solution);
+};
+
+#endif  // REGIONSOLVER_H_
@@ -0,0 +1,96 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+#include "./Generator.h"
+#include "./IsleGraph.h"
+#include "./RegionSolver.h"
+#include "./Solver.h"
+
+namespace {
+// two rings of 3s (two solutions each), linked by forced double bridges
+// over the isles (4,2) and (4,4)
+const std::vector< std::vector<int> > kRings = {{3, 0, 3, 0, 0, 0, 0, 0, 0},
+                                                {0, 0, 0, 0, 0, 0, 0, 0, 0},
+                                                {3, 0, 5, 0, 4, 0, 0, 0, 0},
+                                                {0, 0, 0, 0, 0, 0, 0, 0, 0},
+                                                {0, 0, 0, 0, 4, 0, 5, 0, 3},
+                                                {0, 0, 0, 0, 0, 0, 0, 0, 0},
+                                                {0, 0, 0, 0, 0, 0, 3, 0, 3}};
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(RegionSolver, constructor) {
+  RegionSolver rings(kRings);
+  IsleGraph graph(kRings);
+  ASSERT_EQ(2, rings.regions());
+  ASSERT_EQ(4, rings._regions[0].size());
+  ASSERT_EQ(4, rings._regions[1].size());
+  ASSERT_EQ(rings._regionOf[graph.isleAt(0, 0)],
+            rings._regionOf[graph.isleAt(2, 2)]);
+  ASSERT_NE(rings._regionOf[graph.isleAt(0, 0)],
+            rings._regionOf[graph.isleAt(8, 6)]);
+  // the isles with forced bridges only belong to no region
+  ASSERT_EQ(-1, rings._regionOf[graph.isleAt(4, 2)]);
+  ASSERT_EQ(-1, rings._regionOf[graph.isleAt(4, 4)]);
+
+  // everything is decided by the propagation
+  RegionSolver line({{1, 0, 1}});
+  ASSERT_EQ(0, line.regions());
+  // a contradiction of the propagation
+  RegionSolver impossible({{1, 0, 0},
+                           {0, 0, 0},
+                           {0, 0, 1}});
+  ASSERT_EQ(0, impossible.regions());
+}
+
+// _____________________________________________________________________________
+TEST(RegionSolver, solve) {
+  RegionSolver rings(kRings);
+  std::vector<Bridge> solution;
+  ASSERT_TRUE(rings.solve(2, &solution));
+  ASSERT_TRUE(IsleGraph(kRings).verify(solution));
+  ASSERT_FALSE(rings.stopped());
+  ASSERT_LT(0, rings.nodes());
+
+  // the right ring has an odd sum of values
+  std::vector< std::vector<int> > odd = kRings;
+  odd[6][8] = 4;
+  RegionSolver broken(odd);
+  ASSERT_FALSE(broken.solve(2, &solution));
+  ASSERT_FALSE(broken.stopped());
+  ASSERT_FALSE(RegionSolver({{1, 0, 0},
+                             {0, 0, 0},
+                             {0, 0, 1}}).solve(1, &solution));
+  ASSERT_TRUE(RegionSolver({{1, 0, 1}}).solve(1, &solution));
+  ASSERT_EQ(1, solution.size());
+
+  // the same verdict as the search of the whole field
+  for (unsigned int seed = 1; seed <= 5; seed++) {
+    std::vector< std::vector<int> > numbers;
+    Generator generator(30, 30, seed);
+    generator.generate(120, &numbers);
+    RegionSolver regions(numbers);
+    ASSERT_TRUE(regions.solve(1 + seed % 3, &solution));
+    ASSERT_TRUE(IsleGraph(numbers).verify(solution));
+    numbers[0][0] = numbers[0][0] == 0 ? 1 : 0;
+    Solver whole(numbers);
+    RegionSolver changed(numbers);
+    ASSERT_EQ(whole.solve(1, &solution), changed.solve(2, &solution));
+  }
+}
+
+// _____________________________________________________________________________
+TEST(RegionSolver, stop) {
+  RegionSolver rings(kRings);
+  std::atomic<bool> stop(true);
+  rings.setStop(&stop);
+  std::vector<Bridge> solution;
+  ASSERT_FALSE(rings.solve(2, &solution));
+  ASSERT_TRUE(rings.stopped());
+  stop = false;
+  ASSERT_TRUE(rings.solve(2, &solution));
+  ASSERT_FALSE(rings.stopped());
+}
@@ -0,0 +1,138 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "./FileInterpreter.h"
+#include "./SaveGame.h"
+
+namespace {
+
+// Read the next line within the byte budget.
+// Returns: bool - false at the end of the input or if the budget ran out
+bool nextLine(std::istream* in, std::string* line, int64_t* budget) {
+  return FileInterpreter::readLine(in, line, budget) > 0;
+}
+
+// Read "<name> <count>" and return the count (-1 if the line is missing).
+int readHeader(std::istream* in, const std::string& name, int64_t* budget) {
+  std::string line;
+  if (!nextLine(in, &line, budget)) {return -1; }
+  std::stringstream header(line);
+  std::string word;
+  int count = -1;
+  if (!(header >> word >> count) || word != name) {
+    return -1;
+  }
+  return count;
+}
+
+// Read the bridges section: a header and count lines in the .xy.solution
+// format.
+bool readBridges(std::istream* in, std::vector<Bridge>* bridges,
+ int64_t* budget) {
+  int count = readHeader(in, "bridges", budget);
+  if (count < 0) {return false; }
+  std::string text;
+  std::string line;
+  for (int i = 0; i < count; i++) {
+    if (!nextLine(in, &line, budget) || line.length() == 0) {return false; }
+    text += line + "\n";
+  }
+  std::stringstream body(text);
+  if (!FileInterpreter::readSolution(&body, bridges)) {
+    return false;
+  }
+  int lines = 0;
+  for (unsigned int i = 0; i < bridges->size(); i++) {
+    lines += (*bridges)[i].count;
+  }
+  return lines == count;
+}
+
+// Read the undo section: a header and one line per entry, empty entries
+// are written as 0,0,0,0.
+bool readUndos(std::istream* in, std::vector<Bridge>* undos,
+ int64_t* budget) {
+  int count = readHeader(in, "undos", budget);
+  if (count < 0) {return false; }
+  undos->clear();
+  std::string line;
+  for (int i = 0; i < count; i++) {
+    int x1, y1, x2, y2;
+    if (!nextLine(in, &line, budget)
+        || sscanf(line.c_str(), "%d,%d,%d,%d", &x1, &y1, &x2, &y2) != 4) {
+      return false;
+    }
+    bool empty = x1 == 0 && y1 == 0 && x2 == 0 && y2 == 0;
+    undos->push_back(Bridge(x1, y1, x2, y2, empty ? 0 : 1));
+  }
+  return true;
+}
+
+}  // namespace
+
+// ____________________________________________________________________________
+void SaveGame::write(std::ostream* out, const GameSnapshot& snapshot) {
+  *out << "puzzle " << snapshot.puzzle << "\n";
+  *out << "elapsed " << snapshot.elapsed << "\n";
+  int lines = 0;
+  for (unsigned int i = 0; i < snapshot.bridges.size(); i++) {
+    lines += snapshot.bridges[i].count;
+  }
+  *out << "bridges " << lines << "\n";
+  FileInterpreter::writeSolution(out, snapshot.bridges);
+  *out << "undos " << snapshot.undos.size() << "\n";
+  for (unsigned int i = 0; i < snapshot.undos.size(); i++) {
+    const Bridge& undo = snapshot.undos[i];
+    *out << undo.x1 << "," << undo.y1 << "," << undo.x2 << "," << undo.y2
+     << "\n";
+  }
+}
+
+// ____________________________________________________________________________
+bool SaveGame::read(std::istream* in, GameSnapshot* snapshot,
+ const LoadLimits& limits) {
+  int64_t budget = limits.maxBytes;
+  std::string line;
+  std::string word;
+  if (!nextLine(in, &line, &budget)) {return false; }
+  std::stringstream puzzle(line);
+  if (!(puzzle >> word >> snapshot->puzzle) || word != "puzzle") {
+    return false;
+  }
+  if (!nextLine(in, &line, &budget)) {return false; }
+  std::stringstream elapsed(line);
+  if (!(elapsed >> word >> snapshot->elapsed) || word != "elapsed") {
+    return false;
+  }
+  return readBridges(in, &snapshot->bridges, &budget)
+      && readUndos(in, &snapshot->undos, &budget);
+}
+
+// ____________________________________________________________________________
+bool SaveGame::save(const std::string& file, const GameSnapshot& snapshot) {
+  std::string temp = file + ".tmp";
+  {
+    std::ofstream out(temp.c_str());
+    if (!out.is_open()) {return false; }
+    write(&out, snapshot);
+    out.flush();
+    if (!out) {
+      out.close();
+      remove(temp.c_str());
+      return false;
+    }
+  }
+  return rename(temp.c_str(), file.c_str()) == 0;
+}
+
+// ____________________________________________________________________________
+bool SaveGame::load(const std::string& file, GameSnapshot* snapshot) {
+  std::ifstream in(file.c_str());
+  if (!in.is_open()) {return false; }
+  return read(&in, snapshot);
+}
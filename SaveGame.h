@@ -0,0 +1,62 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef SAVEGAME_H_
+#define SAVEGAME_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "./Bridge.h"
+#include "./LoadLimits.h"
+
+// The full state of a game. Snapshots are never changed after they were
+// taken, so a writer thread can read them while the game goes on.
+struct GameSnapshot {
+  // SolutionCache::contentHash() of the puzzle the state belongs to
+  uint64_t puzzle;
+  // the drawn bridges
+  std::vector<Bridge> bridges;
+  // the undo list (see Hashi::_undos)
+  std::vector<Bridge> undos;
+  // seconds played so far
+  double elapsed;
+};
+
+// Reads and writes save files. A save file is a small text file:
+//   puzzle <hash>
+//   elapsed <seconds>
+//   bridges <n>
+//   <n lines x1,y1,x2,y2 in the .xy.solution format>
+//   undos <n>
+//   <n lines x1,y1,x2,y2, one per undo entry>
+class SaveGame {
+ public:
+  // Write a snapshot in the save file format.
+  static void write(std::ostream* out, const GameSnapshot& snapshot);
+
+  // Read a snapshot in the save file format, at most limits.maxBytes of it.
+  // Returns:
+  //   bool - false if the input is no valid save file
+  static bool read(std::istream* in, GameSnapshot* snapshot,
+   const LoadLimits& limits = LoadLimits());
+  FRIEND_TEST(SaveGame, writeAndRead);
+
+  // Write a snapshot to a file. The snapshot goes to "<file>.tmp" first
+  // and replaces the file by rename(), so a crash never leaves a half
+  // written save file.
+  // Returns:
+  //   bool - false if the file could not be written
+  static bool save(const std::string& file, const GameSnapshot& snapshot);
+
+  // Read a snapshot from a file.
+  // Returns:
+  //   bool - false if the file is missing or invalid
+  static bool load(const std::string& file, GameSnapshot* snapshot);
+  FRIEND_TEST(SaveGame, saveAndLoad);
+};
+
+#endif  // SAVEGAME_H_
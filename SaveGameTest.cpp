@@ -0,0 +1,80 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <memory>
+#include <sstream>
+#include <vector>
+#include "./AutoSaver.h"
+#include "./SaveGame.h"
+
+// _____________________________________________________________________________
+TEST(SaveGame, writeAndRead) {
+  GameSnapshot test1;
+  test1.puzzle = 1234567890123ULL;
+  test1.bridges = {{0, 0, 3, 0, 2}, {0, 0, 0, 2, 1}};
+  test1.undos = {{0, 0, 0, 0, 0}, {0, 0, 0, 2, 1}, {0, 0, 0, 2, 1}};
+  test1.elapsed = 12.5;
+  std::stringstream file;
+  SaveGame::write(&file, test1);
+  GameSnapshot read;
+  ASSERT_TRUE(SaveGame::read(&file, &read));
+  ASSERT_EQ(test1.puzzle, read.puzzle);
+  ASSERT_EQ(test1.bridges, read.bridges);
+  ASSERT_EQ(test1.undos, read.undos);
+  ASSERT_DOUBLE_EQ(12.5, read.elapsed);
+
+  // missing rows
+  std::stringstream broken("puzzle 1\nelapsed 0\nbridges 2\n0,0,3,0\n");
+  ASSERT_FALSE(SaveGame::read(&broken, &read));
+  std::stringstream empty("");
+  ASSERT_FALSE(SaveGame::read(&empty, &read));
+}
+
+// _____________________________________________________________________________
+TEST(SaveGame, saveAndLoad) {
+  GameSnapshot test2;
+  test2.puzzle = 7;
+  test2.bridges = {{1, 2, 1, 5, 1}};
+  test2.elapsed = 3;
+  unlink("thisIsATest.save");
+  GameSnapshot read;
+  ASSERT_FALSE(SaveGame::load("thisIsATest.save", &read));
+  ASSERT_TRUE(SaveGame::save("thisIsATest.save", test2));
+  ASSERT_TRUE(SaveGame::load("thisIsATest.save", &read));
+  ASSERT_EQ(test2.bridges, read.bridges);
+  ASSERT_EQ(0, access("thisIsATest.save.tmp", F_OK) == 0);
+  ASSERT_FALSE(SaveGame::save("noSuchDirectory/thisIsATest.save", test2));
+  unlink("thisIsATest.save");
+}
+
+// _____________________________________________________________________________
+TEST(AutoSaver, scheduleAndFlush) {
+  unlink("thisIsATest.save");
+  GameSnapshot read;
+  {
+    AutoSaver test3("thisIsATest.save");
+    for (int i = 1; i <= 50; i++) {
+      std::shared_ptr<GameSnapshot> snapshot(new GameSnapshot);
+      snapshot->puzzle = 7;
+      snapshot->elapsed = i;
+      test3.schedule(snapshot);
+    }
+    test3.flush();
+    // older snapshots may be skipped, the newest one is written
+    ASSERT_GE(test3.saved(), 1);
+    ASSERT_LE(test3.saved(), 50);
+    ASSERT_TRUE(SaveGame::load("thisIsATest.save", &read));
+    ASSERT_DOUBLE_EQ(50, read.elapsed);
+
+    std::shared_ptr<GameSnapshot> last(new GameSnapshot);
+    last->puzzle = 7;
+    last->elapsed = 99;
+    test3.schedule(last);
+  }
+  // the destructor writes the pending snapshot
+  ASSERT_TRUE(SaveGame::load("thisIsATest.save", &read));
+  ASSERT_DOUBLE_EQ(99, read.elapsed);
+  unlink("thisIsATest.save");
+}
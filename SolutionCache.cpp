@@ -0,0 +1,219 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "./IsleGraph.h"
+#include "./SolutionCache.h"
+
+namespace {
+// the solution data is an array of Bridge records
+static_assert(sizeof(Bridge) == 5 * sizeof(int16_t), "Bridge is not packed");
+const char kMagic[8] = {'H', 'A', 'S', 'H', 'I', 'C', 'A', '3'};
+// amount of hash table slots of a new cache file
+const uint32_t kSlots = 1 << 14;
+
+// Returns: uint32_t - the amount of isles (values 1 - 8) of a puzzle
+uint32_t countIsles(const std::vector< std::vector<int> >& numbers) {
+  uint32_t isles = 0;
+  for (unsigned int y = 0; y < numbers.size(); y++) {
+    for (unsigned int x = 0; x < numbers[y].size(); x++) {
+      isles += numbers[y][x] > 0 && numbers[y][x] < 9;
+    }
+  }
+  return isles;
+}
+}  // namespace
+
+// ____________________________________________________________________________
+SolutionCache::SolutionCache(const char* file) {
+  _map = NULL;
+  _size = 0;
+  _fd = open(file, O_RDWR | O_CREAT, 0644);
+  if (_fd < 0) {
+    return;
+  }
+  // the first process creates the header and the empty table
+  flock(_fd, LOCK_EX);
+  struct stat st;
+  if (fstat(_fd, &st) == 0 && st.st_size == 0) {
+    Header header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.slots = kSlots;
+    header.reserved = 0;
+    header.end = sizeof(Header) + kSlots * sizeof(Slot);
+    if (ftruncate(_fd, header.end) != 0
+        || pwrite(_fd, &header, sizeof(header), 0) != sizeof(header)) {
+      flock(_fd, LOCK_UN);
+      return;
+    }
+  }
+  flock(_fd, LOCK_SH);
+  if (!remap()) {
+    // not a cache file
+    if (_map) {munmap(_map, _size); }
+    _map = NULL;
+  }
+  flock(_fd, LOCK_UN);
+}
+
+// ____________________________________________________________________________
+SolutionCache::~SolutionCache() {
+  if (_map) {
+    munmap(_map, _size);
+  }
+  if (_fd >= 0) {
+    close(_fd);
+  }
+}
+
+// ____________________________________________________________________________
+bool SolutionCache::remap() {
+  struct stat st;
+  if (fstat(_fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+    return false;
+  }
+  if (_map && static_cast<size_t>(st.st_size) == _size) {
+    return valid();
+  }
+  if (_map) {
+    munmap(_map, _size);
+  }
+  _size = st.st_size;
+  void* map = mmap(NULL, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+  _map = map == MAP_FAILED ? NULL : static_cast<char*>(map);
+  return _map != NULL && valid();
+}
+
+// ____________________________________________________________________________
+bool SolutionCache::valid() const {
+  // another process may have truncated or overwritten the file
+  const Header* header = reinterpret_cast<const Header*>(_map);
+  uint64_t slots = header->slots;
+  uint64_t table = sizeof(Header) + slots * sizeof(Slot);
+  return memcmp(header->magic, kMagic, sizeof(kMagic)) == 0
+      && slots > 0 && (slots & (slots - 1)) == 0
+      && table <= _size && header->end >= table && header->end <= _size;
+}
+
+// ____________________________________________________________________________
+uint64_t SolutionCache::contentHash(
+    const std::vector< std::vector<int> >& numbers) {
+  // FNV-1a over the proportions and the (x, y, value) triples of the isles
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  int height = numbers.size();
+  int width = height > 0 ? numbers[0].size() : 0;
+  int values[3] = {width, height, 0};
+  for (int i = 0; i < 2; i++) {
+    hash = (hash ^ static_cast<uint64_t>(values[i])) * 0x100000001b3ULL;
+  }
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      if (numbers[y][x] > 0 && numbers[y][x] < 9) {
+        values[0] = x;
+        values[1] = y;
+        values[2] = numbers[y][x];
+        for (int i = 0; i < 3; i++) {
+          hash = (hash ^ static_cast<uint64_t>(values[i])) * 0x100000001b3ULL;
+        }
+      }
+    }
+  }
+  // 0 marks free slots
+  return hash == 0 ? 1 : hash;
+}
+
+// ____________________________________________________________________________
+SolutionCache::Slot* SolutionCache::findSlot(const uint64_t key) const {
+  const Header* header = reinterpret_cast<const Header*>(_map);
+  Slot* slots = reinterpret_cast<Slot*>(_map + sizeof(Header));
+  for (uint32_t i = 0; i < header->slots; i++) {
+    Slot* slot = &slots[(key + i) & (header->slots - 1)];
+    if (slot->key == key || slot->key == 0) {
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+// ____________________________________________________________________________
+bool SolutionCache::lookup(const std::vector< std::vector<int> >& numbers,
+ std::vector<Bridge>* solution) {
+  if (!_map || numbers.empty()) {
+    return false;
+  }
+  uint64_t key = contentHash(numbers);
+  std::vector<Bridge> bridges;
+  flock(_fd, LOCK_SH);
+  bool found = remap() && readEntry(findSlot(key), key, numbers, &bridges);
+  flock(_fd, LOCK_UN);
+  // a collision of the hash or a damaged entry
+  if (!found || !IsleGraph(numbers).verify(bridges)) {
+    return false;
+  }
+  *solution = bridges;
+  return true;
+}
+
+// ____________________________________________________________________________
+bool SolutionCache::readEntry(const Slot* slot, const uint64_t key,
+ const std::vector< std::vector<int> >& numbers,
+ std::vector<Bridge>* bridges) const {
+  uint64_t table = sizeof(Header) + sizeof(Slot)
+      * static_cast<uint64_t>(reinterpret_cast<Header*>(_map)->slots);
+  // the data has to lie behind the table and within the mapping (the
+  // bound is divided, so a huge count can't overflow)
+  bool found = slot && slot->key == key && slot->width == numbers[0].size()
+      && slot->height == numbers.size()
+      && slot->isles == countIsles(numbers)
+      && slot->offset >= table && slot->offset <= _size
+      && slot->bridges <= (_size - slot->offset) / sizeof(Bridge);
+  if (found) {
+    bridges->resize(slot->bridges);
+    memcpy(bridges->data(), _map + slot->offset,
+     sizeof(Bridge) * slot->bridges);
+  }
+  return found;
+}
+
+// ____________________________________________________________________________
+bool SolutionCache::insert(const std::vector< std::vector<int> >& numbers,
+ const std::vector<Bridge>& solution) {
+  if (!_map || numbers.empty()) {
+    return false;
+  }
+  uint64_t key = contentHash(numbers);
+  flock(_fd, LOCK_EX);
+  bool inserted = false;
+  Slot* slot = remap() ? findSlot(key) : NULL;
+  // an entry is kept only if it solves the puzzle, a damaged one or that
+  // of a colliding puzzle is replaced
+  std::vector<Bridge> stored;
+  if (slot && readEntry(slot, key, numbers, &stored)
+      && IsleGraph(numbers).verify(stored)) {
+    inserted = true;
+  } else if (slot) {
+    // append the data, then publish the slot
+    uint64_t offset = reinterpret_cast<Header*>(_map)->end;
+    ssize_t bytes = solution.size() * sizeof(Bridge);
+    if (pwrite(_fd, solution.data(), bytes, offset) == bytes && remap()) {
+      slot = findSlot(key);
+      reinterpret_cast<Header*>(_map)->end = offset + bytes;
+      slot->offset = offset;
+      slot->bridges = solution.size();
+      slot->isles = countIsles(numbers);
+      slot->width = numbers[0].size();
+      slot->height = numbers.size();
+      slot->key = key;
+      inserted = true;
+    }
+  }
+  flock(_fd, LOCK_UN);
+  return inserted;
+}
@@ -0,0 +1,107 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef SOLUTIONCACHE_H_
+#define SOLUTIONCACHE_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "./Bridge.h"
+
+// Persistent store of puzzle solutions, keyed by a hash of the isle layout.
+// The cache file is memory-mapped: a fixed hash table of slots followed by
+// the solution data. Several processes can share one file, writers are
+// serialized by an exclusive flock(), readers take a shared one. The file
+// is not trusted: its header is checked after every mapping, and a stored
+// solution is only returned if it solves the puzzle of the lookup.
+class SolutionCache {
+ public:
+  // Open (or create) the cache file. If that fails, the cache stays
+  // disabled and lookup() / insert() do nothing.
+  explicit SolutionCache(const char* file);
+  FRIEND_TEST(SolutionCache, constructor);
+  // Unmap and close the file.
+  ~SolutionCache();
+
+  // Returns: bool - true if the cache file could be opened
+  bool isOpen() const { return _map != NULL; }
+
+  // Hash of the normalized isle layout of a _numbers matrix (see Hashi):
+  // the proportions and the isles in row order. Bridges are ignored.
+  static uint64_t contentHash(const std::vector< std::vector<int> >& numbers);
+  FRIEND_TEST(SolutionCache, contentHash);
+
+  // Look up the solution of a puzzle by its contentHash(). The entry has to
+  // match the proportions and the amount of isles of the puzzle and its
+  // bridges have to solve it (see IsleGraph::verify()), so a hash collision
+  // or a damaged file can't return a wrong solution.
+  // Arguments:
+  //   const std::vector< std::vector<int> >& numbers - the puzzle (see
+  //     Hashi)
+  //   std::vector<Bridge>* solution - receives the bridges (see Hashi _sol)
+  // Returns:
+  //   bool - true if a solution of the puzzle was found
+  bool lookup(const std::vector< std::vector<int> >& numbers,
+   std::vector<Bridge>* solution);
+  FRIEND_TEST(SolutionCache, lookupCollision);
+
+  // Store the solution of a puzzle. An existing entry is kept if it solves
+  // the puzzle (see lookup()), otherwise it is replaced.
+  // Returns:
+  //   bool - false if the cache is disabled or full
+  bool insert(const std::vector< std::vector<int> >& numbers,
+   const std::vector<Bridge>& solution);
+  FRIEND_TEST(SolutionCache, insertAndLookup);
+
+ private:
+  // file header
+  struct Header {
+    char magic[8];
+    uint32_t slots;
+    uint32_t reserved;
+    // end of the solution data
+    uint64_t end;
+  };
+
+  // hash table entry, key 0 marks a free slot
+  struct Slot {
+    uint64_t key;
+    uint64_t offset;
+    // amount of Bridge records at offset
+    uint32_t bridges;
+    // the puzzle of the entry
+    uint32_t isles;
+    uint32_t width;
+    uint32_t height;
+  };
+
+  int _fd;
+  char* _map;
+  size_t _size;
+
+  // Map the file again if it has grown since the last mapping.
+  // Returns: bool - false if the mapping failed or the header is invalid
+  //                 (see valid())
+  bool remap();
+  FRIEND_TEST(SolutionCache, remap);
+
+  // Returns: bool - true if the mapped header has the magic, a power of two
+  // of slots and a table and data end that lie within the mapping
+  bool valid() const;
+
+  // Read the entry of a slot (the file has to be mapped and locked).
+  // Returns:
+  //   bool - false if the slot doesn't hold the key, the proportions and
+  //     the amount of isles of the puzzle or its data lies outside the file
+  bool readEntry(const Slot* slot, const uint64_t key,
+   const std::vector< std::vector<int> >& numbers,
+   std::vector<Bridge>* bridges) const;
+
+  // Returns: Slot* - the slot of the key or the free slot where it belongs
+  //                  (NULL if the table is full)
+  Slot* findSlot(const uint64_t key) const;
+};
+
+#endif  // SOLUTIONCACHE_H_
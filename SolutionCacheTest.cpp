@@ -0,0 +1,166 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <vector>
+#include "./SolutionCache.h"
+
+namespace {
+// a puzzle and its solution
+const std::vector< std::vector<int> > kPuzzle = {{4, 0, 0, 3},
+                                                 {0, 0, 0, 0},
+                                                 {2, 0, 0, 1}};
+const std::vector<Bridge> kSolution = {{0, 0, 3, 0, 2}, {0, 0, 0, 2, 2},
+                                       {3, 0, 3, 2, 1}};
+}  // namespace
+
+// _____________________________________________________________________________
+TEST(SolutionCache, constructor) {
+  unlink("thisIsATest.cache");
+  SolutionCache cache("thisIsATest.cache");
+  ASSERT_TRUE(cache.isOpen());
+  ASSERT_EQ(0, memcmp(cache._map, "HASHICA3", 8));
+  SolutionCache invalid("/nonexistent/thisIsATest.cache");
+  ASSERT_FALSE(invalid.isOpen());
+  std::vector<Bridge> solution;
+  ASSERT_FALSE(invalid.lookup(kPuzzle, &solution));
+  ASSERT_FALSE(invalid.insert(kPuzzle, kSolution));
+  unlink("thisIsATest.cache");
+}
+
+// _____________________________________________________________________________
+TEST(SolutionCache, contentHash) {
+  std::vector< std::vector<int> > numbers = {{4, 0, 0, 3, 0, 0},
+                                              {0, 0, 0, 0, 0, 0},
+                                              {2, 0, 0, 1, 0, 0}};
+  uint64_t hash = SolutionCache::contentHash(numbers);
+  // drawn bridges don't change the hash
+  numbers[0][1] = 11;
+  ASSERT_EQ(hash, SolutionCache::contentHash(numbers));
+  numbers[2][3] = 2;
+  ASSERT_NE(hash, SolutionCache::contentHash(numbers));
+  numbers[2][3] = 1;
+  numbers[0].push_back(0);
+  ASSERT_NE(hash, SolutionCache::contentHash(numbers));
+}
+
+// _____________________________________________________________________________
+TEST(SolutionCache, insertAndLookup) {
+  unlink("thisIsATest.cache");
+  std::vector< std::vector<int> > other = {{1, 0, 1}};
+  std::vector<Bridge> result;
+  {
+    SolutionCache writer("thisIsATest.cache");
+    ASSERT_FALSE(writer.lookup(kPuzzle, &result));
+    ASSERT_TRUE(writer.insert(kPuzzle, kSolution));
+    ASSERT_TRUE(writer.insert(other, {{0, 0, 2, 0, 1}}));
+  }
+  // a second process sees the entries
+  SolutionCache reader("thisIsATest.cache");
+  ASSERT_TRUE(reader.lookup(kPuzzle, &result));
+  ASSERT_EQ(kSolution, result);
+  ASSERT_TRUE(reader.lookup(other, &result));
+  ASSERT_EQ(2, result[0].x2);
+  ASSERT_FALSE(reader.lookup({{2, 0, 2}}, &result));
+  unlink("thisIsATest.cache");
+}
+
+// _____________________________________________________________________________
+TEST(SolutionCache, lookupCollision) {
+  unlink("thisIsATest.cache");
+  SolutionCache cache("thisIsATest.cache");
+  ASSERT_TRUE(cache.insert(kPuzzle, kSolution));
+  SolutionCache::Slot* slot =
+      cache.findSlot(SolutionCache::contentHash(kPuzzle));
+  ASSERT_EQ(SolutionCache::contentHash(kPuzzle), slot->key);
+  std::vector<Bridge> result;
+
+  // another puzzle of the same proportions and amount of isles with the
+  // same hash gets no solution
+  std::vector< std::vector<int> > other = {{3, 0, 0, 4},
+                                           {0, 0, 0, 0},
+                                           {1, 0, 0, 2}};
+  SolutionCache::Slot copy = *slot;
+  slot->key = 0;
+  SolutionCache::Slot* collision =
+      cache.findSlot(SolutionCache::contentHash(other));
+  *collision = copy;
+  collision->key = SolutionCache::contentHash(other);
+  ASSERT_FALSE(cache.lookup(other, &result));
+  *slot = copy;
+  ASSERT_TRUE(cache.lookup(kPuzzle, &result));
+
+  // entries of another board or with data outside of the file
+  slot->width = 5;
+  ASSERT_FALSE(cache.lookup(kPuzzle, &result));
+  slot->width = 4;
+  slot->isles = 3;
+  ASSERT_FALSE(cache.lookup(kPuzzle, &result));
+  slot->isles = 4;
+  slot->offset = UINT64_MAX - 4;
+  ASSERT_FALSE(cache.lookup(kPuzzle, &result));
+  slot->offset = copy.offset;
+  slot->bridges = UINT32_MAX;
+  ASSERT_FALSE(cache.lookup(kPuzzle, &result));
+  slot->bridges = copy.bridges;
+  ASSERT_TRUE(cache.lookup(kPuzzle, &result));
+  ASSERT_EQ(kSolution, result);
+
+  // insert() replaces an entry that doesn't solve the puzzle (the file
+  // grows, so the slots are looked up again)
+  slot->bridges = 0;
+  ASSERT_FALSE(cache.lookup(kPuzzle, &result));
+  ASSERT_TRUE(cache.insert(kPuzzle, kSolution));
+  ASSERT_TRUE(cache.lookup(kPuzzle, &result));
+  ASSERT_EQ(kSolution, result);
+  slot = cache.findSlot(SolutionCache::contentHash(kPuzzle));
+  copy = *slot;
+  slot->key = 0;
+  collision = cache.findSlot(SolutionCache::contentHash(other));
+  *collision = copy;
+  collision->key = SolutionCache::contentHash(other);
+  std::vector<Bridge> solution = {Bridge(0, 0, 3, 0, 2),
+                                  Bridge(0, 0, 0, 2, 1),
+                                  Bridge(3, 0, 3, 2, 2)};
+  ASSERT_TRUE(cache.insert(other, solution));
+  ASSERT_TRUE(cache.lookup(other, &result));
+  ASSERT_EQ(solution, result);
+  unlink("thisIsATest.cache");
+}
+
+// _____________________________________________________________________________
+TEST(SolutionCache, remap) {
+  unlink("thisIsATest.cache");
+  SolutionCache cache("thisIsATest.cache");
+  ASSERT_TRUE(cache.insert(kPuzzle, kSolution));
+  SolutionCache::Header* header =
+      reinterpret_cast<SolutionCache::Header*>(cache._map);
+  std::vector<Bridge> result;
+  // a header written by another program
+  header->slots = 3;
+  ASSERT_FALSE(cache.remap());
+  ASSERT_FALSE(cache.lookup(kPuzzle, &result));
+  ASSERT_FALSE(cache.insert({{1, 0, 1}}, {{0, 0, 2, 0, 1}}));
+  header->slots = 1U << 31;
+  ASSERT_FALSE(cache.lookup(kPuzzle, &result));
+  header->slots = 1 << 14;
+  uint64_t end = header->end;
+  header->end = cache._size + 1;
+  ASSERT_FALSE(cache.lookup(kPuzzle, &result));
+  header->end = end;
+  ASSERT_TRUE(cache.lookup(kPuzzle, &result));
+
+  // another process truncates the file: no access behind the mapping
+  int fd = open("thisIsATest.cache", O_RDWR);
+  ASSERT_EQ(0, ftruncate(fd, 64));
+  close(fd);
+  ASSERT_FALSE(cache.lookup(kPuzzle, &result));
+  ASSERT_FALSE(cache.insert(kPuzzle, kSolution));
+  // a truncated file can't be opened
+  SolutionCache truncated("thisIsATest.cache");
+  ASSERT_FALSE(truncated.isOpen());
+  unlink("thisIsATest.cache");
+}
@@ -0,0 +1,93 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Load generator for the solve service: sends the given puzzle files
+// round-robin as solve requests over a Unix domain socket and reports the
+// throughput.
+int main(int argc, char** argv) {
+  if (argc < 4) {
+    fprintf(stderr, "Usage: ./SolveClientMain <socket> <requests> "
+     "<puzzle.xy|puzzle.plain>...\n");
+    return 1;
+  }
+  int total = atoi(argv[2]);
+
+  // one request line per puzzle file
+  std::vector<std::string> requests;
+  for (int i = 3; i < argc; i++) {
+    std::ifstream file(argv[i]);
+    std::string line;
+    std::string request = strstr(argv[i], ".plain") ? "solve plain "
+     : "solve xy ";
+    bool first = true;
+    while (getline(file, line)) {
+      if (line.length() == 0 || line[0] == '#') {continue; }
+      request += (first ? "" : ";") + line;
+      first = false;
+    }
+    requests.push_back(request + "\n");
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, argv[1], sizeof(address.sun_path) - 1);
+  if (fd < 0 || connect(fd, reinterpret_cast<struct sockaddr*>(&address),
+      sizeof(address)) != 0) {
+    fprintf(stderr, "Error connecting to %s\n", argv[1]);
+    return 1;
+  }
+
+  std::chrono::steady_clock::time_point start =
+   std::chrono::steady_clock::now();
+  // send in windows of requests so the service can batch them
+  const int window = 256;
+  int answered = 0;
+  int errors = 0;
+  std::string buffer;
+  char chunk[1 << 16];
+  for (int sent = 0; sent < total;) {
+    std::string batch;
+    int count = 0;
+    for (; count < window && sent < total; count++, sent++) {
+      batch += requests[sent % requests.size()];
+    }
+    if (write(fd, batch.data(), batch.size()) != (ssize_t) batch.size()) {
+      fprintf(stderr, "Error sending requests\n");
+      return 1;
+    }
+    // wait for all replies of the window
+    while (answered < sent) {
+      ssize_t bytes = read(fd, chunk, sizeof(chunk));
+      if (bytes <= 0) {
+        fprintf(stderr, "Connection closed\n");
+        return 1;
+      }
+      buffer.append(chunk, bytes);
+      size_t end;
+      while ((end = buffer.find('\n')) != std::string::npos) {
+        if (buffer.compare(0, 5, "error") == 0) {errors++; }
+        buffer.erase(0, end + 1);
+        answered++;
+      }
+    }
+  }
+  double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  printf("%d requests in %.3f s: %.0f requests/s, %d errors\n", answered,
+   seconds, answered / seconds, errors);
+  close(fd);
+  return 0;
+}
@@ -0,0 +1,332 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+#include "./ClauseSolver.h"
+#include "./FileInterpreter.h"
+#include "./RegionSolver.h"
+#include "./SolveService.h"
+
+// ____________________________________________________________________________
+SolveService::SolveService(const int threads, const char* cacheFile)
+  : _pool(threads) {
+  _budget = kBudget;
+  _clauses = false;
+  _puzzleBytes = 0;
+  _replyBytes = 0;
+  if (cacheFile[0] != '\0') {
+    _cache.reset(new SolutionCache(cacheFile));
+  }
+}
+
+// ____________________________________________________________________________
+std::string SolveService::toLines(const std::string& payload) {
+  std::string lines = payload;
+  for (unsigned int i = 0; i < lines.size(); i++) {
+    if (lines[i] == ';') {
+      lines[i] = '\n';
+    }
+  }
+  return lines;
+}
+
+// ____________________________________________________________________________
+std::string SolveService::handle(const std::string& request) {
+  // command, format and payload are separated by the first two spaces
+  size_t first = request.find(' ');
+  size_t second = first == std::string::npos ? first
+      : request.find(' ', first + 1);
+  if (second == std::string::npos) {
+    return "error expected: solve|verify xy|plain <puzzle>";
+  }
+  std::string command = request.substr(0, first);
+  std::string format = request.substr(first + 1, second - first - 1);
+  std::string payload = request.substr(second + 1);
+  if (!payload.empty() && payload[payload.size() - 1] == '\r') {
+    payload.erase(payload.size() - 1);
+  }
+  if (format != "xy" && format != "plain") {
+    return "error unknown format " + format;
+  }
+
+  if (command == "solve") {
+    return solve(format, payload);
+  }
+  if (command == "verify") {
+    size_t bar = payload.find('|');
+    if (bar == std::string::npos) {
+      return "error expected: verify xy|plain <puzzle> | <solution>";
+    }
+    // one space around the '|' belongs to the separator
+    std::string field = payload.substr(0, bar);
+    if (!field.empty() && field[field.size() - 1] == ' ') {
+      field.erase(field.size() - 1);
+    }
+    std::string error;
+    std::shared_ptr<const IsleGraph> graph = puzzle(format, field, &error);
+    if (!graph) {
+      return "error " + error;
+    }
+    std::istringstream in(toLines(payload.substr(bar + 1)));
+    std::vector<Bridge> solution;
+    if (!FileInterpreter::readSolution(&in, &solution)) {
+      return "error invalid solution";
+    }
+    return graph->verify(solution) ? "valid" : "invalid";
+  }
+  return "error unknown command " + command;
+}
+
+// ____________________________________________________________________________
+std::shared_ptr<const IsleGraph> SolveService::puzzle(
+    const std::string& format, const std::string& payload,
+    std::string* error) {
+  std::string key = format + " " + payload;
+  {
+    std::lock_guard<std::mutex> lock(_warmMutex);
+    auto it = _puzzles.find(key);
+    if (it != _puzzles.end()) {
+      return it->second;
+    }
+  }
+
+  std::istringstream in(toLines(payload));
+  std::vector< std::vector<int> > numbers;
+  bool valid = format == "xy"
+      ? FileInterpreter::readFieldxy(&in, &numbers, error)
+      : FileInterpreter::readFieldPlain(&in, &numbers, error);
+  if (!valid) {
+    return std::shared_ptr<const IsleGraph>();
+  }
+  std::shared_ptr<const IsleGraph> graph(new IsleGraph(numbers));
+
+  // the graph takes about as many bytes as the payload
+  if (key.size() > kWarmBytes / kWarmShare) {
+    return graph;
+  }
+  std::lock_guard<std::mutex> lock(_warmMutex);
+  if (_puzzles.size() >= kWarmEntries
+      || _puzzleBytes + 2 * key.size() > kWarmBytes) {
+    _puzzles.clear();
+    _puzzleBytes = 0;
+  }
+  if (_puzzles.insert(std::make_pair(key, graph)).second) {
+    _puzzleBytes += 2 * key.size();
+  }
+  return graph;
+}
+
+// ____________________________________________________________________________
+std::string SolveService::solve(const std::string& format,
+ const std::string& payload) {
+  std::string key = format + " " + payload;
+  {
+    std::lock_guard<std::mutex> lock(_warmMutex);
+    auto it = _replies.find(key);
+    if (it != _replies.end()) {
+      return it->second;
+    }
+  }
+
+  std::string error;
+  std::shared_ptr<const IsleGraph> graph = puzzle(format, payload, &error);
+  if (!graph) {
+    return "error " + error;
+  }
+  // the solvers work on the _numbers matrix of the puzzle
+  std::vector< std::vector<int> > numbers(graph->height(),
+   std::vector<int>(graph->width()));
+  for (unsigned int i = 0; i < graph->isles().size(); i++) {
+    const Isle& isle = graph->isles()[i];
+    numbers[isle.y][isle.x] = isle.value;
+  }
+
+  std::vector<Bridge> solution;
+  bool solved = false;
+  if (_cache) {
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    solved = _cache->lookup(numbers, &solution);
+  }
+  if (!solved) {
+    // the batch is already spread over the pool, so one thread per puzzle
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(_budget));
+    bool stopped;
+    if (_clauses) {
+      ClauseSolver solver(numbers);
+      solver.setDeadline(deadline);
+      solved = solver.solve(&solution);
+      stopped = solver.stopped();
+    } else {
+      RegionSolver solver(numbers);
+      solver.setDeadline(deadline);
+      solved = solver.solve(1, &solution);
+      stopped = solver.stopped();
+    }
+    if (!solved && stopped) {
+      // not remembered, a later request may get more time
+      return "unknown";
+    }
+    if (solved && _cache) {
+      std::lock_guard<std::mutex> lock(_cacheMutex);
+      _cache->insert(numbers, solution);
+    }
+  }
+
+  std::ostringstream reply;
+  if (solved) {
+    reply << "solution ";
+    bool first = true;
+    for (unsigned int i = 0; i < solution.size(); i++) {
+      for (int j = 0; j < solution[i].count; j++) {
+        reply << (first ? "" : ";") << solution[i].x1 << "," << solution[i].y1
+         << "," << solution[i].x2 << "," << solution[i].y2;
+        first = false;
+      }
+    }
+  } else {
+    reply << "unsolvable";
+  }
+
+  size_t bytes = key.size() + reply.str().size();
+  if (bytes > kWarmBytes / kWarmShare) {
+    return reply.str();
+  }
+  std::lock_guard<std::mutex> lock(_warmMutex);
+  if (_replies.size() >= kWarmEntries || _replyBytes + bytes > kWarmBytes) {
+    _replies.clear();
+    _replyBytes = 0;
+  }
+  if (_replies.insert(std::make_pair(key, reply.str())).second) {
+    _replyBytes += bytes;
+  }
+  return reply.str();
+}
+
+// ____________________________________________________________________________
+void SolveService::serveStream(const int in, const int out) {
+  std::string buffer;
+  std::vector<std::string> requests;
+  std::vector<std::string> replies;
+  char chunk[1 << 16];
+  bool open = true;
+  // the rest of a line that exceeded kMaxLine is dropped
+  bool skipping = false;
+  // the buffer holds no newline before this position
+  size_t searched = 0;
+  while (open) {
+    ssize_t bytes = read(in, chunk, sizeof(chunk));
+    if (bytes > 0) {
+      buffer.append(chunk, bytes);
+    } else {
+      // answer an unterminated last line
+      open = false;
+      if (!buffer.empty() && !skipping) {buffer += '\n'; }
+    }
+
+    // the complete lines form the next batch, an empty request stands for
+    // a line that was too long
+    requests.clear();
+    size_t start = 0;
+    size_t end;
+    while ((end = buffer.find('\n', std::max(start, searched)))
+           != std::string::npos) {
+      if (skipping) {
+        skipping = false;
+      } else if (end - start > kMaxLine) {
+        requests.push_back("");
+      } else if (end > start) {
+        requests.push_back(buffer.substr(start, end - start));
+      }
+      start = end + 1;
+    }
+    buffer.erase(0, start);
+    if (buffer.size() > kMaxLine) {
+      if (!skipping) {requests.push_back(""); }
+      skipping = true;
+      buffer.clear();
+    }
+    searched = buffer.size();
+    if (requests.empty()) {continue; }
+
+    replies.assign(requests.size(), "");
+    _pool.run(requests.size(), [this, &requests, &replies](int i) {
+      replies[i] = requests[i].empty() ? "error request line too long"
+          : handle(requests[i]);
+    });
+    std::string output;
+    for (unsigned int i = 0; i < replies.size(); i++) {
+      output += replies[i];
+      output += '\n';
+    }
+    for (size_t written = 0; written < output.size();) {
+      ssize_t n = write(out, output.data() + written,
+       output.size() - written);
+      if (n <= 0) {return; }
+      written += n;
+    }
+  }
+}
+
+// ____________________________________________________________________________
+bool SolveService::serveSocket(const char* path, const int clients) {
+  int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (server < 0) {
+    return false;
+  }
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+  unlink(path);
+  if (bind(server, reinterpret_cast<struct sockaddr*>(&address),
+       sizeof(address)) != 0 || listen(server, 64) != 0) {
+    close(server);
+    return false;
+  }
+
+  // a client that disconnects early must not kill the service
+  signal(SIGPIPE, SIG_IGN);
+  std::atomic<int> active(0);
+  int served = 0;
+  while (clients <= 0 || served < clients) {
+    int client = accept(server, NULL, NULL);
+    if (client < 0) {break; }
+    if (active >= kMaxClients) {
+      const char* reply = "error too many clients\n";
+      if (write(client, reply, strlen(reply)) < 0) {
+        // the client is gone already
+      }
+      close(client);
+      continue;
+    }
+    active++;
+    served++;
+    std::thread([this, client, &active] {
+      serveStream(client, client);
+      close(client);
+      active--;
+    }).detach();
+  }
+  while (active > 0) {
+    usleep(1000);
+  }
+  close(server);
+  unlink(path);
+  return true;
+}
@@ -0,0 +1,113 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef SOLVESERVICE_H_
+#define SOLVESERVICE_H_
+
+#include <gtest/gtest.h>
+#include <stddef.h>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "./IsleGraph.h"
+#include "./SolutionCache.h"
+#include "./ThreadPool.h"
+
+// Long-running solve service. Requests and replies are single lines:
+//   solve xy <lines of a .xy file, separated by ';'>
+//   solve plain <lines of a .plain file, separated by ';'>
+//   verify xy|plain <puzzle> | <lines of a .xy.solution file>
+// Replies:
+//   solution <x1,y1,x2,y2;...>   (a double bridge is listed twice)
+//   unsolvable
+//   unknown   (the search ran out of the time budget of a request)
+//   valid / invalid
+//   error <message>
+// All complete lines that arrive together form a batch, which is answered
+// by the worker pool. Parsed puzzles and solve replies stay in memory.
+// A request line may hold up to kMaxLine bytes, a longer one is answered
+// with an error and skipped. The socket serves up to kMaxClients clients
+// at once, further ones get an error and are disconnected.
+class SolveService {
+ public:
+  // Arguments:
+  //   const int threads - the amount of worker threads
+  //   const char* cacheFile - optional SolutionCache file ("" for none)
+  SolveService(const int threads, const char* cacheFile);
+
+  // Set the time a solve request may search (default kBudget seconds).
+  void setBudget(const double seconds) { _budget = seconds; }
+  FRIEND_TEST(SolveService, setBudget);
+
+  // Solve with the ClauseSolver instead of the RegionSolver (before the
+  // first request).
+  void setClauseSolver(const bool clauses) { _clauses = clauses; }
+  FRIEND_TEST(SolveService, setClauseSolver);
+
+  // Answer a single request line (thread-safe).
+  std::string handle(const std::string& request);
+  FRIEND_TEST(SolveService, handle);
+
+  // Answer the requests of a stream until it ends.
+  // Arguments:
+  //   const int in - file descriptor of the requests
+  //   const int out - file descriptor of the replies
+  void serveStream(const int in, const int out);
+  FRIEND_TEST(SolveService, serveStream);
+
+  // Listen on a Unix domain socket and serve every client in its own thread.
+  // Arguments:
+  //   const char* path - the socket file
+  //   const int clients - return after this many clients were served
+  //                       (0: serve forever), turned away ones don't count
+  // Returns:
+  //   bool - false if the socket can't be created
+  bool serveSocket(const char* path, const int clients);
+  FRIEND_TEST(SolveService, serveSocket);
+
+ private:
+  // limits of the puzzles and replies kept in memory: the amount of
+  // entries and the bytes of their payloads and replies (per map), a
+  // payload of more than kWarmBytes / kWarmShare bytes is not kept
+  static const unsigned int kWarmEntries = 100000;
+  static const size_t kWarmBytes = 1 << 26;
+  static const size_t kWarmShare = 64;
+  // the longest request line (the byte budget of a puzzle file, see
+  // LoadLimits)
+  static const size_t kMaxLine = 1 << 24;
+  // the most socket clients served at once
+  static const int kMaxClients = 64;
+  // the default time budget of a solve request in seconds
+  static const int kBudget = 10;
+
+  double _budget;
+  bool _clauses;
+
+  ThreadPool _pool;
+  std::unique_ptr<SolutionCache> _cache;
+  std::mutex _cacheMutex;
+
+  // parsed puzzles and solve replies by puzzle payload
+  std::mutex _warmMutex;
+  std::unordered_map< std::string, std::shared_ptr<const IsleGraph> >
+   _puzzles;
+  std::unordered_map<std::string, std::string> _replies;
+  // the bytes of the keys and replies in the maps
+  size_t _puzzleBytes;
+  size_t _replyBytes;
+
+  // Returns the parsed puzzle of a payload (NULL if it is invalid).
+  std::shared_ptr<const IsleGraph> puzzle(const std::string& format,
+   const std::string& payload, std::string* error);
+
+  // Solve a puzzle, look it up in the cache first.
+  std::string solve(const std::string& format, const std::string& payload);
+  FRIEND_TEST(SolveService, warmBytes);
+
+  // Split a payload at the ';' separators into the lines of a file.
+  static std::string toLines(const std::string& payload);
+};
+
+#endif  // SOLVESERVICE_H_
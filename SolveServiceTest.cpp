@@ -0,0 +1,197 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+#include "./SolveService.h"
+
+// _____________________________________________________________________________
+TEST(SolveService, handle) {
+  SolveService service(2, "");
+  std::string reply = service.handle("solve xy 0,0,4;3,0,3;0,2,2;3,2,1");
+  ASSERT_EQ("solution 0,0,3,0;0,0,3,0;0,0,0,2;0,0,0,2;3,0,3,2", reply);
+  // the same puzzle in the .plain format
+  ASSERT_EQ(reply, service.handle("solve plain 4  3;    ;2  1"));
+  ASSERT_EQ("unsolvable", service.handle("solve xy 0,0,1;2,2,1"));
+  ASSERT_EQ("valid", service.handle("verify xy 0,0,4;3,0,3;0,2,2;3,2,1 | "
+   "0,0,3,0;0,0,3,0;0,0,0,2;0,0,0,2;3,0,3,2"));
+  ASSERT_EQ("invalid", service.handle("verify xy 0,0,4;3,0,3;0,2,2;3,2,1 | "
+   "0,0,3,0;0,0,0,2;0,0,0,2;3,0,3,2"));
+  ASSERT_EQ(0, service.handle("solve xy 0,a,4").find("error"));
+  ASSERT_EQ(0, service.handle("solve json {}").find("error"));
+  ASSERT_EQ(0, service.handle("play xy 0,0,1").find("error"));
+  ASSERT_EQ(0, service.handle("verify xy 0,0,1").find("error"));
+  ASSERT_EQ(0, service.handle("nothing").find("error"));
+}
+
+// _____________________________________________________________________________
+TEST(SolveService, serveStream) {
+  SolveService service(2, "");
+  int requests[2];
+  int replies[2];
+  ASSERT_EQ(0, pipe(requests));
+  ASSERT_EQ(0, pipe(replies));
+  const char* input = "solve xy 0,0,1;2,2,1\n"
+                      "solve plain 4  3;    ;2  1\n"
+                      "\n"
+                      "verify plain 4  3;    ;2  1 | 0,0,3,0";
+  ASSERT_EQ(strlen(input), write(requests[1], input, strlen(input)));
+  close(requests[1]);
+  service.serveStream(requests[0], replies[1]);
+  close(replies[1]);
+  char output[1024];
+  ssize_t bytes = read(replies[0], output, sizeof(output) - 1);
+  output[bytes > 0 ? bytes : 0] = '\0';
+  ASSERT_STREQ("unsolvable\n"
+               "solution 0,0,3,0;0,0,3,0;0,0,0,2;0,0,0,2;3,0,3,2\n"
+               "invalid\n", output);
+  close(requests[0]);
+  close(replies[0]);
+
+  // a line that is too long is answered with an error and skipped, the
+  // next line is served
+  ASSERT_EQ(0, pipe(requests));
+  ASSERT_EQ(0, pipe(replies));
+  std::thread client([&requests] {
+    std::string line(SolveService::kMaxLine + 1000, '1');
+    line += "\nsolve xy 0,0,1;2,2,1\n";
+    for (size_t written = 0; written < line.size();) {
+      ssize_t n = write(requests[1], line.data() + written,
+       line.size() - written);
+      if (n <= 0) {break; }
+      written += n;
+    }
+    close(requests[1]);
+  });
+  service.serveStream(requests[0], replies[1]);
+  client.join();
+  close(replies[1]);
+  bytes = read(replies[0], output, sizeof(output) - 1);
+  output[bytes > 0 ? bytes : 0] = '\0';
+  ASSERT_STREQ("error request line too long\nunsolvable\n", output);
+  close(requests[0]);
+  close(replies[0]);
+}
+
+// _____________________________________________________________________________
+TEST(SolveService, setBudget) {
+  // a large puzzle without solution that takes long to refute
+  std::ifstream file("benchmarks/b001-n1500-s100x100.xy");
+  std::string request = "solve xy ";
+  std::string line;
+  while (std::getline(file, line)) {
+    request += line + ";";
+  }
+  SolveService service(1, "");
+  service.setBudget(0.05);
+  ASSERT_EQ("unknown", service.handle(request));
+  // the reply is not remembered
+  std::unique_lock<std::mutex> lock(service._warmMutex);
+  ASSERT_EQ(0, service._replies.size());
+}
+
+// _____________________________________________________________________________
+TEST(SolveService, setClauseSolver) {
+  SolveService service(2, "");
+  service.setClauseSolver(true);
+  std::string reply = service.handle("solve xy 0,0,4;3,0,3;0,2,2;3,2,1");
+  ASSERT_EQ(0, reply.find("solution "));
+  ASSERT_EQ("valid", service.handle("verify xy 0,0,4;3,0,3;0,2,2;3,2,1 | "
+   + reply.substr(9)));
+  ASSERT_EQ("unsolvable", service.handle("solve xy 0,0,1;2,2,1"));
+}
+
+// _____________________________________________________________________________
+TEST(SolveService, serveSocket) {
+  SolveService service(2, "");
+  std::thread server([&service] {
+    service.serveSocket("thisIsATest.socket", 1);
+  });
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, "thisIsATest.socket",
+   sizeof(address.sun_path) - 1);
+  int client = socket(AF_UNIX, SOCK_STREAM, 0);
+  // wait until the service listens
+  for (int i = 0; i < 1000 && connect(client,
+       reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0;
+       i++) {
+    usleep(1000);
+  }
+  const char* input = "solve xy 0,0,1;2,2,1\n";
+  ASSERT_EQ(strlen(input), write(client, input, strlen(input)));
+  char output[64];
+  ssize_t bytes = read(client, output, sizeof(output) - 1);
+  output[bytes > 0 ? bytes : 0] = '\0';
+  ASSERT_STREQ("unsolvable\n", output);
+  close(client);
+  server.join();
+
+  // the clients beyond kMaxClients are turned away and not counted
+  std::thread busy([&service] {
+    service.serveSocket("thisIsATest.socket", SolveService::kMaxClients + 1);
+  });
+  std::vector<int> clients;
+  for (int i = 0; i <= SolveService::kMaxClients; i++) {
+    clients.push_back(socket(AF_UNIX, SOCK_STREAM, 0));
+    for (int j = 0; j < 1000 && connect(clients[i],
+         reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0;
+         j++) {
+      usleep(1000);
+    }
+  }
+  bytes = read(clients[SolveService::kMaxClients], output,
+   sizeof(output) - 1);
+  output[bytes > 0 ? bytes : 0] = '\0';
+  ASSERT_STREQ("error too many clients\n", output);
+  // the others are still served
+  ASSERT_EQ(strlen(input), write(clients[0], input, strlen(input)));
+  bytes = read(clients[0], output, sizeof(output) - 1);
+  output[bytes > 0 ? bytes : 0] = '\0';
+  ASSERT_STREQ("unsolvable\n", output);
+  // a client that comes after one has left is served and ends the service
+  close(clients[0]);
+  for (int i = 0; i < 1000; i++) {
+    int late = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_EQ(0, connect(late, reinterpret_cast<struct sockaddr*>(&address),
+     sizeof(address)));
+    ASSERT_EQ(strlen(input), write(late, input, strlen(input)));
+    bytes = read(late, output, sizeof(output) - 1);
+    output[bytes > 0 ? bytes : 0] = '\0';
+    close(late);
+    if (strcmp(output, "unsolvable\n") == 0) {break; }
+    ASSERT_STREQ("error too many clients\n", output);
+    usleep(1000);
+  }
+  ASSERT_STREQ("unsolvable\n", output);
+  for (unsigned int i = 1; i < clients.size(); i++) {
+    close(clients[i]);
+  }
+  busy.join();
+}
+
+// _____________________________________________________________________________
+TEST(SolveService, warmBytes) {
+  SolveService service(1, "");
+  ASSERT_EQ("unsolvable", service.handle("solve xy 0,0,1;2,2,1"));
+  ASSERT_EQ(1, service._replies.size());
+  ASSERT_EQ(1, service._puzzles.size());
+  ASSERT_LT(0, service._replyBytes);
+  ASSERT_LT(0, service._puzzleBytes);
+  // a valid puzzle with a long comment is answered but not kept
+  std::string large = "solve xy #" + std::string(2 << 20, 'x')
+      + ";0,0,1;2,0,1";
+  ASSERT_EQ("solution 0,0,2,0", service.handle(large));
+  ASSERT_EQ(1, service._replies.size());
+  ASSERT_EQ(1, service._puzzles.size());
+  size_t limit = SolveService::kWarmBytes;
+  ASSERT_GE(limit, service._replyBytes);
+}
@@ -0,0 +1,514 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+#include "./Solver.h"
+
+namespace {
+// a worker hands the alternatives of its branch points to the others while
+// its deque holds fewer than kReadyTasks tasks
+const int kReadyTasks = 4;
+// the stop flag and the deadline are checked every kCheckNodes nodes
+const int kCheckNodes = 1024;
+// a worker without tasks looks for one kSpins times before it sleeps
+const int kSpins = 8;
+}  // namespace
+
+// ____________________________________________________________________________
+Solver::Solver(const std::vector< std::vector<int> >& numbers)
+  : _graph(numbers) {
+  _cancel = false;
+  _pending = 0;
+  _queued = 0;
+  _nodes = 0;
+  _limit = 1;
+  _count = 0;
+  _labels = 0;
+  _stop = NULL;
+  _deadline = std::chrono::steady_clock::time_point::max();
+  _stopped = false;
+}
+
+// ____________________________________________________________________________
+bool Solver::solve(const int threads, std::vector<Bridge>* solution) {
+  _limit = 1;
+  run(threads);
+  if (_count == 0) {
+    return false;
+  }
+  solution->clear();
+  for (unsigned int s = 0; s < _solution.size(); s++) {
+    if (_solution[s] == 0) {continue; }
+    const Isle& a = _graph.isles()[_graph.slots()[s].a];
+    const Isle& b = _graph.isles()[_graph.slots()[s].b];
+    solution->push_back(Bridge(a.x, a.y, b.x, b.y, _solution[s]));
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+int Solver::countSolutions(const int threads, const int limit) {
+  _limit = limit;
+  run(threads);
+  return std::min<int>(_count, limit);
+}
+
+// ____________________________________________________________________________
+void Solver::setRegion(const std::vector<int>& isles) {
+  _region = isles;
+  _inRegion.assign(_region.empty() ? 0 : _graph.isles().size(), 0);
+  for (unsigned int i = 0; i < _region.size(); i++) {
+    _inRegion[_region[i]] = 1;
+  }
+}
+
+// ____________________________________________________________________________
+void Solver::run(const int threads) {
+  int workers = std::max(1, threads);
+  _deques.clear();
+  for (int i = 0; i < workers; i++) {
+    _deques.push_back(std::unique_ptr< TaskDeque<Task> >(
+     new TaskDeque<Task>()));
+  }
+  _cancel = false;
+  _nodes = 0;
+  _count = 0;
+  _stopped = false;
+  _labels = 0;
+  if (interrupted()) {
+    _stopped = true;
+    return;
+  }
+
+  // The root task: every slot is open, the propagation of the isle values
+  // narrows the domains.
+  Task root;
+  root.slot = -1;
+  root.value = 0;
+  root.lo.assign(_graph.slots().size(), 0);
+  root.hi.assign(_graph.slots().size(), 2);
+  _pending = 1;
+  _queued = 1;
+  _deques[0]->push(std::move(root));
+
+  // the calling thread is worker 0
+  std::vector<std::thread> pool;
+  for (int i = 1; i < workers; i++) {
+    pool.push_back(std::thread(&Solver::work, this, i));
+  }
+  work(0);
+  for (unsigned int i = 0; i < pool.size(); i++) {
+    pool[i].join();
+  }
+  _deques.clear();
+}
+
+// ____________________________________________________________________________
+void Solver::work(const int id) {
+  // carve the whole search state from the arena of this worker
+  int slots = _graph.slots().size();
+  int isles = _graph.isles().size();
+  Arena arena(1 << 16);
+  Worker worker;
+  worker.id = id;
+  worker.lo = arena.allocate<uint8_t>(slots);
+  worker.hi = arena.allocate<uint8_t>(slots);
+  // every change narrows a domain of three values, so a path changes each
+  // slot at most twice
+  worker.trail = arena.allocate<Change>(2 * slots + 1);
+  worker.trailSize = 0;
+  worker.queue = arena.allocate<int>(isles + 1);
+  worker.queueSize = 0;
+  worker.queued = arena.allocate<char>(isles + 1);
+  memset(worker.queued, 0, isles + 1);
+  worker.stack = arena.allocate<int>(isles + 1);
+  worker.visited = arena.allocate<char>(isles + 1);
+  worker.nodes = 0;
+
+  int workers = _deques.size();
+  int misses = 0;
+  Task task;
+  while (!_cancel) {
+    bool found = _deques[id]->pop(&task);
+    for (int i = 1; i < workers && !found; i++) {
+      found = _deques[(id + i) % workers]->steal(&task);
+    }
+    if (!found) {
+      // all tasks are finished: the whole tree was searched
+      if (_pending == 0) {break; }
+      if (++misses < kSpins) {
+        std::this_thread::yield();
+      } else {
+        misses = 0;
+        sleep();
+      }
+      continue;
+    }
+    _queued--;
+    misses = 0;
+
+    memcpy(worker.lo, task.lo.data(), slots);
+    memcpy(worker.hi, task.hi.data(), slots);
+    worker.trailSize = 0;
+    bool consistent = true;
+    if (task.slot < 0) {
+      // root: check all isles and fix the required bridges
+      for (int i = 0; i < isles; i++) {
+        worker.queue[worker.queueSize++] = i;
+        worker.queued[i] = 1;
+      }
+      for (unsigned int i = 0; i < _required.size() && consistent; i++) {
+        const Bridge& b = _required[i];
+        int slot = _graph.slotBetween(b.x1, b.y1, b.x2, b.y2);
+        consistent = slot >= 0 && assign(&worker, slot, b.count, 2);
+      }
+      // the labels must not depend on the subtree a worker starts in
+      if (consistent && !_region.empty()) {
+        consistent = propagate(&worker);
+        if (consistent) {labelRegion(&worker); }
+      }
+    } else {
+      consistent = assign(&worker, task.slot, task.value, task.value);
+    }
+    if (consistent) {
+      explore(&worker);
+    } else {
+      clear(&worker);
+    }
+    if (--_pending == 0) {
+      wake(true);
+    }
+  }
+  _nodes += worker.nodes;
+}
+
+// ____________________________________________________________________________
+void Solver::sleep() {
+  std::unique_lock<std::mutex> lock(_idleMutex);
+  while (!_cancel && _pending > 0 && _queued <= 0) {
+    _wake.wait(lock);
+  }
+}
+
+// ____________________________________________________________________________
+void Solver::wake(const bool all) {
+  // a worker between its check of the counters and wait() holds the mutex,
+  // so it can't miss the notification
+  std::lock_guard<std::mutex> lock(_idleMutex);
+  if (all) {
+    _wake.notify_all();
+  } else {
+    _wake.notify_one();
+  }
+}
+
+// ____________________________________________________________________________
+void Solver::cancel() {
+  _cancel = true;
+  wake(true);
+}
+
+// ____________________________________________________________________________
+void Solver::report(Worker* worker) {
+  _nodes += worker->nodes;
+  worker->nodes = 0;
+  if (interrupted()) {
+    _stopped = true;
+    cancel();
+  }
+}
+
+// ____________________________________________________________________________
+bool Solver::interrupted() const {
+  return (_stop && *_stop) || std::chrono::steady_clock::now() > _deadline;
+}
+
+// ____________________________________________________________________________
+Solver::Result Solver::explore(Worker* worker) {
+  if (++worker->nodes == kCheckNodes) {
+    report(worker);
+  }
+  if (!propagate(worker) || !isConnected(worker)) {
+    return kDead;
+  }
+
+  int slot = chooseSlot(*worker);
+  if (slot < 0) {
+    std::lock_guard<std::mutex> lock(_solutionMutex);
+    if (_count == 0) {
+      _solution.assign(worker->lo, worker->lo + _graph.slots().size());
+    }
+    if (++_count >= _limit) {
+      cancel();
+    }
+    return kFound;
+  }
+
+  // the largest value is searched first
+  bool found = false;
+  bool complete = true;
+  int lo = worker->lo[slot];
+  int hi = worker->hi[slot];
+  int mark = worker->trailSize;
+  for (int value = hi; value >= lo; value--) {
+    if (_cancel) {
+      return found ? kFound : kOpen;
+    }
+    if (value < hi && _deques.size() > 1
+        && _deques[worker->id]->size() < kReadyTasks) {
+      // keep work ready for the other workers
+      Task child;
+      child.lo.assign(worker->lo, worker->lo + _graph.slots().size());
+      child.hi.assign(worker->hi, worker->hi + _graph.slots().size());
+      child.slot = slot;
+      child.value = value;
+      _pending++;
+      _queued++;
+      _deques[worker->id]->push(std::move(child));
+      wake(false);
+      complete = false;
+      continue;
+    }
+    Result result = kDead;
+    if (assign(worker, slot, value, value)) {
+      result = explore(worker);
+    } else {
+      clear(worker);
+    }
+    undo(worker, mark);
+    found = found || result == kFound;
+    complete = complete && result != kOpen;
+  }
+  if (found) {
+    return kFound;
+  }
+  return complete ? kDead : kOpen;
+}
+
+// ____________________________________________________________________________
+bool Solver::assign(Worker* worker, const int slot, const int lo,
+ const int hi) const {
+  int oldLo = worker->lo[slot];
+  int oldHi = worker->hi[slot];
+  int newLo = std::max(oldLo, lo);
+  int newHi = std::min(oldHi, hi);
+  if (newLo > newHi) {
+    return false;
+  }
+  if (newLo == oldLo && newHi == oldHi) {
+    return true;
+  }
+  Change& change = worker->trail[worker->trailSize++];
+  change.slot = slot;
+  change.lo = oldLo;
+  change.hi = oldHi;
+  worker->lo[slot] = newLo;
+  worker->hi[slot] = newHi;
+
+  // check both isles again
+  const BridgeSlot& s = _graph.slots()[slot];
+  if (!worker->queued[s.a]) {
+    worker->queued[s.a] = 1;
+    worker->queue[worker->queueSize++] = s.a;
+  }
+  if (!worker->queued[s.b]) {
+    worker->queued[s.b] = 1;
+    worker->queue[worker->queueSize++] = s.b;
+  }
+
+  if (oldLo == 0 && newLo > 0) {
+    const std::vector<int>& crossings = _graph.crossings(slot);
+    for (unsigned int c = 0; c < crossings.size(); c++) {
+      if (!assign(worker, crossings[c], 0, 0)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+void Solver::undo(Worker* worker, const int trailSize) const {
+  while (worker->trailSize > trailSize) {
+    const Change& change = worker->trail[--worker->trailSize];
+    int slot = change.slot;
+    worker->lo[slot] = change.lo;
+    worker->hi[slot] = change.hi;
+  }
+}
+
+// ____________________________________________________________________________
+bool Solver::propagate(Worker* worker) const {
+  while (worker->queueSize > 0) {
+    int isle = worker->queue[--worker->queueSize];
+    worker->queued[isle] = 0;
+
+    const std::vector<int>& slots = _graph.isleSlots(isle);
+    int value = _graph.isles()[isle].value;
+    int sumLo = 0;
+    int sumHi = 0;
+    for (unsigned int i = 0; i < slots.size(); i++) {
+      sumLo += worker->lo[slots[i]];
+      sumHi += worker->hi[slots[i]];
+    }
+    if (sumLo > value || sumHi < value) {
+      clear(worker);
+      return false;
+    }
+    // every slot has to take what the others can't give and must leave
+    // room for what the others already have
+    for (unsigned int i = 0; i < slots.size(); i++) {
+      int s = slots[i];
+      if (!assign(worker, s, value - (sumHi - worker->hi[s]),
+       value - (sumLo - worker->lo[s]))) {
+        clear(worker);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// ____________________________________________________________________________
+void Solver::clear(Worker* worker) const {
+  for (int i = 0; i < worker->queueSize; i++) {
+    worker->queued[worker->queue[i]] = 0;
+  }
+  worker->queueSize = 0;
+}
+
+// ____________________________________________________________________________
+bool Solver::isConnected(Worker* worker) const {
+  int isles = _graph.isles().size();
+  if (isles == 0) {
+    return true;
+  }
+  if (!_region.empty()) {
+    memset(worker->visited, 0, _labels);
+    int top = 0;
+    worker->stack[top++] = 0;
+    worker->visited[0] = 1;
+    int count = 1;
+    while (top > 0) {
+      int label = worker->stack[--top];
+      for (int i = _labelStart[label]; i < _labelStart[label + 1]; i++) {
+        int slot = _labelSlots[i];
+        if (worker->hi[slot] == 0) {continue; }
+        const BridgeSlot& s = _graph.slots()[slot];
+        int other = _label[s.a] == label ? _label[s.b] : _label[s.a];
+        if (!worker->visited[other]) {
+          worker->visited[other] = 1;
+          count++;
+          worker->stack[top++] = other;
+        }
+      }
+    }
+    return count == _labels;
+  }
+  memset(worker->visited, 0, isles);
+  int top = 0;
+  worker->stack[top++] = 0;
+  worker->visited[0] = 1;
+  int count = 1;
+  while (top > 0) {
+    int isle = worker->stack[--top];
+    const std::vector<int>& slots = _graph.isleSlots(isle);
+    for (unsigned int i = 0; i < slots.size(); i++) {
+      if (worker->hi[slots[i]] == 0) {continue; }
+      const BridgeSlot& s = _graph.slots()[slots[i]];
+      int other = s.a == isle ? s.b : s.a;
+      if (!worker->visited[other]) {
+        worker->visited[other] = 1;
+        count++;
+        worker->stack[top++] = other;
+      }
+    }
+  }
+  return count == isles;
+}
+
+// ____________________________________________________________________________
+void Solver::labelRegion(Worker* worker) {
+  int isles = _graph.isles().size();
+  int slots = _graph.slots().size();
+  _label.assign(isles, -1);
+  _labelStart.assign(isles + 1, 0);
+  _labelSlots.assign(2 * slots + 1, 0);
+  int* label = _label.data();
+  // depth first search over the slots that don't touch the region
+  int labels = 0;
+  for (int i = 0; i < isles; i++) {
+    if (label[i] >= 0) {continue; }
+    label[i] = labels;
+    int top = 0;
+    worker->stack[top++] = i;
+    while (top > 0 && !_inRegion[i]) {
+      int isle = worker->stack[--top];
+      const std::vector<int>& adjacent = _graph.isleSlots(isle);
+      for (unsigned int j = 0; j < adjacent.size(); j++) {
+        const BridgeSlot& s = _graph.slots()[adjacent[j]];
+        int other = s.a == isle ? s.b : s.a;
+        if (worker->hi[adjacent[j]] == 0 || _inRegion[other]
+            || label[other] >= 0) {
+          continue;
+        }
+        label[other] = labels;
+        worker->stack[top++] = other;
+      }
+    }
+    labels++;
+  }
+  // the slots of the region (and those between region and outside isles)
+  // sorted by the labels of both ends
+  int* start = _labelStart.data();
+  for (int s = 0; s < slots; s++) {
+    const BridgeSlot& slot = _graph.slots()[s];
+    if (!_inRegion[slot.a] && !_inRegion[slot.b]) {continue; }
+    start[label[slot.a] + 1]++;
+    start[label[slot.b] + 1]++;
+  }
+  for (int l = 0; l < labels; l++) {
+    start[l + 1] += start[l];
+  }
+  for (int s = 0; s < slots; s++) {
+    const BridgeSlot& slot = _graph.slots()[s];
+    if (!_inRegion[slot.a] && !_inRegion[slot.b]) {continue; }
+    _labelSlots[start[label[slot.a]]++] = s;
+    _labelSlots[start[label[slot.b]]++] = s;
+  }
+  for (int l = labels; l > 0; l--) {
+    start[l] = start[l - 1];
+  }
+  start[0] = 0;
+  _labels = labels;
+}
+
+// ____________________________________________________________________________
+int Solver::chooseSlot(const Worker& worker) const {
+  int best = -1;
+  int bestOpen = 0;
+  int isles = _region.empty() ? _graph.isles().size() : _region.size();
+  for (int k = 0; k < isles; k++) {
+    int i = _region.empty() ? k : _region[k];
+    const std::vector<int>& slots = _graph.isleSlots(i);
+    int open = 0;
+    int first = -1;
+    for (unsigned int j = 0; j < slots.size(); j++) {
+      if (worker.lo[slots[j]] != worker.hi[slots[j]]) {
+        open++;
+        if (first < 0) {first = slots[j]; }
+      }
+    }
+    if (open > 0 && (best < 0 || open < bestOpen)) {
+      best = first;
+      bestOpen = open;
+      if (open == 1) {break; }
+    }
+  }
+  return best;
+}
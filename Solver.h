@@ -0,0 +1,230 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef SOLVER_H_
+#define SOLVER_H_
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <vector>
+#include "./Arena.h"
+#include "./Bridge.h"
+#include "./IsleGraph.h"
+#include "./TaskDeque.h"
+
+// Backtracking search for a solution of a number field. Every bridge slot
+// of the IsleGraph has a domain [lo, hi] of possible bridge counts which is
+// narrowed by propagating the isle values and the crossings. The
+// alternatives of a branch point become tasks while the TaskDeque of the
+// worker holds only a few, the others are searched by the worker itself;
+// a worker without tasks steals from the others and sleeps until a task
+// is pushed.
+class Solver {
+ public:
+  // Prepare a search for the isles of the given _numbers matrix (see Hashi).
+  explicit Solver(const std::vector< std::vector<int> >& numbers);
+
+  // Search a solution.
+  // Arguments:
+  //   const int threads - the amount of worker threads
+  //   std::vector<Bridge>* solution - receives the bridges, a double
+  //     bridge has the count 2
+  // Returns:
+  //   bool - true if a solution was found, false if there is none
+  bool solve(const int threads, std::vector<Bridge>* solution);
+  FRIEND_TEST(Solver, solve);
+  FRIEND_TEST(Solver, solveParallel);
+
+  // Count the solutions, e.g. to check if a puzzle is unique.
+  // Arguments:
+  //   const int threads - the amount of worker threads
+  //   const int limit - stop counting when this amount is reached
+  // Returns:
+  //   int - the amount of solutions (at most limit)
+  int countSolutions(const int threads, const int limit);
+  FRIEND_TEST(Solver, countSolutions);
+
+  // Only search solutions that contain at least the given bridges, e.g.
+  // the bridges the player has drawn so far. A single bridge may still
+  // become a double bridge.
+  void require(const std::vector<Bridge>& bridges) { _required = bridges; }
+  FRIEND_TEST(Solver, require);
+
+  // Only decide the slots of the given isles, e.g. a part of the puzzle
+  // that does not depend on the rest (see RegionSolver). The other slots
+  // keep their propagated domains and count as possible bridges for the
+  // connectivity check, so the solution only fixes the slots of the
+  // region. An empty list searches the whole puzzle.
+  void setRegion(const std::vector<int>& isles);
+  FRIEND_TEST(Solver, setRegion);
+
+  // Interrupt the search as soon as *stop becomes true or the deadline has
+  // passed (both are checked every kCheckNodes search nodes). NULL never
+  // stops the search.
+  void setStop(const std::atomic<bool>* stop) { _stop = stop; }
+  void setDeadline(const std::chrono::steady_clock::time_point deadline) {
+    _deadline = deadline;
+  }
+  FRIEND_TEST(Solver, stop);
+
+  // Returns: bool - true if the last search was interrupted before it found
+  // the requested solutions (the result of solve() says nothing then)
+  bool stopped() const { return _stopped && _count < _limit; }
+
+  // The amount of search nodes visited by the last search. While a search
+  // is running, the count grows in steps of kCheckNodes.
+  int64_t nodes() const { return _nodes; }
+
+ private:
+  // Result of the search of a subtree.
+  enum Result {
+    // no solution in the subtree
+    kDead,
+    // at least one solution was found
+    kFound,
+    // the search was cancelled or parts of the subtree were given away
+    kOpen
+  };
+
+  // A subtree of the search that is handed to another worker: the bridge
+  // domains of all slots and the decision (slot = value) that leads into
+  // the subtree.
+  struct Task {
+    std::vector<uint8_t> lo;
+    std::vector<uint8_t> hi;
+    int slot;
+    int value;
+  };
+
+  // The domain of a slot before a change.
+  struct Change {
+    int slot;
+    uint8_t lo;
+    uint8_t hi;
+  };
+
+  // Search state of one worker. The arrays are carved from the Arena of
+  // the worker when the search starts; the search itself changes the
+  // domains in place and backtracks along the trail, so it does not
+  // allocate memory.
+  struct Worker {
+    int id;
+    // bridge domains of all slots
+    uint8_t* lo;
+    uint8_t* hi;
+    // the old domains, newest last
+    Change* trail;
+    int trailSize;
+    // isles whose slots changed and have to be checked again
+    int* queue;
+    int queueSize;
+    char* queued;
+    // scratch space of isConnected()
+    int* stack;
+    char* visited;
+    int64_t nodes;
+  };
+
+  IsleGraph _graph;
+  std::vector< std::unique_ptr< TaskDeque<Task> > > _deques;
+  // set as soon as the search can stop
+  std::atomic<bool> _cancel;
+  // amount of tasks that are queued or being searched
+  std::atomic<int> _pending;
+  // amount of tasks in the deques
+  std::atomic<int> _queued;
+  // idle workers sleep on _wake until a task is pushed or the search ends
+  std::mutex _idleMutex;
+  std::condition_variable _wake;
+  std::atomic<int64_t> _nodes;
+
+  // see require() and setRegion()
+  std::vector<Bridge> _required;
+  std::vector<int> _region;
+  std::vector<char> _inRegion;
+  // region search: the isles joined by the slots outside the region share
+  // a label, the other slots are listed per label. Computed by the worker
+  // of the root task before it pushes the first task, read only after that.
+  std::vector<int> _label;
+  int _labels;
+  std::vector<int> _labelStart;
+  std::vector<int> _labelSlots;
+  // see setStop() and setDeadline()
+  const std::atomic<bool>* _stop;
+  std::chrono::steady_clock::time_point _deadline;
+  std::atomic<bool> _stopped;
+
+  // stop after this amount of solutions
+  int _limit;
+  std::atomic<int> _count;
+  // the bridge counts of the first solution found
+  std::mutex _solutionMutex;
+  std::vector<uint8_t> _solution;
+
+  // Run the workers on the whole search tree until _limit solutions are
+  // found or the tree is exhausted.
+  void run(const int threads);
+
+  // Main loop of a worker: search own tasks, steal tasks from the others
+  // and stop when the search is cancelled or no tasks are left.
+  void work(const int id);
+
+  // Wait until a task is queued or the search is over.
+  void sleep();
+
+  // Wake the sleeping workers (all of them, or one if all is false).
+  void wake(const bool all);
+
+  // Stop all workers.
+  void cancel();
+
+  // Add the nodes of the worker to _nodes and cancel the search if the
+  // stop flag is set or the deadline has passed.
+  void report(Worker* worker);
+
+  // Returns: bool - true if the search has to be interrupted
+  bool interrupted() const;
+
+  // Search the subtree below the current state of the worker depth first.
+  // The alternatives of a branch point are pushed to the deque of the
+  // worker while it holds fewer than kReadyTasks tasks.
+  Result explore(Worker* worker);
+
+  // Narrow the domain of a slot to [lo, hi]. Using a slot removes all
+  // crossing slots. The old domains are pushed to the trail.
+  // Returns:
+  //   bool - false if the domain becomes empty
+  bool assign(Worker* worker, const int slot, const int lo,
+   const int hi) const;
+  FRIEND_TEST(Solver, assign);
+
+  // Restore the domains of the trail down to the given size.
+  void undo(Worker* worker, const int trailSize) const;
+
+  // Narrow the domains around the queued isles until nothing changes.
+  // Returns:
+  //   bool - false if an isle can't get the right amount of bridges
+  bool propagate(Worker* worker) const;
+
+  // Empty the queue after a contradiction.
+  void clear(Worker* worker) const;
+
+  // Checks if all isles can still be connected by the possible bridges.
+  bool isConnected(Worker* worker) const;
+
+  // Label the isles by the possible bridges outside the region after the
+  // propagation at the root. Every task below the root shares these labels,
+  // so a region search only follows its own slots between them.
+  void labelRegion(Worker* worker);
+
+  // Returns the next undecided slot (at the isle of the region with the
+  // fewest undecided slots) or -1 if every slot of the region is decided.
+  int chooseSlot(const Worker& worker) const;
+};
+
+#endif  // SOLVER_H_
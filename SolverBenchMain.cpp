@@ -0,0 +1,110 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <new>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+#include "./FileInterpreter.h"
+#include "./Solver.h"
+
+// Counts the heap allocations of the whole program so the bench can show
+// how many of them a solve makes.
+static std::atomic<int64_t> allocations(0);
+
+// ____________________________________________________________________________
+void* operator new(size_t size) {
+  allocations++;
+  void* pointer = malloc(size ? size : 1);
+  if (!pointer) {throw std::bad_alloc(); }
+  return pointer;
+}
+
+// ____________________________________________________________________________
+void operator delete(void* pointer) noexcept {
+  free(pointer);
+}
+
+// Print the usage and exit.
+void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./SolverBenchMain [--threads <max>] [--budget <ms>]"
+   " <puzzlefiles>\n");
+  fprintf(stderr, "Solves every puzzle with 1, 2, 4, ... up to max (default "
+   "4) worker threads,\neach run within the budget (default 10000 ms), e.g. "
+   "the puzzles in benchmarks/.\n");
+  exit(1);
+}
+
+// Solves every puzzle with 1, 2, 4, ... worker threads and prints the time,
+// the search nodes and the heap allocations of each run. Runs that hit the
+// budget are compared by their nodes per millisecond.
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"threads", 1, NULL, 't'},
+    {"budget", 1, NULL, 'b'},
+    {NULL, 0, NULL, 0}
+  };
+  int maxThreads = 4;
+  int budget = 10000;
+  while (true) {
+    int c = getopt_long(argc, argv, "t:b:", options, NULL);
+    if (c == -1) {break; }
+    switch (c) {
+      case 't':
+        maxThreads = std::max(1, atoi(optarg));
+        break;
+      case 'b':
+        budget = std::max(1, atoi(optarg));
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+  if (optind >= argc) {printUsageAndExit(); }
+  printf("%u cores\n", std::thread::hardware_concurrency());
+
+  for (int i = optind; i < argc; i++) {
+    std::vector< std::vector<int> > numbers;
+    if (!FileInterpreter::readPuzzle(argv[i], &numbers)) {
+      fprintf(stderr, "Skipping invalid puzzle: %s\n", argv[i]);
+      continue;
+    }
+    printf("%s\n", argv[i]);
+    double singleMs = 0;
+    double singleRate = 0;
+    bool singleStopped = false;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+      Solver solver(numbers);
+      std::vector<Bridge> solution;
+      int64_t allocationsBefore = allocations;
+      std::chrono::steady_clock::time_point start =
+       std::chrono::steady_clock::now();
+      solver.setDeadline(start + std::chrono::milliseconds(budget));
+      bool solved = solver.solve(threads, &solution);
+      double ms = std::chrono::duration<double, std::milli>(
+       std::chrono::steady_clock::now() - start).count();
+      int64_t allocated = allocations - allocationsBefore;
+      double rate = solver.nodes() / ms;
+      if (threads == 1) {
+        singleMs = ms;
+        singleRate = rate;
+        singleStopped = solver.stopped();
+      }
+      // finished searches are compared by their time
+      double speedup = singleStopped || solver.stopped()
+          ? rate / singleRate : singleMs / ms;
+      printf("  threads %3d: %10.1f ms %12lld nodes %10.1f nodes/ms "
+       "%8lld allocations  speedup %5.2f  %s\n", threads, ms,
+       static_cast<long long>(solver.nodes()),  // NOLINT
+       rate, static_cast<long long>(allocated),  // NOLINT
+       speedup, solver.stopped() ? "timeout"
+       : (solved ? "solved" : "no solution"));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,167 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <vector>
+#include "./Generator.h"
+#include "./Hashi.h"
+#include "./Solver.h"
+
+// _____________________________________________________________________________
+TEST(Solver, solve) {
+  std::vector< std::vector<int> > numbers = {{4, 0, 0, 3, 0, 0},
+                                              {0, 0, 0, 0, 0, 0},
+                                              {2, 0, 0, 1, 0, 0}};
+  Solver solver(numbers);
+  std::vector<Bridge> solution;
+  ASSERT_TRUE(solver.solve(1, &solution));
+  // the double bridges have the count 2
+  ASSERT_EQ(3, solution.size());
+  // draw the solution like Hashi::solve() does
+  Hashi game;
+  game._numbers = numbers;
+  game._max_y = numbers.size();
+  game._max_x = numbers[0].size();
+  for (unsigned int i = 0; i < solution.size(); i++) {
+    for (int j = 0; j < solution[i].count; j++) {
+      game.drawBridge(solution[i].x1, solution[i].y1, solution[i].x2,
+       solution[i].y2);
+    }
+  }
+  ASSERT_TRUE(game.isSolved());
+
+  // two isles that can't be connected
+  Solver unsolvable({{1, 0, 0},
+                     {0, 0, 0},
+                     {0, 0, 1}});
+  ASSERT_FALSE(unsolvable.solve(1, &solution));
+  // the 1-isles must not be connected to each other
+  Solver disconnected({{1, 0, 1, 0, 0},
+                       {0, 0, 0, 0, 0},
+                       {0, 0, 0, 0, 0},
+                       {0, 0, 2, 0, 2}});
+  ASSERT_FALSE(disconnected.solve(1, &solution));
+}
+
+// _____________________________________________________________________________
+TEST(Solver, solveParallel) {
+  std::vector< std::vector<int> > numbers;
+  Generator generator(20, 20, 7);
+  generator.generate(60, &numbers);
+  std::vector<Bridge> solution;
+  Solver solver(numbers);
+  ASSERT_TRUE(solver.solve(4, &solution));
+  ASSERT_LT(0, solver.nodes());
+  // draw the solution like Hashi::solve() does
+  Hashi game;
+  game._numbers = numbers;
+  game._max_y = numbers.size();
+  game._max_x = numbers[0].size();
+  for (unsigned int i = 0; i < solution.size(); i++) {
+    for (int j = 0; j < solution[i].count; j++) {
+      game.drawBridge(solution[i].x1, solution[i].y1, solution[i].x2,
+       solution[i].y2);
+    }
+  }
+  ASSERT_TRUE(game.isSolved());
+}
+
+// _____________________________________________________________________________
+TEST(Solver, countSolutions) {
+  // unique
+  Solver unique({{4, 0, 0, 3, 0, 0},
+                 {0, 0, 0, 0, 0, 0},
+                 {2, 0, 0, 1, 0, 0}});
+  ASSERT_EQ(1, unique.countSolutions(1, 10));
+  // a ring of four 2-isles: single bridges all around or two double bridges
+  // on opposite sides (which would not be connected)
+  Solver ring({{2, 0, 2},
+               {0, 0, 0},
+               {2, 0, 2}});
+  ASSERT_EQ(1, ring.countSolutions(1, 10));
+  Solver ring3({{3, 0, 3},
+                {0, 0, 0},
+                {3, 0, 3}});
+  ASSERT_EQ(2, ring3.countSolutions(2, 10));
+  ASSERT_EQ(1, ring3.countSolutions(1, 1));
+}
+
+// _____________________________________________________________________________
+TEST(Solver, require) {
+  // the two solutions of the ring differ in the position of the double
+  // bridges
+  Solver ring3({{3, 0, 3},
+                {0, 0, 0},
+                {3, 0, 3}});
+  ring3.require({Bridge(0, 0, 2, 0, 1)});
+  ASSERT_EQ(2, ring3.countSolutions(1, 10));
+  ring3.require({Bridge(0, 0, 2, 0, 2)});
+  ASSERT_EQ(1, ring3.countSolutions(1, 10));
+  std::vector<Bridge> solution;
+  ASSERT_TRUE(ring3.solve(1, &solution));
+  ASSERT_NE(solution.end(), std::find(solution.begin(), solution.end(),
+      Bridge(0, 0, 2, 0, 2)));
+  // a bridge that does not exist can't be part of a solution
+  ring3.require({Bridge(0, 0, 2, 2, 1)});
+  ASSERT_FALSE(ring3.solve(1, &solution));
+  ASSERT_FALSE(ring3.stopped());
+}
+
+// _____________________________________________________________________________
+TEST(Solver, setRegion) {
+  // two rings of 3s (two solutions each), linked by forced double bridges
+  // over the isles (4,2) and (4,4)
+  std::vector< std::vector<int> > numbers = {{3, 0, 3, 0, 0, 0, 0, 0, 0},
+                                             {0, 0, 0, 0, 0, 0, 0, 0, 0},
+                                             {3, 0, 5, 0, 4, 0, 0, 0, 0},
+                                             {0, 0, 0, 0, 0, 0, 0, 0, 0},
+                                             {0, 0, 0, 0, 4, 0, 5, 0, 3},
+                                             {0, 0, 0, 0, 0, 0, 0, 0, 0},
+                                             {0, 0, 0, 0, 0, 0, 3, 0, 3}};
+  Solver solver(numbers);
+  ASSERT_EQ(4, solver.countSolutions(1, 10));
+  // only the slots of the left ring are decided
+  IsleGraph graph(numbers);
+  solver.setRegion({graph.isleAt(0, 0), graph.isleAt(2, 0),
+                    graph.isleAt(0, 2), graph.isleAt(2, 2)});
+  ASSERT_EQ(2, solver.countSolutions(1, 10));
+  // the right ring and the isles between share one label, computed once at
+  // the root for all workers
+  ASSERT_EQ(5, solver._labels);
+  ASSERT_EQ(2, solver.countSolutions(4, 10));
+  ASSERT_EQ(5, solver._labels);
+  std::vector<Bridge> solution;
+  ASSERT_TRUE(solver.solve(1, &solution));
+  // the slots of the right ring keep their smallest count
+  ASSERT_NE(solution.end(), std::find(solution.begin(), solution.end(),
+      Bridge(6, 4, 8, 4, 1)));
+  ASSERT_NE(solution.end(), std::find(solution.begin(), solution.end(),
+      Bridge(2, 2, 4, 2, 2)));
+  solver.setRegion({});
+  ASSERT_EQ(4, solver.countSolutions(1, 10));
+}
+
+// _____________________________________________________________________________
+TEST(Solver, stop) {
+  std::vector< std::vector<int> > numbers;
+  Generator generator(20, 20, 7);
+  generator.generate(60, &numbers);
+  std::vector<Bridge> solution;
+  Solver solver(numbers);
+  std::atomic<bool> stop(true);
+  solver.setStop(&stop);
+  ASSERT_FALSE(solver.solve(1, &solution));
+  ASSERT_TRUE(solver.stopped());
+  stop = false;
+  solver.setDeadline(std::chrono::steady_clock::now());
+  ASSERT_FALSE(solver.solve(1, &solution));
+  ASSERT_TRUE(solver.stopped());
+  // without limits the search finishes
+  solver.setDeadline(std::chrono::steady_clock::now()
+      + std::chrono::hours(1));
+  ASSERT_TRUE(solver.solve(1, &solution));
+  ASSERT_FALSE(solver.stopped());
+}
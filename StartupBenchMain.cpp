@@ -0,0 +1,119 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "./FileInterpreter.h"
+#include "./Hashi.h"
+#include "./PhaseTimer.h"
+
+// Print the usage and exit.
+void printUsageAndExit() {
+  fprintf(stderr, "Usage: ./StartupBenchMain [--budget <ms>] [--rounds <n>] "
+   "<puzzlefiles>\n");
+  fprintf(stderr, "Starts the game of every puzzle rounds times (default 20) "
+   "like HashiMain does\nand measures the time to the first frame (the "
+   "terminal output is discarded).\nFails if the median exceeds the budget "
+   "(default 5 ms), e.g. for\ninstances/*s25x25.xy.\n");
+  exit(1);
+}
+
+// Returns: double - the median of the values
+double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+// Measures the startup of the game up to the first frame.
+int main(int argc, char** argv) {
+  struct option options[] = {
+    {"budget", 1, NULL, 'b'},
+    {"rounds", 1, NULL, 'r'},
+    {NULL, 0, NULL, 0}
+  };
+  double budget = 5;
+  int rounds = 20;
+  while (true) {
+    int c = getopt_long(argc, argv, "b:r:", options, NULL);
+    if (c == -1) {break; }
+    switch (c) {
+      case 'b':
+        budget = atof(optarg);
+        break;
+      case 'r':
+        rounds = std::max(1, atoi(optarg));
+        break;
+      default:
+        printUsageAndExit();
+    }
+  }
+  if (optind >= argc) {printUsageAndExit(); }
+  std::vector<std::string> files(argv + optind, argv + argc);
+
+  // a terminal large enough for a 25x25 board, the frames go to /dev/null
+  setenv("TERM", "xterm", 0);
+  setenv("LINES", "100", 1);
+  setenv("COLUMNS", "140", 1);
+  fflush(stdout);
+  int saved = dup(1);
+  int null = open("/dev/null", O_WRONLY);
+  dup2(null, 1);
+
+  std::vector<std::string> lines;
+  bool valid = true;
+  for (unsigned int f = 0; f < files.size(); f++) {
+    std::vector<double> load, terminal, frame, total;
+    std::string error;
+    for (int round = 0; round < rounds && error.empty(); round++) {
+      PhaseTimer timer;
+      char* arguments[2] = {argv[0], const_cast<char*>(files[f].c_str())};
+      FileInterpreter fi;
+      fi.parseCommandLineArguments(2, arguments);
+      Hashi game;
+      if (!game.startGame(fi, &timer, &error)) {break; }
+      std::vector<PhaseTimer::Phase> phases = timer.phases();
+      for (unsigned int i = 0; i < phases.size(); i++) {
+        double duration = phases[i].end - phases[i].start;
+        if (phases[i].name == "load") {load.push_back(duration); }
+        if (phases[i].name == "terminal") {terminal.push_back(duration); }
+        if (phases[i].name == "first frame") {frame.push_back(duration); }
+      }
+      total.push_back(timer.endOf("first frame"));
+    }
+    char line[512];
+    if (!error.empty()) {
+      snprintf(line, sizeof(line), "%-40s %s", files[f].c_str(),
+       error.c_str());
+      valid = false;
+    } else {
+      double ttff = median(total);
+      snprintf(line, sizeof(line), "%-40s %8.3f %8.3f %8.3f %8.3f%s",
+       files[f].c_str(), median(load), median(terminal), median(frame), ttff,
+       ttff <= budget ? "" : "  over budget");
+      valid &= ttff <= budget;
+    }
+    lines.push_back(line);
+  }
+
+  fflush(stdout);
+  dup2(saved, 1);
+  close(saved);
+  close(null);
+  printf("median of %d rounds in ms (load and terminal overlap)\n", rounds);
+  printf("%-40s %8s %8s %8s %8s\n", "puzzle", "load", "terminal", "frame",
+   "total");
+  for (unsigned int i = 0; i < lines.size(); i++) {
+    printf("%s\n", lines[i].c_str());
+  }
+  if (!valid) {
+    fprintf(stderr, "The time to the first frame exceeds %.1f ms\n", budget);
+    return 1;
+  }
+  return 0;
+}
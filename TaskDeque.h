@@ -0,0 +1,68 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef TASKDEQUE_H_
+#define TASKDEQUE_H_
+
+#include <atomic>
+#include <deque>
+#include <mutex>  // NOLINT(build/c++11)
+#include <utility>
+
+// A deque of tasks owned by one worker thread. The owner pushes and pops
+// at the back (depth first order), other workers steal from the front,
+// where the tasks closest to the root of the search tree are waiting.
+// This is a std::deque behind a mutex, not a lock-free (Chase-Lev) deque:
+// the owner and the thieves take the same lock. A task is a whole subtree
+// of the search, so the lock is taken once per task and not per node.
+template <class T>
+class TaskDeque {
+ public:
+  TaskDeque() : _size(0) {}
+
+  // Add a task at the back (owner only).
+  void push(T&& task) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tasks.push_back(std::move(task));
+    _size = _tasks.size();
+  }
+
+  // Take the newest task (owner only).
+  // Returns: bool - false if the deque is empty
+  bool pop(T* task) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_tasks.empty()) {return false; }
+    *task = std::move(_tasks.back());
+    _tasks.pop_back();
+    _size = _tasks.size();
+    return true;
+  }
+
+  // Take the oldest task (other workers).
+  // Returns: bool - false if the deque is empty
+  bool steal(T* task) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_tasks.empty()) {return false; }
+    *task = std::move(_tasks.front());
+    _tasks.pop_front();
+    _size = _tasks.size();
+    return true;
+  }
+
+  // Remove all tasks.
+  void clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tasks.clear();
+    _size = 0;
+  }
+
+  // Returns: int - the amount of tasks (read without the lock)
+  int size() const { return _size; }
+
+ private:
+  std::mutex _mutex;
+  std::deque<T> _tasks;
+  std::atomic<int> _size;
+};
+
+#endif  // TASKDEQUE_H_
@@ -0,0 +1,96 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "./ThreadPool.h"
+
+// ____________________________________________________________________________
+ThreadPool::ThreadPool(const int threads) {
+  _stop = false;
+  for (int i = 1; i < threads; i++) {
+    _workers.push_back(std::thread(&ThreadPool::work, this));
+  }
+}
+
+// ____________________________________________________________________________
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _changed.notify_all();
+  for (unsigned int i = 0; i < _workers.size(); i++) {
+    _workers[i].join();
+  }
+}
+
+// ____________________________________________________________________________
+void ThreadPool::run(const int count, const std::function<void(int)>& job) {
+  if (count <= 0) {
+    return;
+  }
+  Batch batch;
+  batch.job = &job;
+  batch.count = count;
+  batch.next = 0;
+  batch.done = 0;
+  if (!_workers.empty() && count > 1) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _batches.push_back(&batch);
+  }
+  _changed.notify_all();
+
+  bool last = runJobs(&batch, batch.next++);
+  std::unique_lock<std::mutex> lock(_mutex);
+  // the batch must not be taken after it is gone
+  std::deque<Batch*>::iterator it = std::find(_batches.begin(),
+   _batches.end(), &batch);
+  if (it != _batches.end()) {
+    _batches.erase(it);
+  }
+  if (!last) {
+    _changed.wait(lock, [&batch] { return batch.done == batch.count; });
+  }
+}
+
+// ____________________________________________________________________________
+bool ThreadPool::runJobs(Batch* batch, int first) {
+  // The batch lives until all jobs are done: claim the next job before
+  // reporting the current one and don't touch the batch afterwards.
+  const std::function<void(int)>& job = *batch->job;
+  const int count = batch->count;
+  for (int i = first; i < count;) {
+    job(i);
+    int next = batch->next++;
+    if (++batch->done == count) {
+      return true;
+    }
+    i = next;
+  }
+  return false;
+}
+
+// ____________________________________________________________________________
+void ThreadPool::work() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _changed.wait(lock, [this] { return _stop || !_batches.empty(); });
+    if (_stop) {break; }
+    Batch* batch = _batches.front();
+    int first = batch->next++;
+    // all jobs taken: the batch is not needed in the queue any more
+    if (first >= batch->count) {
+      _batches.pop_front();
+      continue;
+    }
+    lock.unlock();
+    bool last = runJobs(batch, first);
+    lock.lock();
+    if (last) {
+      _changed.notify_all();
+    }
+  }
+}
@@ -0,0 +1,64 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+// A fixed set of worker threads that runs batches of independent jobs.
+// Several threads may submit batches at the same time; the submitting
+// thread works on its own batch as well.
+class ThreadPool {
+ public:
+  // Start the workers.
+  // Arguments:
+  //   const int threads - the amount of threads working on a batch
+  //                       (including the submitting thread)
+  explicit ThreadPool(const int threads);
+  FRIEND_TEST(ThreadPool, constructor);
+  // Stop and join the workers.
+  ~ThreadPool();
+
+  // Run job(0), ..., job(count - 1) and wait until all are finished.
+  void run(const int count, const std::function<void(int)>& job);
+  FRIEND_TEST(ThreadPool, run);
+
+  // The amount of threads working on a batch.
+  int size() const { return _workers.size() + 1; }
+
+ private:
+  // the jobs of one run() call
+  struct Batch {
+    const std::function<void(int)>* job;
+    int count;
+    // next job index to be taken
+    std::atomic<int> next;
+    // amount of finished jobs
+    std::atomic<int> done;
+  };
+
+  std::vector<std::thread> _workers;
+  std::mutex _mutex;
+  // signals new batches and finished batches
+  std::condition_variable _changed;
+  std::deque<Batch*> _batches;
+  bool _stop;
+
+  // Take jobs of the oldest batch until the pool is stopped.
+  void work();
+
+  // Run the claimed job and further jobs of the batch until all are taken.
+  // Returns: bool - true if this call finished the last job
+  bool runJobs(Batch* batch, int first);
+};
+
+#endif  // THREADPOOL_H_
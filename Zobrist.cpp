@@ -0,0 +1,22 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#include "./Zobrist.h"
+
+// ____________________________________________________________________________
+uint64_t zobristKey(const int x, const int y, const bool vertical,
+ const int lo, const int hi) {
+  if (lo == 0 && hi == 2) {
+    return 0;
+  }
+  // The keys are not stored in a table: mixing the slot with the splitmix64
+  // finalizer gives well distributed keys for boards of any size.
+  uint64_t z = static_cast<uint64_t>(x) << 32;
+  z ^= static_cast<uint64_t>(y) << 8;
+  z ^= static_cast<uint64_t>(vertical) << 4;
+  z ^= static_cast<uint64_t>(lo * 3 + hi);
+  z += 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
@@ -0,0 +1,24 @@
+// Copyright 2018 Tim Samuel Winter
+// Author: Tim Samuel Winter <tim.s.winter@googlemail.com>
+
+#ifndef ZOBRIST_H_
+#define ZOBRIST_H_
+
+#include <stdint.h>
+
+// Zobrist key of a bridge slot. A board state is hashed by XOR-ing the keys
+// of all its slots, so a single bridge change updates the hash with two
+// XOR operations (remove the old key, add the new one).
+// Arguments:
+//   const int x - the x coordinate of the left (or upper) isle
+//   const int y - the y coordinate of the left (or upper) isle
+//   const bool vertical - the direction of the slot
+//   const int lo - the least possible amount of bridges in the slot
+//   const int hi - the largest possible amount of bridges in the slot
+// Returns:
+//   uint64_t - the key. An open slot (lo = 0, hi = 2) has the key 0, so
+//   the hash of a board only depends on its drawn bridges (lo = hi).
+uint64_t zobristKey(const int x, const int y, const bool vertical,
+ const int lo, const int hi);
+
+#endif  // ZOBRIST_H_